@@ -27,8 +27,162 @@
 
 #include <cctype>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define CPLUSPLUS_LEXER_SSE2
+#  include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#  define CPLUSPLUS_LEXER_AVX2
+#  include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(CPLUSPLUS_LEXER_SSE2)
+#  include <intrin.h>
+#endif
+
 using namespace CPlusPlus;
 
+namespace {
+
+// Vectorized skipping of runs of plain ASCII characters. All functions return the first
+// character at or after p that is not part of the run, or the position from which fewer
+// than one full vector remains before end; the caller continues with the scalar code.
+// A run never contains '\n', '\0' or bytes of multi-byte code points, so skipping it is
+// equivalent to calling Lexer::yyinp() once per character.
+
+#ifdef CPLUSPLUS_LEXER_SSE2
+
+inline unsigned countTrailingZeros(unsigned bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return index;
+#else
+    return unsigned(__builtin_ctz(bits));
+#endif
+}
+
+struct Sse2
+{
+    using Vector = __m128i;
+    enum { Width = 16 };
+    static constexpr unsigned AllBits = 0xffffu;
+
+    static Vector load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static Vector splat(char c) { return _mm_set1_epi8(c); }
+    static Vector equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+    static Vector greater(Vector a, Vector b) { return _mm_cmpgt_epi8(a, b); }
+    static Vector bitOr(Vector a, Vector b) { return _mm_or_si128(a, b); }
+    static Vector bitAnd(Vector a, Vector b) { return _mm_and_si128(a, b); }
+    static Vector bitAndNot(Vector a, Vector b) { return _mm_andnot_si128(a, b); }
+    static unsigned mask(Vector a) { return unsigned(_mm_movemask_epi8(a)); }
+};
+
+#ifdef CPLUSPLUS_LEXER_AVX2
+struct Avx2
+{
+    using Vector = __m256i;
+    enum { Width = 32 };
+    static constexpr unsigned AllBits = 0xffffffffu;
+
+    static Vector load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static Vector splat(char c) { return _mm256_set1_epi8(c); }
+    static Vector equal(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+    static Vector greater(Vector a, Vector b) { return _mm256_cmpgt_epi8(a, b); }
+    static Vector bitOr(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+    static Vector bitAnd(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+    static Vector bitAndNot(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+    static unsigned mask(Vector a) { return unsigned(_mm256_movemask_epi8(a)); }
+};
+#endif
+
+// Bytes are compared as signed values, so all bytes of multi-byte code points are negative
+// and never inside the ranges below.
+template <typename V>
+inline typename V::Vector inRange(typename V::Vector c, char first, char last)
+{
+    return V::bitAnd(V::greater(c, V::splat(first - 1)), V::greater(V::splat(last + 1), c));
+}
+
+template <typename V>
+struct IdentifierCharacters
+{
+    typename V::Vector operator()(typename V::Vector c) const
+    {
+        const typename V::Vector lower = V::bitOr(c, V::splat(0x20));
+        return V::bitOr(V::bitOr(inRange<V>(lower, 'a', 'z'), inRange<V>(c, '0', '9')),
+                        V::bitOr(V::equal(c, V::splat('_')), V::equal(c, V::splat('$'))));
+    }
+};
+
+template <typename V>
+struct BlankCharacters // what std::isspace() accepts, except for '\n'
+{
+    typename V::Vector operator()(typename V::Vector c) const
+    {
+        return V::bitOr(V::equal(c, V::splat(' ')),
+                        V::bitAndNot(V::equal(c, V::splat('\n')), inRange<V>(c, '\t', '\r')));
+    }
+};
+
+template <typename V>
+struct CommentCharacters // ASCII except for '\0', '\n' and the terminator
+{
+    char terminator;
+
+    typename V::Vector operator()(typename V::Vector c) const
+    {
+        const typename V::Vector special = V::bitOr(V::equal(c, V::splat('\n')),
+                                                    V::equal(c, V::splat(terminator)));
+        return V::bitAndNot(special, V::greater(c, V::splat(0)));
+    }
+};
+
+template <typename V, typename Matcher>
+inline const char *skipRun(const char *p, const char *end, const Matcher &matches)
+{
+    while (end - p >= V::Width) {
+        const unsigned bits = V::mask(matches(V::load(p)));
+        if (bits != V::AllBits)
+            return p + countTrailingZeros(~bits);
+        p += V::Width;
+    }
+    return p;
+}
+
+template <template <typename> class Matcher, typename... Args>
+inline const char *skip(const char *p, const char *end, Args... args)
+{
+#ifdef CPLUSPLUS_LEXER_AVX2
+    p = skipRun<Avx2>(p, end, Matcher<Avx2>{args...});
+#endif
+    return skipRun<Sse2>(p, end, Matcher<Sse2>{args...});
+}
+
+inline const char *skipIdentifierCharacters(const char *p, const char *end)
+{ return skip<IdentifierCharacters>(p, end); }
+
+inline const char *skipBlankCharacters(const char *p, const char *end)
+{ return skip<BlankCharacters>(p, end); }
+
+inline const char *skipCommentCharacters(const char *p, const char *end, char terminator)
+{ return skip<CommentCharacters>(p, end, terminator); }
+
+#else // CPLUSPLUS_LEXER_SSE2
+
+inline const char *skipIdentifierCharacters(const char *p, const char *)
+{ return p; }
+
+inline const char *skipBlankCharacters(const char *p, const char *)
+{ return p; }
+
+inline const char *skipCommentCharacters(const char *p, const char *, char)
+{ return p; }
+
+#endif // CPLUSPLUS_LEXER_SSE2
+
+} // anonymous namespace
+
 /*!
     \class Lexer
     \brief The Lexer generates tokens from an UTF-8 encoded source text.
@@ -124,6 +278,17 @@ void Lexer::pushLineStartOffset()
         _translationUnit->pushLineOffset(_currentCharUtf16);
 }
 
+void Lexer::yyinpAsciiRun(const char *runEnd)
+{
+    if (runEnd == _currentChar || f._scalarScanning)
+        return;
+    _currentCharUtf16 += unsigned(runEnd - _currentChar);
+    _currentChar = runEnd;
+    _yychar = *_currentChar;
+    if (CPLUSPLUS_UNLIKELY(_yychar == '\n'))
+        pushLineStartOffset();
+}
+
 void Lexer::scan(Token *tok)
 {
     tok->reset();
@@ -160,6 +325,9 @@ void Lexer::scan_helper(Token *tok)
                 _state = 0;
         } else {
             tok->f.whitespace = true;
+            yyinp();
+            yyinpAsciiRun(skipBlankCharacters(_currentChar, _lastChar));
+            continue;
         }
         yyinp();
     }
@@ -186,9 +354,10 @@ void Lexer::scan_helper(Token *tok)
         const int originalKind = s._tokenKind;
 
         while (_yychar) {
-            if (_yychar != '*')
+            if (_yychar != '*') {
                 yyinp();
-            else {
+                yyinpAsciiRun(skipCommentCharacters(_currentChar, _lastChar, '*'));
+            } else {
                 yyinp();
                 if (_yychar == '/') {
                     yyinp();
@@ -480,6 +649,7 @@ void Lexer::scan_helper(Token *tok)
             while (_yychar) {
                 if (_yychar != '*') {
                     yyinp();
+                    yyinpAsciiRun(skipCommentCharacters(_currentChar, _lastChar, '*'));
                 } else {
                     yyinp();
                     if (_yychar == '/')
@@ -1051,6 +1221,7 @@ void Lexer::scanPreprocessorNumber(Token *tok, bool dotAlreadySkipped)
 void Lexer::scanIdentifier(Token *tok, unsigned extraProcessedChars)
 {
     const char *yytext = _currentChar - 1 - extraProcessedChars;
+    yyinpAsciiRun(skipIdentifierCharacters(_currentChar, _lastChar));
     while (std::isalnum(_yychar) || _yychar == '_' || _yychar == '$'
             || isByteOfMultiByteCodePoint(_yychar)) {
         yyinp();
@@ -1102,9 +1273,11 @@ void Lexer::scanBackslash(Kind type)
 void Lexer::scanCppComment(Kind type)
 {
     while (_yychar && _yychar != '\n') {
-        if (_yychar == '\\')
+        if (_yychar == '\\') {
             scanBackslash(type);
-        else if (_yychar)
+        } else if (_yychar) {
             yyinp();
+            yyinpAsciiRun(skipCommentCharacters(_currentChar, _lastChar, '\\'));
+        }
     }
 }
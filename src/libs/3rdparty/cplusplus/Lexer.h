@@ -62,6 +62,10 @@ public:
     void setPreprocessorMode(bool onoff)
     { f._ppMode = onoff; }
 
+    // Scans character by character only, for comparing against the vectorized scanning.
+    void setScalarScanning(bool onoff)
+    { f._scalarScanning = onoff; }
+
 public:
     static void yyinp_utf8(const char *&currentSourceChar, unsigned char &yychar,
                            unsigned &utf16charCounter)
@@ -118,6 +122,8 @@ private:
             pushLineStartOffset();
     }
 
+    void yyinpAsciiRun(const char *runEnd);
+
 private:
     struct Flags {
         unsigned _scanCommentTokens: 1;
@@ -125,6 +131,7 @@ private:
         unsigned _scanAngleStringLiteralTokens: 1;
         unsigned _ppMode: 1;
         unsigned _ignoreTrigraph : 1;
+        unsigned _scalarScanning : 1;
     };
 
     struct State {
@@ -22,26 +22,129 @@
 #include "NameVisitor.h"
 #include "Matcher.h"
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 using namespace CPlusPlus;
 
+namespace {
+
+// The characters of all literals are interned here, so that the identifiers and literals that
+// appear in many translation units are stored once, no matter how many Controls refer to them.
+// The table is sharded by hash code to keep lock contention low when parsing in parallel.
+class SharedLiteralStrings
+{
+public:
+    static SharedLiteralStrings &instance()
+    {
+        // Intentionally leaked, literals might still be destroyed during static destruction.
+        static auto strings = new SharedLiteralStrings;
+        return *strings;
+    }
+
+    const char *acquire(const char *chars, unsigned size, unsigned hashCode)
+    {
+        if (!isEnabled)
+            return createEntry(chars, size)->chars();
+
+        Shard &shard = _shards[hashCode % ShardCount];
+        std::lock_guard<std::mutex> locker(shard.mutex);
+
+        const auto it = shard.entries.find(std::string_view(chars, size));
+        if (it != shard.entries.end()) {
+            ++it->second->refCount;
+            return it->second->chars();
+        }
+
+        Entry *entry = createEntry(chars, size);
+        shard.entries.emplace(std::string_view(entry->chars(), size), entry);
+        return entry->chars();
+    }
+
+    // Characters acquired while sharing was turned off are not in the table.
+    void release(const char *chars, unsigned size, unsigned hashCode)
+    {
+        Shard &shard = _shards[hashCode % ShardCount];
+        std::lock_guard<std::mutex> locker(shard.mutex);
+
+        const auto it = shard.entries.find(std::string_view(chars, size));
+        if (it == shard.entries.end() || it->second->chars() != chars) {
+            std::free(Entry::fromChars(chars));
+            return;
+        }
+
+        Entry *entry = it->second;
+        if (--entry->refCount == 0) {
+            shard.entries.erase(it);
+            std::free(entry);
+        }
+    }
+
+    std::atomic<bool> isEnabled{true};
+    std::atomic<unsigned long long> allocatedCount{0};
+    std::atomic<unsigned long long> allocatedBytes{0};
+
+private:
+    struct Entry
+    {
+        int refCount;
+
+        char *chars() { return reinterpret_cast<char *>(this + 1); }
+
+        static Entry *fromChars(const char *chars)
+        { return reinterpret_cast<Entry *>(const_cast<char *>(chars)) - 1; }
+    };
+
+    Entry *createEntry(const char *chars, unsigned size)
+    {
+        const size_t entrySize = sizeof(Entry) + size + 1;
+        ++allocatedCount;
+        allocatedBytes += entrySize;
+
+        Entry *entry = static_cast<Entry *>(std::malloc(entrySize));
+        entry->refCount = 1;
+        std::memcpy(entry->chars(), chars, size);
+        entry->chars()[size] = '\0';
+        return entry;
+    }
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, Entry *> entries;
+    };
+
+    enum { ShardCount = 64 };
+    Shard _shards[ShardCount];
+};
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 Literal::Literal(const char *chars, int size)
     : _next(nullptr), _index(0)
 {
-    _chars = new char[size + 1];
-
-    std::strncpy(_chars, chars, size);
-    _chars[size] = '\0';
     _size = size;
-
-    _hashCode = hashCode(_chars, _size);
+    _hashCode = hashCode(chars, _size);
+    _chars = SharedLiteralStrings::instance().acquire(chars, _size, _hashCode);
 }
 
 Literal::~Literal()
-{ delete[] _chars; }
+{ SharedLiteralStrings::instance().release(_chars, _size, _hashCode); }
+
+void Literal::setCharacterSharingEnabled(bool enabled)
+{ SharedLiteralStrings::instance().isEnabled = enabled; }
+
+unsigned long long Literal::allocatedCharactersCount()
+{ return SharedLiteralStrings::instance().allocatedCount; }
+
+unsigned long long Literal::allocatedCharactersBytes()
+{ return SharedLiteralStrings::instance().allocatedBytes; }
 
 bool Literal::equalTo(const Literal *other) const
 {
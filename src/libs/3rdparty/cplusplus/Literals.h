@@ -51,10 +51,18 @@ public:
 
     bool equalTo(const Literal *other) const;
 
+    // The characters are shared between all literals with the same characters unless this
+    // is turned off, e.g. to compare the allocations with and without it.
+    static void setCharacterSharingEnabled(bool enabled);
+
+    // The character buffers taken from the system allocator by all literals so far.
+    static unsigned long long allocatedCharactersCount();
+    static unsigned long long allocatedCharactersBytes();
+
     Literal *_next; // ## private
 
 private:
-    char *_chars;
+    const char *_chars; // shared between all literals with the same characters
     unsigned _size;
     unsigned _hashCode;
 
@@ -22,10 +22,66 @@
 
 #include "cppassert.h"
 
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <vector>
 
 using namespace CPlusPlus;
 
+namespace {
+
+// Blocks released by destroyed pools are kept here and handed out to new pools, so that
+// parsing one translation unit after another does not go back to the allocator for every block.
+class RecycledBlocks
+{
+public:
+    static RecycledBlocks &instance()
+    {
+        // Intentionally leaked, pools might still be destroyed during static destruction.
+        static auto blocks = new RecycledBlocks;
+        return *blocks;
+    }
+
+    char *take(size_t blockSize)
+    {
+        {
+            std::lock_guard<std::mutex> locker(_mutex);
+            if (!_blocks.empty()) {
+                char *block = _blocks.back();
+                _blocks.pop_back();
+                return block;
+            }
+        }
+        ++allocatedCount;
+        return static_cast<char *>(std::malloc(blockSize));
+    }
+
+    void give(char *block)
+    {
+        if (isEnabled) {
+            std::lock_guard<std::mutex> locker(_mutex);
+            if (_blocks.size() < size_t(MaxRecycledBlocks)) {
+                _blocks.push_back(block);
+                return;
+            }
+        }
+        std::free(block);
+    }
+
+    std::atomic<bool> isEnabled{true};
+    std::atomic<unsigned long long> allocatedCount{0};
+
+private:
+    enum { MaxRecycledBlocks = 2 * 1024 }; // 16 MB worth of blocks
+
+    std::mutex _mutex;
+    std::vector<char *> _blocks;
+};
+
+} // anonymous namespace
+
 MemoryPool::MemoryPool()
     : _blocks(nullptr),
       _allocatedBlocks(0),
@@ -39,13 +95,28 @@ MemoryPool::~MemoryPool()
     if (_blocks) {
         for (int i = 0; i < _allocatedBlocks; ++i) {
             if (char *b = _blocks[i])
-                std::free(b);
+                RecycledBlocks::instance().give(b);
         }
 
         std::free(_blocks);
     }
 }
 
+void MemoryPool::setBlockRecyclingEnabled(bool enabled)
+{
+    RecycledBlocks::instance().isEnabled = enabled;
+}
+
+unsigned long long MemoryPool::allocatedBlockCount()
+{
+    return RecycledBlocks::instance().allocatedCount;
+}
+
+unsigned long long MemoryPool::allocatedBlockBytes()
+{
+    return allocatedBlockCount() * BLOCK_SIZE;
+}
+
 void MemoryPool::reset()
 {
     _blockCount = -1;
@@ -71,7 +142,7 @@ void *MemoryPool::allocate_helper(size_t size)
     char *&block = _blocks[_blockCount];
 
     if (! block)
-        block = (char *) std::malloc(BLOCK_SIZE);
+        block = RecycledBlocks::instance().take(BLOCK_SIZE);
 
     _ptr = block;
     _end = _ptr + BLOCK_SIZE;
@@ -49,6 +49,14 @@ public:
         return allocate_helper(size);
     }
 
+    // The blocks of destroyed pools are handed to new pools unless this is turned off,
+    // e.g. to compare the allocations with and without it.
+    static void setBlockRecyclingEnabled(bool enabled);
+
+    // The blocks taken from the system allocator by all pools so far.
+    static unsigned long long allocatedBlockCount();
+    static unsigned long long allocatedBlockBytes();
+
 private:
     void *allocate_helper(size_t size);
 
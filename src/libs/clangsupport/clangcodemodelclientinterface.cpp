@@ -47,6 +47,9 @@ void ClangCodeModelClientInterface::dispatch(const MessageEnvelop &messageEnvelo
         case MessageType::AnnotationsMessage:
             annotations(messageEnvelop.message<AnnotationsMessage>());
             break;
+        case MessageType::DocumentOutOfSyncMessage:
+            documentOutOfSync(messageEnvelop.message<DocumentOutOfSyncMessage>());
+            break;
         case MessageType::ReferencesMessage:
             references(messageEnvelop.message<ReferencesMessage>());
             break;
@@ -33,10 +33,12 @@ class ClangCodeModelServerInterface;
 
 class AnnotationsMessage;
 class CompletionsMessage;
+class DocumentOutOfSyncMessage;
 class DocumentVisibilityChangedMessage;
 class DocumentsChangedMessage;
 class DocumentsClosedMessage;
 class DocumentsOpenedMessage;
+class DocumentTextChangedMessage;
 class EchoMessage;
 class FollowSymbolMessage;
 class ReferencesMessage;
@@ -58,6 +60,7 @@ public:
     virtual void echo(const EchoMessage &message) = 0;
     virtual void completions(const CompletionsMessage &message) = 0;
     virtual void annotations(const AnnotationsMessage &message) = 0;
+    virtual void documentOutOfSync(const DocumentOutOfSyncMessage &message) = 0;
     virtual void references(const ReferencesMessage &message) = 0;
     virtual void followSymbol(const FollowSymbolMessage &message) = 0;
     virtual void tooltip(const ToolTipMessage &message) = 0;
@@ -27,6 +27,7 @@
 
 #include "alivemessage.h"
 #include "completionsmessage.h"
+#include "documentoutofsyncmessage.h"
 #include "echomessage.h"
 #include "annotationsmessage.h"
 #include "referencesmessage.h"
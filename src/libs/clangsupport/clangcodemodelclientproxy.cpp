@@ -100,6 +100,11 @@ void ClangCodeModelClientProxy::annotations(const AnnotationsMessage &message)
     m_writeMessageBlock.write(message);
 }
 
+void ClangCodeModelClientProxy::documentOutOfSync(const DocumentOutOfSyncMessage &message)
+{
+    m_writeMessageBlock.write(message);
+}
+
 void ClangCodeModelClientProxy::references(const ReferencesMessage &message)
 {
     m_writeMessageBlock.write(message);
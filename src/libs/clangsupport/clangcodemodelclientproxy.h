@@ -58,6 +58,7 @@ public:
     void echo(const EchoMessage &message) override;
     void completions(const CompletionsMessage &message) override;
     void annotations(const AnnotationsMessage &message) override;
+    void documentOutOfSync(const DocumentOutOfSyncMessage &message) override;
     void references(const ReferencesMessage &message) override;
     void followSymbol(const FollowSymbolMessage &message) override;
     void tooltip(const ToolTipMessage &message) override;
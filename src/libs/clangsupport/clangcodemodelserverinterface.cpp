@@ -44,6 +44,9 @@ void ClangCodeModelServerInterface::dispatch(const MessageEnvelop &messageEnvelo
         case MessageType::DocumentsChangedMessage:
             documentsChanged(messageEnvelop.message<DocumentsChangedMessage>());
             break;
+        case MessageType::DocumentTextChangedMessage:
+            documentTextChanged(messageEnvelop.message<DocumentTextChangedMessage>());
+            break;
         case MessageType::DocumentsClosedMessage:
             documentsClosed(messageEnvelop.message<DocumentsClosedMessage>());
             break;
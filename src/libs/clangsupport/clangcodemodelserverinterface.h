@@ -44,6 +44,7 @@ public:
 
     virtual void documentsOpened(const DocumentsOpenedMessage &message) = 0;
     virtual void documentsChanged(const DocumentsChangedMessage &message) = 0;
+    virtual void documentTextChanged(const DocumentTextChangedMessage &message) = 0;
     virtual void documentsClosed(const DocumentsClosedMessage &message) = 0;
     virtual void documentVisibilityChanged(const DocumentVisibilityChangedMessage &message) = 0;
 
@@ -31,6 +31,7 @@
 #include "documentsopenedmessage.h"
 #include "documentsclosedmessage.h"
 #include "documentschangedmessage.h"
+#include "documenttextchangedmessage.h"
 #include "documentvisibilitychangedmessage.h"
 
 #include "unsavedfilesupdatedmessage.h"
@@ -57,6 +57,11 @@ void ClangCodeModelServerProxy::documentsChanged(const DocumentsChangedMessage &
     m_writeMessageBlock.write(message);
 }
 
+void ClangCodeModelServerProxy::documentTextChanged(const DocumentTextChangedMessage &message)
+{
+    m_writeMessageBlock.write(message);
+}
+
 void ClangCodeModelServerProxy::documentsClosed(const DocumentsClosedMessage &message)
 {
     m_writeMessageBlock.write(message);
@@ -53,6 +53,7 @@ public:
 
     void documentsOpened(const DocumentsOpenedMessage &message) override;
     void documentsChanged(const DocumentsChangedMessage &message) override;
+    void documentTextChanged(const DocumentTextChangedMessage &message) override;
     void documentsClosed(const DocumentsClosedMessage &message) override;
     void documentVisibilityChanged(const DocumentVisibilityChangedMessage &message) override;
 
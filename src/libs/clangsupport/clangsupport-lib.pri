@@ -59,6 +59,7 @@ SOURCES += \
     $$PWD/requestsourcerangesanddiagnosticsforquerymessage.cpp \
     $$PWD/requestsourcerangesforquerymessage.cpp \
     $$PWD/requesttooltipmessage.cpp \
+    $$PWD/sharedmemorytransport.cpp \
     $$PWD/sourcelocationcontainer.cpp \
     $$PWD/sourcelocationcontainerv2.cpp \
     $$PWD/sourcelocationscontainer.cpp \
@@ -71,12 +72,15 @@ SOURCES += \
     $$PWD/sourcerangescontainer.cpp \
     $$PWD/sourcerangesforquerymessage.cpp \
     $$PWD/sourcerangewithtextcontainer.cpp \
+    $$PWD/textchangecontainer.cpp \
     $$PWD/tokeninfocontainer.cpp \
     $$PWD/tooltipmessage.cpp \
     $$PWD/tooltipinfo.cpp \
     $$PWD/unsavedfilesremovedmessage.cpp \
     $$PWD/updateprojectpartsmessage.cpp \
     $$PWD/documentschangedmessage.cpp \
+    $$PWD/documentoutofsyncmessage.cpp \
+    $$PWD/documenttextchangedmessage.cpp \
     $$PWD/documentvisibilitychangedmessage.cpp \
     $$PWD/writemessageblock.cpp \
     $$PWD/filepathcaching.cpp \
@@ -165,6 +169,7 @@ HEADERS += \
     $$PWD/requestsourcerangesanddiagnosticsforquerymessage.h \
     $$PWD/requestsourcerangesforquerymessage.h \
     $$PWD/requesttooltipmessage.h \
+    $$PWD/sharedmemorytransport.h \
     $$PWD/sourcelocationcontainer.h \
     $$PWD/sourcelocationcontainerv2.h \
     $$PWD/sourcelocationscontainer.h \
@@ -180,18 +185,22 @@ HEADERS += \
     $$PWD/sourcerangesforquerymessage.h \
     $$PWD/sourcerangewithtextcontainer.h \
     $$PWD/stringcache.h \
+    $$PWD/textchangecontainer.h \
     $$PWD/tokeninfocontainer.h \
     $$PWD/tooltipmessage.h \
     $$PWD/tooltipinfo.h \
     $$PWD/unsavedfilesremovedmessage.h \
     $$PWD/updateprojectpartsmessage.h \
     $$PWD/documentschangedmessage.h \
+    $$PWD/documentoutofsyncmessage.h \
+    $$PWD/documenttextchangedmessage.h \
     $$PWD/documentvisibilitychangedmessage.h \
     $$PWD/writemessageblock.h \
     $$PWD/ipcclientprovider.h \
     $$PWD/requestsourcerangesforquerymessage.h \
     $$PWD/stringcachefwd.h \
     $$PWD/stringcachealgorithms.h \
+    $$PWD/stringcachelookup.h \
     $$PWD/projectmanagementserverinterface.h \
     $$PWD/refactoringdatabaseinitializer.h \
     $$PWD/filepathcache.h \
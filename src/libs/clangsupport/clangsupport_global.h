@@ -149,6 +149,8 @@ enum class MessageType : quint8 {
 
     DocumentsOpenedMessage,
     DocumentsChangedMessage,
+    DocumentTextChangedMessage,
+    DocumentOutOfSyncMessage,
     DocumentsClosedMessage,
     DocumentVisibilityChangedMessage,
 
@@ -184,7 +186,9 @@ enum class MessageType : quint8 {
     PrecompiledHeadersUpdatedMessage,
     UpdateGeneratedFilesMessage,
     RemoveGeneratedFilesMessage,
-    ProgressMessage
+    ProgressMessage,
+
+    SharedMemoryMessage
 };
 
 template<MessageType messageEnumeration>
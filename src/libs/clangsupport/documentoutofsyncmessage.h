@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "clangsupport_global.h"
+
+#include <utf8string.h>
+
+#include <QDataStream>
+
+namespace ClangBackEnd {
+
+class DocumentOutOfSyncMessage
+{
+public:
+    DocumentOutOfSyncMessage() = default;
+    DocumentOutOfSyncMessage(const Utf8String &filePath, quint32 documentRevision)
+        : filePath(filePath)
+        , documentRevision(documentRevision)
+    {
+    }
+
+    friend QDataStream &operator<<(QDataStream &out, const DocumentOutOfSyncMessage &message)
+    {
+        out << message.filePath;
+        out << message.documentRevision;
+
+        return out;
+    }
+
+    friend QDataStream &operator>>(QDataStream &in, DocumentOutOfSyncMessage &message)
+    {
+        in >> message.filePath;
+        in >> message.documentRevision;
+
+        return in;
+    }
+
+    friend bool operator==(const DocumentOutOfSyncMessage &first,
+                           const DocumentOutOfSyncMessage &second)
+    {
+        return first.filePath == second.filePath
+            && first.documentRevision == second.documentRevision;
+    }
+
+public:
+    Utf8String filePath;
+    quint32 documentRevision = 0; // Revision of the rejected text changes
+};
+
+CLANGSUPPORT_EXPORT QDebug operator<<(QDebug debug, const DocumentOutOfSyncMessage &message);
+
+DECLARE_MESSAGE(DocumentOutOfSyncMessage)
+} // namespace ClangBackEnd
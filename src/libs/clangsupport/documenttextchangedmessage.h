@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "filecontainer.h"
+#include "textchangecontainer.h"
+
+#include <QVector>
+
+namespace ClangBackEnd {
+
+// Carries only the edits of an unsaved document since the revision the backend already
+// knows. The backend answers with a DocumentOutOfSyncMessage if its revision differs.
+class DocumentTextChangedMessage
+{
+public:
+    DocumentTextChangedMessage() = default;
+    DocumentTextChangedMessage(const FileContainer &fileContainer,
+                               quint32 baseDocumentRevision,
+                               const QVector<TextChangeContainer> &textChanges)
+        : fileContainer(fileContainer),
+          textChanges(textChanges),
+          baseDocumentRevision(baseDocumentRevision)
+    {
+    }
+
+    friend QDataStream &operator<<(QDataStream &out, const DocumentTextChangedMessage &message)
+    {
+        out << message.fileContainer;
+        out << message.baseDocumentRevision;
+        out << message.textChanges;
+
+        return out;
+    }
+
+    friend QDataStream &operator>>(QDataStream &in, DocumentTextChangedMessage &message)
+    {
+        in >> message.fileContainer;
+        in >> message.baseDocumentRevision;
+        in >> message.textChanges;
+
+        return in;
+    }
+
+    friend bool operator==(const DocumentTextChangedMessage &first,
+                           const DocumentTextChangedMessage &second)
+    {
+        return first.fileContainer == second.fileContainer
+            && first.baseDocumentRevision == second.baseDocumentRevision
+            && first.textChanges == second.textChanges;
+    }
+
+public:
+    FileContainer fileContainer;
+    QVector<TextChangeContainer> textChanges;
+    quint32 baseDocumentRevision = 0;
+};
+
+CLANGSUPPORT_EXPORT QDebug operator<<(QDebug debug, const DocumentTextChangedMessage &message);
+
+DECLARE_MESSAGE(DocumentTextChangedMessage)
+} // namespace ClangBackEnd
@@ -29,6 +29,8 @@
 
 #include <utils/smallstring.h>
 
+#include <QHash>
+
 #include <cstdint>
 #include <vector>
 #include <tuple>
@@ -54,6 +56,11 @@ public:
         return Utils::compare(first.fileName, second.fileName);
     }
 
+    friend std::size_t stringCacheHash(FileNameView view)
+    {
+        return qHashBits(view.fileName.data(), view.fileName.size(), uint(view.directoryId));
+    }
+
 public:
     Utils::SmallStringView fileName;
     int directoryId;
@@ -44,6 +44,12 @@ QDebug operator<<(QDebug debug, const MessageEnvelop &messageEnvelop)
         case MessageType::DocumentsChangedMessage:
             qDebug() << messageEnvelop.message<DocumentsChangedMessage>();
             break;
+        case MessageType::DocumentTextChangedMessage:
+            qDebug() << messageEnvelop.message<DocumentTextChangedMessage>();
+            break;
+        case MessageType::DocumentOutOfSyncMessage:
+            qDebug() << messageEnvelop.message<DocumentOutOfSyncMessage>();
+            break;
         case MessageType::DocumentsClosedMessage:
             qDebug() << messageEnvelop.message<DocumentsClosedMessage>();
             break;
@@ -86,6 +92,9 @@ QDebug operator<<(QDebug debug, const MessageEnvelop &messageEnvelop)
         case MessageType::AnnotationsMessage:
             qDebug() << messageEnvelop.message<AnnotationsMessage>();
             break;
+        case MessageType::SharedMemoryMessage:
+            qDebug() << "SharedMemoryMessage()";
+            break;
         default:
             qWarning() << "Unknown Message";
     }
@@ -110,6 +110,9 @@ public:
     friend QDebug operator<<(QDebug debug, const MessageEnvelop &messageEnvelop);
 
 private:
+    friend class SharedMemoryWriter;
+    friend class SharedMemoryReader;
+
     mutable QByteArray data;
     MessageType messageType_ = MessageType::InvalidMessage;
 };
@@ -35,9 +35,10 @@ class ProgressMessage
 {
 public:
     ProgressMessage() = default;
-    ProgressMessage(ProgressType progressType, int progress, int total)
+    ProgressMessage(ProgressType progressType, int progress, int total, int itemsPerSecond = 0)
         : progress(progress)
         , total(total)
+        , itemsPerSecond(itemsPerSecond)
         , progressType(progressType)
     {}
 
@@ -45,6 +46,7 @@ public:
     {
         out << message.progress;
         out << message.total;
+        out << message.itemsPerSecond;
         out << static_cast<int>(message.progressType);
 
         return out;
@@ -55,6 +57,7 @@ public:
         int progressTupe;
         in >> message.progress;
         in >> message.total;
+        in >> message.itemsPerSecond;
         in >> progressTupe;
         message.progressType = static_cast<ProgressType>(progressTupe);
 
@@ -64,7 +67,8 @@ public:
     friend bool operator==(const ProgressMessage &first, const ProgressMessage &second)
     {
         return first.progress == second.progress
-            && first.total == second.total;
+            && first.total == second.total
+            && first.itemsPerSecond == second.itemsPerSecond;
     }
 
     ProgressMessage clone() const
@@ -75,6 +79,7 @@ public:
 public:
     int progress = 0;
     int total = 0;
+    int itemsPerSecond = 0;
     ProgressType progressType = ProgressType::Invalid;
 };
 
@@ -30,6 +30,7 @@
 #include <QDataStream>
 #include <QDebug>
 #include <QIODevice>
+#include <QTimer>
 #include <QVariant>
 
 namespace ClangBackEnd {
@@ -65,11 +66,20 @@ MessageEnvelop ReadMessageBlock::read()
 
     MessageEnvelop message;
 
+    if (m_isResyncing)
+        return message;
+
     if (isTheWholeMessageReadable(in)) {
         bool messageIsLost = checkIfMessageIsLost(in);
 
         in >> message;
 
+        if (message.messageType() == MessageType::SharedMemoryMessage
+                && !m_sharedMemoryReader.fromDescriptor(message)) {
+            resyncConnection();
+            return MessageEnvelop();
+        }
+
         if (messageIsLost)
             qDebug() << message;
     }
@@ -95,6 +105,8 @@ std::vector<MessageEnvelop> ReadMessageBlock::readAll()
 void ReadMessageBlock::resetState()
 {
     m_messageCounter = 0;
+    m_isResyncing = false;
+    m_sharedMemoryReader.resetState();
 }
 
 void ReadMessageBlock::setIoDevice(QIODevice *ioDevice)
@@ -102,6 +114,21 @@ void ReadMessageBlock::setIoDevice(QIODevice *ioDevice)
     m_ioDevice = ioDevice;
 }
 
+// A message that could not be read from the shared memory is lost, and the other side would
+// wait for its answer forever. Closing the connection lets both sides start over, like after
+// a crash of the backend. The reader marks the segment as failed before, so the writer sends
+// everything through the socket from then on.
+void ReadMessageBlock::resyncConnection()
+{
+    qWarning() << "Failed to read message from shared memory, closing the connection to resync";
+
+    m_isResyncing = true;
+
+    // The device is most likely emitting readyRead() right now.
+    QIODevice *ioDevice = m_ioDevice;
+    QTimer::singleShot(0, ioDevice, [ioDevice] { ioDevice->close(); });
+}
+
 bool ReadMessageBlock::isTheWholeMessageReadable(QDataStream &in)
 {
     if (m_ioDevice->bytesAvailable() < qint64(sizeof(m_blockSize)))
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "sharedmemorytransport.h"
+
 #include <QtGlobal>
 
 #include <vector>
@@ -53,11 +55,14 @@ public:
 private:
     bool isTheWholeMessageReadable(QDataStream &in);
     bool checkIfMessageIsLost(QDataStream &in);
+    void resyncConnection();
 
 private:
     QIODevice *m_ioDevice;
     qint64 m_messageCounter;
     qint32 m_blockSize;
+    bool m_isResyncing = false;
+    SharedMemoryReader m_sharedMemoryReader;
 };
 
 } // namespace ClangBackEnd
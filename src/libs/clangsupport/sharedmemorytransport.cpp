@@ -0,0 +1,297 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "sharedmemorytransport.h"
+
+#include "messageenvelop.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QSharedMemory>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace ClangBackEnd {
+
+namespace {
+
+enum : quint64 {
+    MinimumPayloadSize = 64 * 1024,
+    RingBufferCapacity = 32 * 1024 * 1024,
+    HeaderSize = 64
+};
+
+enum { MaximumSegmentCount = 64 };
+
+enum ReaderState : quint32 {
+    ReaderNotAttached,
+    ReaderAttached,
+    ReaderFailed
+};
+
+// Positions grow monotonically, the offset in the ring buffer is position % capacity.
+// Only the reader advances the read position, after it has copied the payload out.
+// The reader state tells the writer whether the reader could attach to the segment. Until
+// it could, the payloads are sent inline, and after a failure they are sent inline for good.
+struct RingBufferHeader
+{
+    std::atomic<quint64> readPosition;
+    quint64 capacity;
+    std::atomic<quint32> readerState;
+};
+
+static_assert(sizeof(RingBufferHeader) <= HeaderSize, "Header does not fit");
+
+RingBufferHeader *header(QSharedMemory &sharedMemory)
+{
+    return static_cast<RingBufferHeader *>(sharedMemory.data());
+}
+
+char *ringBuffer(QSharedMemory &sharedMemory)
+{
+    return static_cast<char *>(sharedMemory.data()) + HeaderSize;
+}
+
+// The keys are unique per process, so several Qt Creator instances and their backends never
+// pick the same segment. A segment left behind by a crashed process with the same id is
+// released when it is found again.
+QString keyForSegment(int index)
+{
+    return QStringLiteral("qtc-clangsupport-ipc-%1-%2")
+            .arg(QCoreApplication::applicationPid())
+            .arg(index);
+}
+
+void releaseIfStale(QSharedMemory &sharedMemory)
+{
+#ifdef Q_OS_UNIX
+    // Detaching releases the segment if no other process is attached to it any more. On
+    // Windows the segment is released with the last handle to it anyway.
+    if (sharedMemory.attach(QSharedMemory::ReadOnly))
+        sharedMemory.detach();
+#else
+    Q_UNUSED(sharedMemory)
+#endif
+}
+
+} // anonymous namespace
+
+SharedMemoryWriter::SharedMemoryWriter() = default;
+
+SharedMemoryWriter::~SharedMemoryWriter() = default;
+
+bool SharedMemoryWriter::isEnabled()
+{
+    // The payload is copied into the segment and out of it again, which is not less copying
+    // than through the socket, so it is only used if asked for.
+    static bool enabled = qEnvironmentVariableIntValue("QTC_CLANG_SHARED_MEMORY_IPC");
+
+    return enabled;
+}
+
+bool SharedMemoryWriter::createSharedMemory()
+{
+    QString errorString;
+    for (int index = 0; index < MaximumSegmentCount; ++index) {
+        auto sharedMemory = std::make_unique<QSharedMemory>(keyForSegment(index));
+        releaseIfStale(*sharedMemory);
+        if (!sharedMemory->create(int(HeaderSize + RingBufferCapacity))) {
+            errorString = sharedMemory->errorString();
+            continue;
+        }
+
+        RingBufferHeader *ringBufferHeader = header(*sharedMemory);
+        new (&ringBufferHeader->readPosition) std::atomic<quint64>(0);
+        ringBufferHeader->capacity = RingBufferCapacity;
+        new (&ringBufferHeader->readerState) std::atomic<quint32>(ReaderNotAttached);
+
+        m_sharedMemory = std::move(sharedMemory);
+        m_writePosition = 0;
+
+        return true;
+    }
+
+    qWarning() << "Failed to create shared memory for IPC, using the socket only:" << errorString;
+    m_sharedMemoryFailed = true;
+
+    return false;
+}
+
+MessageEnvelop SharedMemoryWriter::toDescriptor(const MessageEnvelop &message)
+{
+    const QByteArray &payload = message.data;
+    const quint64 payloadSize = quint64(payload.size());
+
+    if (payloadSize < MinimumPayloadSize || m_sharedMemoryFailed || !isEnabled())
+        return MessageEnvelop();
+
+    if (!m_sharedMemory && !createSharedMemory())
+        return MessageEnvelop();
+
+    RingBufferHeader *ringBufferHeader = header(*m_sharedMemory);
+
+    MessageEnvelop descriptor;
+    descriptor.messageType_ = MessageType::SharedMemoryMessage;
+    QDataStream stream(&descriptor.data, QIODevice::WriteOnly);
+    stream << static_cast<quint8>(message.messageType_);
+    stream << m_sharedMemory->key();
+
+    switch (ringBufferHeader->readerState.load(std::memory_order_acquire)) {
+    case ReaderNotAttached:
+        // Lets the reader attach to the segment without depending on it.
+        stream << true;
+        stream << payload;
+        return descriptor;
+    case ReaderAttached:
+        break;
+    default:
+        qWarning() << "The reader failed to use the IPC shared memory, using the socket only";
+        m_sharedMemoryFailed = true;
+        m_sharedMemory.reset();
+        return MessageEnvelop();
+    }
+
+    const quint64 capacity = ringBufferHeader->capacity;
+    const quint64 readPosition = ringBufferHeader->readPosition.load(std::memory_order_acquire);
+    if (m_writePosition - readPosition + payloadSize > capacity)
+        return MessageEnvelop(); // The reader is behind, so don't wait for it.
+
+    const quint64 offset = m_writePosition % capacity;
+    const quint64 firstPartSize = std::min(payloadSize, capacity - offset);
+    char *buffer = ringBuffer(*m_sharedMemory);
+    std::memcpy(buffer + offset, payload.constData(), firstPartSize);
+    std::memcpy(buffer, payload.constData() + firstPartSize, payloadSize - firstPartSize);
+
+    stream << false;
+    stream << m_writePosition;
+    stream << payloadSize;
+
+    m_writePosition += payloadSize;
+
+    return descriptor;
+}
+
+void SharedMemoryWriter::resetState()
+{
+    // A new reader gets a new segment, so nothing from the old reader can be mixed in.
+    m_sharedMemory.reset();
+    m_writePosition = 0;
+}
+
+SharedMemoryReader::SharedMemoryReader() = default;
+
+SharedMemoryReader::~SharedMemoryReader() = default;
+
+bool SharedMemoryReader::attachSharedMemory(const QString &key)
+{
+    auto sharedMemory = std::make_unique<QSharedMemory>(key);
+    if (!sharedMemory->attach()) {
+        qWarning() << "Failed to attach to IPC shared memory:" << sharedMemory->errorString();
+        m_failedKey = key;
+        return false;
+    }
+
+    m_sharedMemory = std::move(sharedMemory);
+    header(*m_sharedMemory)->readerState.store(ReaderAttached, std::memory_order_release);
+
+    return true;
+}
+
+bool SharedMemoryReader::fromDescriptor(MessageEnvelop &message)
+{
+    quint8 messageType;
+    QString key;
+    bool isInline;
+
+    QDataStream stream(&message.data, QIODevice::ReadOnly);
+    stream >> messageType;
+    stream >> key;
+    stream >> isInline;
+
+    const bool isAttached = m_sharedMemory && m_sharedMemory->key() == key;
+
+    if (isInline) {
+        QByteArray payload;
+        stream >> payload;
+        if (stream.status() != QDataStream::Ok)
+            return false;
+
+        if (!isAttached && key != m_failedKey)
+            attachSharedMemory(key);
+
+        message.messageType_ = static_cast<MessageType>(messageType);
+        message.data = std::move(payload);
+
+        return true;
+    }
+
+    quint64 position;
+    quint64 payloadSize;
+    stream >> position;
+    stream >> payloadSize;
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    // The writer only uses the ring buffer after a reader attached to it, but this reader
+    // might have been reset since.
+    if (!isAttached && (key == m_failedKey || !attachSharedMemory(key)))
+        return false;
+
+    RingBufferHeader *ringBufferHeader = header(*m_sharedMemory);
+    const quint64 capacity = ringBufferHeader->capacity;
+    const quint64 readPosition = ringBufferHeader->readPosition.load(std::memory_order_relaxed);
+    if (payloadSize > capacity || position != readPosition) {
+        ringBufferHeader->readerState.store(ReaderFailed, std::memory_order_release);
+        return false;
+    }
+
+    const quint64 offset = position % capacity;
+    const quint64 firstPartSize = std::min(payloadSize, capacity - offset);
+    const char *buffer = ringBuffer(*m_sharedMemory);
+
+    QByteArray payload(int(payloadSize), Qt::Uninitialized);
+    std::memcpy(payload.data(), buffer + offset, firstPartSize);
+    std::memcpy(payload.data() + firstPartSize, buffer, payloadSize - firstPartSize);
+
+    ringBufferHeader->readPosition.store(position + payloadSize, std::memory_order_release);
+
+    message.messageType_ = static_cast<MessageType>(messageType);
+    message.data = std::move(payload);
+
+    return true;
+}
+
+void SharedMemoryReader::resetState()
+{
+    m_sharedMemory.reset();
+    m_failedKey.clear();
+}
+
+} // namespace ClangBackEnd
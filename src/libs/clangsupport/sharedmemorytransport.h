@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QSharedMemory;
+QT_END_NAMESPACE
+
+namespace ClangBackEnd {
+
+class MessageEnvelop;
+
+// Large message payloads (annotations, completions) are copied into a shared memory ring
+// buffer owned by the writing process. Only a small SharedMemoryMessage descriptor goes
+// through the socket. The first descriptors carry the payload inline, until the reader has
+// attached to the ring buffer. If the ring buffer is full, the reader failed to use it or
+// shared memory is not available, the message is sent through the socket as before.
+// Shared memory is only used if QTC_CLANG_SHARED_MEMORY_IPC is set.
+class SharedMemoryWriter
+{
+public:
+    SharedMemoryWriter();
+    ~SharedMemoryWriter();
+
+    // Returns an invalid envelop if the message should be sent as it is.
+    MessageEnvelop toDescriptor(const MessageEnvelop &message);
+
+    void resetState();
+
+    static bool isEnabled();
+
+private:
+    bool createSharedMemory();
+
+private:
+    std::unique_ptr<QSharedMemory> m_sharedMemory;
+    quint64 m_writePosition = 0;
+    bool m_sharedMemoryFailed = false;
+};
+
+class SharedMemoryReader
+{
+public:
+    SharedMemoryReader();
+    ~SharedMemoryReader();
+
+    // Replaces the descriptor with the message from the shared memory. Returns false if the
+    // message is lost, then the writer sends everything through the socket from now on.
+    bool fromDescriptor(MessageEnvelop &message);
+
+    void resetState();
+
+private:
+    bool attachSharedMemory(const QString &key);
+
+private:
+    std::unique_ptr<QSharedMemory> m_sharedMemory;
+    QString m_failedKey;
+};
+
+} // namespace ClangBackEnd
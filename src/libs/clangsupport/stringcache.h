@@ -28,6 +28,7 @@
 #include "stringcachealgorithms.h"
 #include "stringcacheentry.h"
 #include "stringcachefwd.h"
+#include "stringcachelookup.h"
 
 #include <utils/algorithm.h>
 #include <utils/optional.h>
@@ -113,6 +114,7 @@ public:
     using CacheEntries = std::vector<CacheEntry>;
     using const_iterator = typename CacheEntries::const_iterator;
     using Found = ClangBackEnd::Found<const_iterator>;
+    using Lookup = StringCacheLookup<StringType, StringViewType, Compare, compare>;
 
     StringCache(std::size_t reserveSize = 1024)
     {
@@ -123,7 +125,9 @@ public:
     StringCache(const StringCache &other)
         : m_strings(other.m_strings)
         , m_indices(other.m_indices)
-    {}
+    {
+        updateLookup();
+    }
 
     template<typename Cache>
     Cache clone()
@@ -131,6 +135,7 @@ public:
         Cache cache;
         cache.m_strings = m_strings;
         cache.m_indices = m_indices;
+        cache.updateLookup();
 
         return cache;
     }
@@ -138,12 +143,18 @@ public:
     StringCache(StringCache &&other)
         : m_strings(std::move(other.m_strings))
         , m_indices(std::move(other.m_indices))
-    {}
+    {
+        updateLookup();
+        other.m_lookup.clear();
+    }
 
     StringCache &operator=(StringCache &&other)
     {
         m_strings = std::move(other.m_strings);
         m_indices = std::move(other.m_indices);
+        m_lookup.clear();
+        updateLookup();
+        other.m_lookup.clear();
 
         return *this;
     }
@@ -177,6 +188,7 @@ public:
         m_indices.resize(max_id, -1);
 
         updateIndices();
+        updateLookup();
     }
 
     template<typename Function>
@@ -188,6 +200,8 @@ public:
 
         std::sort(strings.begin(), strings.end(), less);
 
+        std::lock_guard<Mutex> exclusiveLock(m_mutex);
+
         strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
 
         CacheEntries newCacheEntries;
@@ -218,6 +232,9 @@ public:
             CacheEntries mergedCacheEntries;
             mergedCacheEntries.reserve(newCacheEntries.size() + m_strings.size());
 
+            for (const CacheEntry &entry : newCacheEntries)
+                m_lookup.insert(entry.string, int(entry.id));
+
             std::merge(std::make_move_iterator(m_strings.begin()),
                        std::make_move_iterator(m_strings.end()),
                        std::make_move_iterator(newCacheEntries.begin()),
@@ -233,6 +250,9 @@ public:
 
     IndexType stringId(StringViewType stringView)
     {
+        if (auto id = m_lookup.findId(stringView))
+            return IndexType(*id);
+
         std::shared_lock<Mutex> sharedLock(m_mutex);
         Found found = find(stringView);
 
@@ -247,6 +267,7 @@ public:
         if (!found.wasFound) {
             IndexType index = insertString(found.iterator, stringView, IndexType(m_indices.size()));
             found.iterator = m_strings.begin() + index;
+            m_lookup.insert(stringView, int(found.iterator->id));
         }
 
         return found.iterator->id;
@@ -294,6 +315,9 @@ public:
 
     StringResultType string(IndexType id) const
     {
+        if (auto string = m_lookup.template findString<StringResultType>(int(id)))
+            return *string;
+
         std::shared_lock<Mutex> sharedLock(m_mutex);
 
         return m_strings.at(m_indices.at(id)).string;
@@ -302,6 +326,9 @@ public:
     template<typename Function>
     StringResultType string(IndexType id, Function storageFunction)
     {
+        if (auto string = m_lookup.template findString<StringResultType>(int(id)))
+            return *string;
+
         std::shared_lock<Mutex> sharedLock(m_mutex);
 
         if (IndexType(m_indices.size()) > id && m_indices.at(id) >= 0)
@@ -314,19 +341,27 @@ public:
 
         StringType string{storageFunction(id)};
         index = insertString(find(string).iterator, string, id);
+        m_lookup.insert(string, int(id));
 
         return m_strings[index].string;
     }
 
     std::vector<StringResultType> strings(const std::vector<IndexType> &ids) const
     {
-        std::shared_lock<Mutex> sharedLock(m_mutex);
+        std::shared_lock<Mutex> sharedLock(m_mutex, std::defer_lock);
 
         std::vector<StringResultType> strings;
         strings.reserve(ids.size());
 
-        for (IndexType id : ids)
-            strings.emplace_back(m_strings.at(m_indices.at(id)).string);
+        for (IndexType id : ids) {
+            if (auto string = m_lookup.template findString<StringResultType>(int(id))) {
+                strings.push_back(std::move(*string));
+            } else {
+                if (!sharedLock.owns_lock())
+                    sharedLock.lock();
+                strings.emplace_back(m_strings.at(m_indices.at(id)).string);
+            }
+        }
 
         return strings;
     }
@@ -339,6 +374,9 @@ public:
     template<typename Function>
     IndexType stringId(StringViewType stringView, Function storageFunction)
     {
+        if (auto id = m_lookup.findId(stringView))
+            return IndexType(*id);
+
         std::shared_lock<Mutex> sharedLock(m_mutex);
 
         Found found = find(stringView);
@@ -354,6 +392,7 @@ public:
         if (!found.wasFound) {
             IndexType index = insertString(found.iterator, stringView, storageFunction(stringView));
             found.iterator = m_strings.begin() + index;
+            m_lookup.insert(stringView, int(found.iterator->id));
         }
 
         return found.iterator->id;
@@ -372,6 +411,14 @@ private:
             m_indices[current->id] = std::distance(begin, current);
     }
 
+    // Only adds what the lookup does not know yet. The storage never gives an id to another
+    // string, so known entries stay valid when the cache is populated again.
+    void updateLookup()
+    {
+        for (const CacheEntry &entry : m_strings)
+            m_lookup.insert(entry.string, int(entry.id));
+    }
+
     Found find(StringViewType stringView)
     {
         return findInSorted(m_strings.cbegin(), m_strings.cend(), stringView, compare);
@@ -420,6 +467,7 @@ private:
 private:
     CacheEntries m_strings;
     std::vector<IndexType> m_indices;
+    Lookup m_lookup;
     mutable Mutex m_mutex;
 };
 
@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include <utils/optional.h>
+#include <utils/smallstringview.h>
+
+#include <QHash>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ClangBackEnd {
+
+inline std::size_t stringCacheHash(Utils::SmallStringView string)
+{
+    return qHashBits(string.data(), string.size());
+}
+
+// Read-mostly hash table in front of the sorted entries of a StringCache. Readers never lock,
+// they only announce themselves in a reader counter while they use a table. Replaced tables
+// and entries are retired and freed by the writer as soon as no reader is active, because a
+// reader which starts later can only see the new tables. Only one writer may change the
+// lookup at a time, the StringCache serializes them with its exclusive lock.
+template<typename StringType, typename StringViewType, typename Compare, Compare compare>
+class StringCacheLookup
+{
+public:
+    class Entry
+    {
+    public:
+        Entry(StringViewType string, int id)
+            : string(string)
+            , id(id)
+        {}
+
+    public:
+        StringType string;
+        int id;
+    };
+
+    StringCacheLookup()
+        : m_stringTableOwner(std::make_unique<Table>(initialCapacity))
+        , m_idTableOwner(std::make_unique<Table>(initialCapacity))
+        , m_stringTable(m_stringTableOwner.get())
+        , m_idTable(m_idTableOwner.get())
+    {}
+
+    StringCacheLookup(const StringCacheLookup &) = delete;
+    StringCacheLookup &operator=(const StringCacheLookup &) = delete;
+
+    Utils::optional<int> findId(StringViewType stringView) const
+    {
+        ReaderGuard guard{*this};
+
+        if (const Entry *entry = findEntry(m_stringTable.load(), stringView))
+            return entry->id;
+
+        return {};
+    }
+
+    template<typename ResultType>
+    Utils::optional<ResultType> findString(int id) const
+    {
+        ReaderGuard guard{*this};
+
+        if (const Entry *entry = findEntry(m_idTable.load(), id))
+            return ResultType(entry->string);
+
+        return {};
+    }
+
+    // Entries which are already known with the same id are kept, so refilling the lookup
+    // from the cache entries only touches what changed.
+    void insert(StringViewType stringView, int id)
+    {
+        if (const Entry *oldEntry = findEntry(m_stringTable.load(std::memory_order_relaxed),
+                                              stringView)) {
+            if (oldEntry->id == id)
+                return;
+
+            retireEntry(oldEntry);
+        }
+
+        if ((m_entries.size() + 1) * 2 > m_stringTableOwner->capacity)
+            growStringTable();
+
+        if (id >= 0 && std::size_t(id) >= m_idTableOwner->capacity)
+            growIdTable(std::size_t(id));
+
+        m_entries.push_back(std::make_unique<Entry>(stringView, id));
+        const Entry *entry = m_entries.back().get();
+
+        storeInStringTable(*m_stringTableOwner, entry);
+        if (id >= 0)
+            m_idTableOwner->slots[std::size_t(id)].store(entry, std::memory_order_release);
+
+        reclaim();
+    }
+
+    void clear()
+    {
+        publish(m_stringTable, m_stringTableOwner, std::make_unique<Table>(initialCapacity));
+        publish(m_idTable, m_idTableOwner, std::make_unique<Table>(initialCapacity));
+        std::move(m_entries.begin(), m_entries.end(), std::back_inserter(m_retiredEntries));
+        m_entries.clear();
+
+        reclaim();
+    }
+
+    std::size_t retiredCount() const
+    {
+        return m_retiredEntries.size() + m_retiredTables.size();
+    }
+
+private:
+    class Table
+    {
+    public:
+        Table(std::size_t capacity)
+            : capacity(capacity)
+            , slots(new std::atomic<const Entry *>[capacity])
+        {
+            for (std::size_t index = 0; index < capacity; ++index)
+                slots[index].store(nullptr, std::memory_order_relaxed);
+        }
+
+    public:
+        std::size_t capacity;
+        std::unique_ptr<std::atomic<const Entry *>[]> slots;
+    };
+
+    // The reader counters are spread over cache lines, so that readers on different cores
+    // do not contend on one counter.
+    class alignas(64) ReaderCounter
+    {
+    public:
+        std::atomic<int> count{0};
+    };
+
+    class ReaderGuard
+    {
+    public:
+        ReaderGuard(const StringCacheLookup &lookup)
+            : m_counter(lookup.m_readerCounters[readerCounterIndex()].count)
+        {
+            m_counter.fetch_add(1);
+        }
+
+        ~ReaderGuard() { m_counter.fetch_sub(1, std::memory_order_release); }
+
+    private:
+        std::atomic<int> &m_counter;
+    };
+
+    static std::size_t readerCounterIndex()
+    {
+        static thread_local const std::size_t index = std::hash<std::thread::id>{}(
+                                                          std::this_thread::get_id())
+                                                      % readerCounterCount;
+
+        return index;
+    }
+
+    const Entry *findEntry(const Table *table, StringViewType stringView) const
+    {
+        const std::size_t mask = table->capacity - 1;
+
+        for (std::size_t index = stringCacheHash(stringView) & mask;; index = (index + 1) & mask) {
+            const Entry *entry = table->slots[index].load(std::memory_order_acquire);
+
+            if (!entry || compare(StringViewType(entry->string), stringView) == 0)
+                return entry;
+        }
+    }
+
+    const Entry *findEntry(const Table *table, int id) const
+    {
+        if (id < 0 || std::size_t(id) >= table->capacity)
+            return nullptr;
+
+        return table->slots[std::size_t(id)].load(std::memory_order_acquire);
+    }
+
+    // Overwrites the slot of an entry with the same string, otherwise takes the first free one.
+    static void storeInStringTable(Table &table, const Entry *entry)
+    {
+        const StringViewType stringView{entry->string};
+        const std::size_t mask = table.capacity - 1;
+        std::size_t index = stringCacheHash(stringView) & mask;
+
+        while (const Entry *current = table.slots[index].load(std::memory_order_relaxed)) {
+            if (compare(StringViewType(current->string), stringView) == 0)
+                break;
+            index = (index + 1) & mask;
+        }
+
+        table.slots[index].store(entry, std::memory_order_release);
+    }
+
+    void publish(std::atomic<Table *> &table,
+                 std::unique_ptr<Table> &owner,
+                 std::unique_ptr<Table> &&newTable)
+    {
+        table.store(newTable.get());
+        m_retiredTables.push_back(std::move(owner));
+        owner = std::move(newTable);
+    }
+
+    void retireEntry(const Entry *entry)
+    {
+        auto found = std::find_if(m_entries.begin(), m_entries.end(), [&](const auto &current) {
+            return current.get() == entry;
+        });
+
+        if (entry->id >= 0 && std::size_t(entry->id) < m_idTableOwner->capacity) {
+            std::atomic<const Entry *> &slot = m_idTableOwner->slots[std::size_t(entry->id)];
+            if (slot.load(std::memory_order_relaxed) == entry)
+                slot.store(nullptr, std::memory_order_release);
+        }
+
+        m_retiredEntries.push_back(std::move(*found));
+        m_entries.erase(found);
+    }
+
+    void growStringTable()
+    {
+        auto newTable = std::make_unique<Table>(m_stringTableOwner->capacity * 2);
+
+        for (const auto &entry : m_entries)
+            storeInStringTable(*newTable, entry.get());
+
+        publish(m_stringTable, m_stringTableOwner, std::move(newTable));
+    }
+
+    void growIdTable(std::size_t id)
+    {
+        const Table &oldTable = *m_idTableOwner;
+        std::size_t capacity = oldTable.capacity;
+        while (capacity <= id)
+            capacity *= 2;
+
+        auto newTable = std::make_unique<Table>(capacity);
+
+        for (std::size_t index = 0; index < oldTable.capacity; ++index)
+            newTable->slots[index].store(oldTable.slots[index].load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+
+        publish(m_idTable, m_idTableOwner, std::move(newTable));
+    }
+
+    // A reader increments its counter before it loads a table pointer. If all counters are
+    // zero after the new tables were published, no reader can still use a retired one.
+    bool hasActiveReaders() const
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        return std::any_of(m_readerCounters.begin(),
+                           m_readerCounters.end(),
+                           [](const ReaderCounter &counter) { return counter.count.load() > 0; });
+    }
+
+    void reclaim()
+    {
+        if ((m_retiredEntries.empty() && m_retiredTables.empty()) || hasActiveReaders())
+            return;
+
+        m_retiredEntries.clear();
+        m_retiredTables.clear();
+    }
+
+private:
+    static constexpr std::size_t initialCapacity = 64;
+    static constexpr std::size_t readerCounterCount = 16;
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    std::vector<std::unique_ptr<Entry>> m_retiredEntries;
+    std::vector<std::unique_ptr<Table>> m_retiredTables;
+    std::unique_ptr<Table> m_stringTableOwner;
+    std::unique_ptr<Table> m_idTableOwner;
+    std::atomic<Table *> m_stringTable;
+    std::atomic<Table *> m_idTable;
+    std::array<ReaderCounter, readerCounterCount> m_readerCounters;
+};
+
+} // namespace ClangBackEnd
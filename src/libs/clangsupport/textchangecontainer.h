@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "clangsupport_global.h"
+
+#include <utf8string.h>
+
+#include <QDataStream>
+
+namespace ClangBackEnd {
+
+// Replaces the text between the start and the end position with the given text.
+// Lines and columns are 1-based, columns count UTF-8 bytes like clang does.
+class TextChangeContainer
+{
+public:
+    TextChangeContainer() = default;
+    TextChangeContainer(quint32 startLine,
+                        quint32 startColumn,
+                        quint32 endLine,
+                        quint32 endColumn,
+                        const Utf8String &text)
+        : text(text),
+          startLine(startLine),
+          startColumn(startColumn),
+          endLine(endLine),
+          endColumn(endColumn)
+    {
+    }
+
+    friend QDataStream &operator<<(QDataStream &out, const TextChangeContainer &container)
+    {
+        out << container.startLine;
+        out << container.startColumn;
+        out << container.endLine;
+        out << container.endColumn;
+        out << container.text;
+
+        return out;
+    }
+
+    friend QDataStream &operator>>(QDataStream &in, TextChangeContainer &container)
+    {
+        in >> container.startLine;
+        in >> container.startColumn;
+        in >> container.endLine;
+        in >> container.endColumn;
+        in >> container.text;
+
+        return in;
+    }
+
+    friend bool operator==(const TextChangeContainer &first, const TextChangeContainer &second)
+    {
+        return first.startLine == second.startLine
+            && first.startColumn == second.startColumn
+            && first.endLine == second.endLine
+            && first.endColumn == second.endColumn
+            && first.text == second.text;
+    }
+
+public:
+    Utf8String text;
+    quint32 startLine = 1;
+    quint32 startColumn = 1;
+    quint32 endLine = 1;
+    quint32 endColumn = 1;
+};
+
+CLANGSUPPORT_EXPORT QDebug operator<<(QDebug debug, const TextChangeContainer &container);
+
+} // namespace ClangBackEnd
@@ -53,7 +53,8 @@ void WriteMessageBlock::write(const MessageEnvelop &message)
 
     out << m_messageCounter;
 
-    out << message;
+    const MessageEnvelop descriptor = m_sharedMemoryWriter.toDescriptor(message);
+    out << (descriptor.isValid() ? descriptor : message);
 
     out.device()->seek(startOffset);
     out << qint32(m_block.size() - startOffset - sizeof(qint32));
@@ -72,6 +73,7 @@ void WriteMessageBlock::resetState()
 {
     m_block.clear();
     m_messageCounter = 0;
+    m_sharedMemoryWriter.resetState();
 }
 
 void WriteMessageBlock::setIoDevice(QIODevice *ioDevice)
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "sharedmemorytransport.h"
+
 #include <QByteArray>
 #include <QtGlobal>
 
@@ -58,6 +60,7 @@ public:
 
 private:
     QByteArray m_block;
+    SharedMemoryWriter m_sharedMemoryWriter;
     qint64 m_messageCounter = 0;
     QIODevice *m_ioDevice = {};
     QLocalSocket *m_localSocket = {};
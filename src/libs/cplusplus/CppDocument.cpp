@@ -50,6 +50,7 @@
 #include <QDir>
 #include <QFutureInterface>
 #include <QStack>
+#include <QtAlgorithms>
 
 /*!
     \namespace CPlusPlus
@@ -731,6 +732,218 @@ bool Document::DiagnosticMessage::operator!=(const Document::DiagnosticMessage &
     return !operator==(other);
 }
 
+namespace CPlusPlus {
+namespace Internal {
+
+// A node of the trie consumes 5 bits of the hash of the file name per level and keeps its
+// entries ordered by these bits. An entry either holds a document or refers to the next level.
+// The hash is exhausted after 7 levels, so nodes on the last level just list their entries.
+class SnapshotNode
+{
+public:
+    struct Entry
+    {
+        uint hash;
+        Utils::FilePath fileName;
+        Document::Ptr document;
+        std::shared_ptr<const SnapshotNode> child;
+    };
+
+    quint32 bitmap = 0;
+    QVector<Entry> entries;
+};
+
+} // namespace Internal
+} // namespace CPlusPlus
+
+using CPlusPlus::Internal::SnapshotNode;
+
+namespace {
+
+using NodePtr = std::shared_ptr<const SnapshotNode>;
+
+const int BitsPerLevel = 5;
+const int LastLevel = 7;
+
+quint32 bitForLevel(uint hash, int level)
+{
+    return quint32(1) << ((hash >> (level * BitsPerLevel)) & 31);
+}
+
+int entryIndex(quint32 bitmap, quint32 bit)
+{
+    return int(qPopulationCount(bitmap & (bit - 1)));
+}
+
+const SnapshotNode::Entry *findEntry(const SnapshotNode *node, uint hash,
+                                     const Utils::FilePath &fileName)
+{
+    for (int level = 0; node; ++level) {
+        if (level == LastLevel) {
+            for (const SnapshotNode::Entry &entry : node->entries) {
+                if (entry.fileName == fileName)
+                    return &entry;
+            }
+            return nullptr;
+        }
+
+        const quint32 bit = bitForLevel(hash, level);
+        if (!(node->bitmap & bit))
+            return nullptr;
+        const SnapshotNode::Entry &entry = node->entries.at(entryIndex(node->bitmap, bit));
+        if (!entry.child)
+            return entry.hash == hash && entry.fileName == fileName ? &entry : nullptr;
+        node = entry.child.get();
+    }
+    return nullptr;
+}
+
+NodePtr inserted(const SnapshotNode *node, int level, const SnapshotNode::Entry &newEntry,
+                 bool *added)
+{
+    auto result = node ? std::make_shared<SnapshotNode>(*node) : std::make_shared<SnapshotNode>();
+
+    if (level == LastLevel) {
+        for (SnapshotNode::Entry &entry : result->entries) {
+            if (entry.fileName == newEntry.fileName) {
+                entry.document = newEntry.document;
+                return result;
+            }
+        }
+        result->entries.append(newEntry);
+        *added = true;
+        return result;
+    }
+
+    const quint32 bit = bitForLevel(newEntry.hash, level);
+    const int index = entryIndex(result->bitmap, bit);
+    if (!(result->bitmap & bit)) {
+        result->bitmap |= bit;
+        result->entries.insert(index, newEntry);
+        *added = true;
+        return result;
+    }
+
+    SnapshotNode::Entry &entry = result->entries[index];
+    if (entry.child) {
+        entry.child = inserted(entry.child.get(), level + 1, newEntry, added);
+    } else if (entry.hash == newEntry.hash && entry.fileName == newEntry.fileName) {
+        entry.document = newEntry.document;
+    } else {
+        // Move the present document one level down, next to the new one.
+        bool ignored;
+        const NodePtr child = inserted(nullptr, level + 1, entry, &ignored);
+        entry.child = inserted(child.get(), level + 1, newEntry, added);
+        entry.fileName = Utils::FilePath();
+        entry.document.reset();
+    }
+    return result;
+}
+
+NodePtr removed(const NodePtr &node, int level, uint hash, const Utils::FilePath &fileName,
+                bool *wasRemoved)
+{
+    int index = -1;
+    if (level == LastLevel) {
+        for (int i = 0; i < node->entries.size(); ++i) {
+            if (node->entries.at(i).fileName == fileName) {
+                index = i;
+                break;
+            }
+        }
+        if (index == -1)
+            return node;
+    } else {
+        const quint32 bit = bitForLevel(hash, level);
+        if (!(node->bitmap & bit))
+            return node;
+        index = entryIndex(node->bitmap, bit);
+    }
+
+    const SnapshotNode::Entry &entry = node->entries.at(index);
+    NodePtr child;
+    if (entry.child) {
+        child = removed(entry.child, level + 1, hash, fileName, wasRemoved);
+        if (child == entry.child)
+            return node;
+    } else if (entry.hash != hash || entry.fileName != fileName) {
+        return node;
+    } else {
+        *wasRemoved = true;
+    }
+
+    auto result = std::make_shared<SnapshotNode>(*node);
+    if (child && (child->entries.size() > 1 || child->entries.first().child)) {
+        result->entries[index].child = child;
+    } else if (child) {
+        // Pull a single remaining document up, so that the trie stays shallow.
+        result->entries[index] = child->entries.first();
+    } else {
+        result->entries.removeAt(index);
+        if (level != LastLevel)
+            result->bitmap &= ~bitForLevel(hash, level);
+        if (result->entries.isEmpty())
+            return NodePtr();
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+const Utils::FilePath &Snapshot::const_iterator::key() const
+{
+    const Position &position = m_path[m_depth - 1];
+    return position.node->entries.at(position.index).fileName;
+}
+
+const Document::Ptr &Snapshot::const_iterator::value() const
+{
+    const Position &position = m_path[m_depth - 1];
+    return position.node->entries.at(position.index).document;
+}
+
+Snapshot::const_iterator &Snapshot::const_iterator::operator++()
+{
+    while (m_depth > 0) {
+        Position &position = m_path[m_depth - 1];
+        if (++position.index < position.node->entries.size()) {
+            descendToDocument();
+            break;
+        }
+        --m_depth;
+    }
+    return *this;
+}
+
+Snapshot::const_iterator Snapshot::const_iterator::operator++(int)
+{
+    const const_iterator previous = *this;
+    operator++();
+    return previous;
+}
+
+bool Snapshot::const_iterator::operator==(const const_iterator &other) const
+{
+    if (m_depth != other.m_depth)
+        return false;
+    if (m_depth == 0)
+        return true;
+    const Position &position = m_path[m_depth - 1];
+    const Position &otherPosition = other.m_path[m_depth - 1];
+    return position.node == otherPosition.node && position.index == otherPosition.index;
+}
+
+void Snapshot::const_iterator::descendToDocument()
+{
+    for (;;) {
+        const Position &position = m_path[m_depth - 1];
+        const SnapshotNode::Entry &entry = position.node->entries.at(position.index);
+        if (!entry.child)
+            return;
+        m_path[m_depth++] = {entry.child.get(), 0};
+    }
+}
+
 Snapshot::Snapshot()
 {
 }
@@ -741,33 +954,81 @@ Snapshot::~Snapshot()
 
 int Snapshot::size() const
 {
-    return _documents.size();
+    return m_size;
 }
 
 bool Snapshot::isEmpty() const
 {
-    return _documents.isEmpty();
+    return m_size == 0;
+}
+
+Snapshot::const_iterator Snapshot::begin() const
+{
+    const_iterator it;
+    if (m_root) {
+        it.m_path[it.m_depth++] = {m_root.get(), 0};
+        it.descendToDocument();
+    }
+    return it;
 }
 
 Snapshot::const_iterator Snapshot::find(const Utils::FilePath &fileName) const
 {
-    return _documents.find(fileName);
+    const uint hash = qHash(fileName);
+    const_iterator it;
+    const SnapshotNode *node = m_root.get();
+    for (int level = 0; node; ++level) {
+        int index = -1;
+        if (level == LastLevel) {
+            for (int i = 0; i < node->entries.size(); ++i) {
+                if (node->entries.at(i).fileName == fileName) {
+                    index = i;
+                    break;
+                }
+            }
+            if (index == -1)
+                return end();
+        } else {
+            const quint32 bit = bitForLevel(hash, level);
+            if (!(node->bitmap & bit))
+                return end();
+            index = entryIndex(node->bitmap, bit);
+        }
+
+        it.m_path[it.m_depth++] = {node, index};
+        const SnapshotNode::Entry &entry = node->entries.at(index);
+        if (!entry.child)
+            return entry.hash == hash && entry.fileName == fileName ? it : end();
+        node = entry.child.get();
+    }
+    return end();
 }
 
 void Snapshot::remove(const Utils::FilePath &fileName)
 {
-    _documents.remove(fileName);
+    if (!m_root)
+        return;
+    bool wasRemoved = false;
+    m_root = removed(m_root, 0, qHash(fileName), fileName, &wasRemoved);
+    if (wasRemoved) {
+        --m_size;
+        m_deps.files.clear(); // Will trigger re-build when accessed.
+    }
 }
 
 bool Snapshot::contains(const Utils::FilePath &fileName) const
 {
-    return _documents.contains(fileName);
+    return findEntry(m_root.get(), qHash(fileName), fileName);
 }
 
 void Snapshot::insert(Document::Ptr doc)
 {
     if (doc) {
-        _documents.insert(Utils::FilePath::fromString(doc->fileName()), doc);
+        const Utils::FilePath fileName = Utils::FilePath::fromString(doc->fileName());
+        bool added = false;
+        m_root = inserted(m_root.get(), 0, {qHash(fileName), fileName, doc, NodePtr()}, &added);
+        if (added)
+            ++m_size;
         m_deps.files.clear(); // Will trigger re-build when accessed.
     }
 }
@@ -887,12 +1148,22 @@ void Snapshot::updateDependencyTable(QFutureInterfaceBase &futureInterface) cons
 
 bool Snapshot::operator==(const Snapshot &other) const
 {
-    return _documents == other._documents;
+    if (m_root == other.m_root)
+        return true;
+    if (m_size != other.m_size)
+        return false;
+    for (const_iterator it = begin(), itEnd = end(); it != itEnd; ++it) {
+        if (other.document(it.key()) != it.value())
+            return false;
+    }
+    return true;
 }
 
 Document::Ptr Snapshot::document(const Utils::FilePath &fileName) const
 {
-    return _documents.value(fileName);
+    if (const SnapshotNode::Entry *entry = findEntry(m_root.get(), qHash(fileName), fileName))
+        return entry->document;
+    return Document::Ptr();
 }
 
 Snapshot Snapshot::simplified(Document::Ptr doc) const
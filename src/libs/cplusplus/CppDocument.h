@@ -39,6 +39,8 @@
 #include <QFileInfo>
 #include <QAtomicInt>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 class QFutureInterfaceBase;
 QT_END_NAMESPACE
@@ -109,6 +111,16 @@ public:
     void setFingerprint(const QByteArray &fingerprint)
     { m_fingerprint = fingerprint; }
 
+    // Fingerprint of the macros and configuration the document was preprocessed with,
+    // or 0 if the document must not be reused based on it.
+    quint64 environmentFingerprint() const { return m_environmentFingerprint; }
+    void setEnvironmentFingerprint(quint64 environmentFingerprint)
+    { m_environmentFingerprint = environmentFingerprint; }
+
+    // Size of the file when it was preprocessed, or -1 if unknown.
+    qint64 fileSize() const { return m_fileSize; }
+    void setFileSize(qint64 fileSize) { m_fileSize = fileSize; }
+
     LanguageFeatures languageFeatures() const;
     void setLanguageFeatures(LanguageFeatures features);
 
@@ -377,6 +389,8 @@ private:
     QByteArray _includeGuardMacroName;
 
     QByteArray m_fingerprint;
+    quint64 m_environmentFingerprint = 0;
+    qint64 m_fileSize = -1;
 
     QByteArray _source;
     QDateTime _lastModified;
@@ -388,16 +402,48 @@ private:
     friend class Snapshot;
 };
 
+namespace Internal { class SnapshotNode; }
+
+// A snapshot is a persistent hash array mapped trie, so copies share their structure and
+// inserting into or removing from a copy only copies the nodes on the path to the document.
 class CPLUSPLUS_EXPORT Snapshot
 {
-    typedef QHash<Utils::FilePath, Document::Ptr> Base;
+    using NodePtr = std::shared_ptr<const Internal::SnapshotNode>;
 
 public:
     Snapshot();
     ~Snapshot();
 
-    typedef Base::const_iterator iterator;
-    typedef Base::const_iterator const_iterator;
+    class CPLUSPLUS_EXPORT const_iterator
+    {
+    public:
+        const Utils::FilePath &key() const;
+        const Document::Ptr &value() const;
+        const Document::Ptr &operator*() const { return value(); }
+        const Document::Ptr *operator->() const { return &value(); }
+
+        const_iterator &operator++();
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const { return !operator==(other); }
+
+    private:
+        friend class Snapshot;
+
+        void descendToDocument();
+
+        enum { MaxDepth = 8 };
+        struct Position
+        {
+            const Internal::SnapshotNode *node;
+            int index;
+        };
+        Position m_path[MaxDepth];
+        int m_depth = 0;
+    };
+
+    typedef const_iterator iterator;
     typedef QPair<Document::Ptr, int> IncludeLocation;
 
     int size() const; // ### remove
@@ -408,8 +454,8 @@ public:
     void remove(const QString &fileName)
     { remove(Utils::FilePath::fromString(fileName)); }
 
-    const_iterator begin() const { return _documents.begin(); }
-    const_iterator end() const { return _documents.end(); }
+    const_iterator begin() const;
+    const_iterator end() const { return const_iterator(); }
 
     bool contains(const Utils::FilePath &fileName) const;
     bool contains(const QString &fileName) const
@@ -453,7 +499,8 @@ public:
 
 private:
     mutable DependencyTable m_deps;
-    Base _documents;
+    NodePtr m_root;
+    int m_size = 0;
 };
 
 } // namespace CPlusPlus
@@ -48,6 +48,7 @@
 #include "Macro.h"
 
 #include <QDebug>
+#include <QHash>
 
 #include <cstring>
 
@@ -63,6 +64,23 @@ static unsigned hashCode(const char *str, int length)
     return hash_value;
 }
 
+static const quint64 initialFingerprint = Q_UINT64_C(14695981039346656037);
+
+static quint64 combineFingerprint(quint64 fingerprint, uint value)
+{
+    return (fingerprint ^ value) * Q_UINT64_C(1099511628211);
+}
+
+static quint64 combineFingerprint(quint64 fingerprint, const Macro &macro)
+{
+    fingerprint = combineFingerprint(fingerprint, qHash(macro.name()));
+    fingerprint = combineFingerprint(fingerprint, qHash(macro.definitionText()));
+    for (const QByteArray &formal : macro.formals())
+        fingerprint = combineFingerprint(fingerprint, qHash(formal));
+    return combineFingerprint(fingerprint, uint(macro.isHidden())
+                                           | uint(macro.isFunctionLike()) << 1
+                                           | uint(macro.isVariadic()) << 2);
+}
 
 Environment::Environment()
     : currentLine(0),
@@ -71,7 +89,8 @@ Environment::Environment()
       _allocated_macros(0),
       _macro_count(-1),
       _hash(nullptr),
-      _hash_count(401)
+      _hash_count(401),
+      _fingerprint(initialFingerprint)
 {
 }
 
@@ -103,6 +122,7 @@ Macro *Environment::bind(const Macro &macro)
     Macro *m = new Macro (macro);
     const QByteArray &name = m->name();
     m->_hashcode = hashCode(name.begin(), name.size());
+    _fingerprint = combineFingerprint(_fingerprint, *m);
 
     if (++_macro_count == _allocated_macros) {
         if (! _allocated_macros)
@@ -158,6 +178,35 @@ void Environment::reset()
     _macro_count = -1;
     _hash = nullptr;
     _hash_count = 401;
+    _fingerprint = initialFingerprint;
+}
+
+Environment::Checkpoint Environment::checkpoint() const
+{
+    Checkpoint checkpoint;
+    checkpoint.macroCount = _macro_count;
+    checkpoint.fingerprint = _fingerprint;
+    return checkpoint;
+}
+
+void Environment::rollback(const Checkpoint &checkpoint)
+{
+    Q_ASSERT(checkpoint.macroCount <= _macro_count);
+    if (checkpoint.macroCount == _macro_count)
+        return;
+
+    qDeleteAll(_macros + checkpoint.macroCount + 1, lastMacro());
+    _macro_count = checkpoint.macroCount;
+    _fingerprint = checkpoint.fingerprint;
+
+    // Rebuild the hash chains without the removed macros, keeping the hash size.
+    memset(_hash, 0, sizeof(Macro *) * _hash_count);
+    for (iterator it = firstMacro(); it != lastMacro(); ++it) {
+        Macro *m = *it;
+        const unsigned h = m->_hashcode % _hash_count;
+        m->_next = _hash[h];
+        _hash[h] = m;
+    }
 }
 
 bool Environment::isBuiltinMacro(const ByteArrayRef &s)
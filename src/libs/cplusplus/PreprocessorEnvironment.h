@@ -79,6 +79,20 @@ public:
     void reset();
     void addMacros(const QList<Macro> &macros);
 
+    // Allows to undo the macros bound after a checkpoint.
+    class Checkpoint
+    {
+        friend class Environment;
+        int macroCount = -1;
+        quint64 fingerprint = 0;
+    };
+    Checkpoint checkpoint() const;
+    void rollback(const Checkpoint &checkpoint);
+
+    // Identifies the sequence of macros bound so far. Equal fingerprints mean equal
+    // environments (up to hash collisions).
+    quint64 fingerprint() const { return _fingerprint; }
+
     static bool isBuiltinMacro(const ByteArrayRef &name);
     void dump() const;
 
@@ -97,6 +111,7 @@ private:
     int _macro_count;
     Macro **_hash;
     int _hash_count;
+    quint64 _fingerprint;
 };
 
 } // namespace CPlusPlus
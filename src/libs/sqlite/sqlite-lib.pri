@@ -21,7 +21,8 @@ SOURCES += \
     $$PWD/utf8string.cpp \
     $$PWD/utf8stringvector.cpp \
     $$PWD/sqlitedatabase.cpp \
-    $$PWD/sqlitebasestatement.cpp
+    $$PWD/sqlitebasestatement.cpp \
+    $$PWD/sqlitereadconnectionpool.cpp
 HEADERS += \
     $$PWD/constraints.h \
     $$PWD/sqliteblob.h \
@@ -33,6 +34,7 @@ HEADERS += \
     $$PWD/sqlitedatabaseinterface.h \
     $$PWD/sqliteexception.h \
     $$PWD/sqliteglobal.h \
+    $$PWD/sqlitereadconnectionpool.h \
     $$PWD/sqlitereadstatement.h \
     $$PWD/sqlitereadwritestatement.h \
     $$PWD/sqlitesessionchangeset.h \
@@ -40,6 +42,7 @@ HEADERS += \
     $$PWD/sqlitetransaction.h \
     $$PWD/sqlitevalue.h \
     $$PWD/sqlitewritestatement.h \
+    $$PWD/sqlitebatchwritestatement.h \
     $$PWD/sqlstatementbuilder.h \
     $$PWD/sqlstatementbuilderexception.h \
     $$PWD/utf8string.h \
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "sqlitewritestatement.h"
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+namespace Sqlite {
+
+// Writes many rows with one step per batch instead of one step per row. The statement
+// has to end with the values of a single row, e.g. "INSERT INTO t(a, b) VALUES(?, ?)",
+// which are repeated to get a multi-row VALUES statement. Rows that do not fill a
+// complete batch are written with the single-row statement.
+class BatchWriteStatement : protected StatementImplementation<BaseStatement, -1>
+{
+    using Base = StatementImplementation<BaseStatement, -1>;
+
+public:
+    BatchWriteStatement(Utils::SmallStringView sqlStatement, Database &database)
+        : Base(batchSqlStatement(sqlStatement), database)
+        , m_rowStatement(sqlStatement, database)
+        , m_columnCount(int(std::count(rowValues(sqlStatement).begin(),
+                                       rowValues(sqlStatement).end(),
+                                       '?')))
+        , m_batchRowCount(batchRowCount(sqlStatement))
+    {
+        if (Base::isReadOnlyStatement())
+            throw NotWriteSqlStatement(
+                "SqliteStatement::BatchWriteStatement: is not a writable statement!");
+    }
+
+    using Base::database;
+
+    // Every element of the range has to be a tuple with a value for every column.
+    template<typename Range>
+    void write(const Range &rows)
+    {
+        write(rows, [](const auto &row) -> const auto & { return row; });
+    }
+
+    // The projection turns an element of the range into a tuple. Text values are bound
+    // without copying until the batch is written, so the tuple must not own them. Use views
+    // into the element instead.
+    template<typename Range, typename Projection>
+    void write(const Range &rows, Projection &&projection)
+    {
+        auto current = std::begin(rows);
+        const auto end = std::end(rows);
+        auto remainingRows = std::distance(current, end);
+
+        try {
+            while (remainingRows >= m_batchRowCount) {
+                for (int row = 0; row < m_batchRowCount; ++row, ++current)
+                    bindRow(row * m_columnCount + 1, projection(*current));
+
+                Base::next();
+                Base::reset();
+                remainingRows -= m_batchRowCount;
+            }
+        } catch (...) {
+            try {
+                Base::reset();
+            } catch (...) {
+            }
+            throw;
+        }
+
+        for (; current != end; ++current) {
+            std::apply([&](const auto &...values) { m_rowStatement.write(values...); },
+                       projection(*current));
+        }
+    }
+
+private:
+    enum {
+        MaximumBatchRowCount = 64,
+        MaximumBindingParameterCount = 999 // SQLITE_MAX_VARIABLE_NUMBER of old SQLite versions
+    };
+
+    template<typename Tuple>
+    void bindRow(int firstIndex, const Tuple &values)
+    {
+        std::apply([&](const auto &...value) {
+            int index = firstIndex;
+            (BaseStatement::bind(index++, value), ...);
+        }, values);
+    }
+
+    static Utils::SmallStringView rowValues(Utils::SmallStringView sqlStatement)
+    {
+        const auto position = sqlStatement.rfind('(');
+        if (position == Utils::SmallStringView::npos)
+            return {};
+
+        return sqlStatement.mid(position);
+    }
+
+    static int batchRowCount(Utils::SmallStringView sqlStatement)
+    {
+        const Utils::SmallStringView values = rowValues(sqlStatement);
+        const int columnCount = std::max(1, int(std::count(values.begin(), values.end(), '?')));
+
+        return std::max(1, std::min(int(MaximumBatchRowCount),
+                                    int(MaximumBindingParameterCount) / columnCount));
+    }
+
+    static Utils::SmallString batchSqlStatement(Utils::SmallStringView sqlStatement)
+    {
+        const Utils::SmallStringView values = rowValues(sqlStatement);
+        const int rowCount = batchRowCount(sqlStatement);
+
+        Utils::SmallString batchStatement{sqlStatement};
+        batchStatement.reserve(sqlStatement.size() + (values.size() + 1) * (rowCount - 1));
+        for (int row = 1; row < rowCount; ++row) {
+            batchStatement.append(",");
+            batchStatement.append(values);
+        }
+
+        return batchStatement;
+    }
+
+private:
+    WriteStatement m_rowStatement;
+    int m_columnCount;
+    int m_batchRowCount;
+};
+
+} // namespace Sqlite
@@ -45,6 +45,7 @@ using namespace std::chrono_literals;
 template<int ResultCount>
 class ReadStatement;
 class WriteStatement;
+class BatchWriteStatement;
 template<int ResultCount>
 class ReadWriteStatement;
 
@@ -59,6 +60,7 @@ public:
     template<int ResultCount>
     using ReadStatement = Sqlite::ReadStatement<ResultCount>;
     using WriteStatement = Sqlite::WriteStatement;
+    using BatchWriteStatement = Sqlite::BatchWriteStatement;
     template<int ResultCount = 0>
     using ReadWriteStatement = Sqlite::ReadWriteStatement<ResultCount>;
     using BusyHandler = DatabaseBackend::BusyHandler;
@@ -170,7 +172,7 @@ private:
     std::vector<Table> m_sqliteTables;
     std::mutex m_databaseMutex;
     std::unique_ptr<Statements> m_statements;
-    std::chrono::milliseconds m_busyTimeout;
+    std::chrono::milliseconds m_busyTimeout{};
     JournalMode m_journalMode = JournalMode::Wal;
     OpenMode m_openMode = OpenMode::ReadWrite;
     bool m_isOpen = false;
@@ -369,14 +369,13 @@ JournalMode DatabaseBackend::pragmaToJournalMode(Utils::SmallStringView pragma)
 
 int DatabaseBackend::openMode(OpenMode mode)
 {
-    int sqliteMode = SQLITE_OPEN_CREATE;
-
+    // SQLITE_OPEN_CREATE is only allowed together with SQLITE_OPEN_READWRITE.
     switch (mode) {
-        case OpenMode::ReadOnly: sqliteMode |= SQLITE_OPEN_READONLY; break;
-        case OpenMode::ReadWrite: sqliteMode |= SQLITE_OPEN_READWRITE; break;
+        case OpenMode::ReadOnly: return SQLITE_OPEN_READONLY;
+        case OpenMode::ReadWrite: return SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
     }
 
-    return sqliteMode;
+    return SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
 }
 
 void DatabaseBackend::setBusyTimeout(std::chrono::milliseconds timeout)
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "sqlitereadconnectionpool.h"
+
+#include <algorithm>
+
+namespace Sqlite {
+
+ReadConnectionPool::Connection::~Connection()
+{
+    if (m_pool)
+        m_pool->release(m_index);
+}
+
+ReadConnectionPool::Connection::Connection(Connection &&other) noexcept
+    : m_pool(other.m_pool)
+    , m_index(other.m_index)
+{
+    other.m_pool = nullptr;
+}
+
+ReadConnectionPool::ReadConnectionPool(Utils::PathString databaseFilePath,
+                                       std::size_t connectionCount)
+{
+    connectionCount = std::max<std::size_t>(1, connectionCount);
+    m_connections.reserve(connectionCount);
+    m_idleConnections.reserve(connectionCount);
+
+    for (std::size_t index = 0; index < connectionCount; ++index) {
+        auto database = std::make_unique<Database>();
+        database->setOpenMode(OpenMode::ReadOnly);
+        database->setJournalMode(JournalMode::Wal);
+        database->open(Utils::PathString{databaseFilePath});
+
+        m_connections.push_back(std::move(database));
+        m_idleConnections.push_back(index);
+    }
+}
+
+ReadConnectionPool::~ReadConnectionPool() = default;
+
+ReadConnectionPool::Connection ReadConnectionPool::acquire()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_connectionReleased.wait(lock, [&] { return !m_idleConnections.empty(); });
+
+    const std::size_t index = m_idleConnections.back();
+    m_idleConnections.pop_back();
+
+    return Connection{*this, index};
+}
+
+void ReadConnectionPool::release(std::size_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_idleConnections.push_back(index);
+    }
+
+    m_connectionReleased.notify_one();
+}
+
+} // namespace Sqlite
@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "sqlitedatabase.h"
+#include "sqlitereadstatement.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Sqlite {
+
+template<int ResultCount>
+class PooledReadStatement;
+
+// Read-only connections to a database in WAL mode. A reader works on the snapshot of the
+// database at the start of its read transaction and is neither blocked by the writer
+// connection nor does it block the writer, so queries can run in parallel with writes
+// and with each other.
+class SQLITE_EXPORT ReadConnectionPool
+{
+public:
+    template<int ResultCount>
+    using ReadStatement = PooledReadStatement<ResultCount>;
+
+    class SQLITE_EXPORT Connection
+    {
+    public:
+        Connection(ReadConnectionPool &pool, std::size_t index)
+            : m_pool(&pool)
+            , m_index(index)
+        {}
+        ~Connection();
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+        Connection(Connection &&other) noexcept;
+        Connection &operator=(Connection &&other) = delete;
+
+        Database &database() const { return *m_pool->m_connections[m_index]; }
+        std::size_t index() const { return m_index; }
+
+    private:
+        ReadConnectionPool *m_pool;
+        std::size_t m_index;
+    };
+
+    // The database has to exist already and has to be in WAL mode.
+    ReadConnectionPool(Utils::PathString databaseFilePath, std::size_t connectionCount);
+    ~ReadConnectionPool();
+
+    ReadConnectionPool(const ReadConnectionPool &) = delete;
+    ReadConnectionPool &operator=(const ReadConnectionPool &) = delete;
+
+    // Blocks until a connection is idle.
+    Connection acquire();
+
+    std::size_t size() const { return m_connections.size(); }
+
+private:
+    void release(std::size_t index);
+
+private:
+    std::vector<std::unique_ptr<Database>> m_connections;
+    std::vector<std::size_t> m_idleConnections;
+    std::mutex m_mutex;
+    std::condition_variable m_connectionReleased;
+};
+
+// A read statement that is prepared once per pool connection and runs every query on an
+// idle connection of the pool.
+template<int ResultCount>
+class PooledReadStatement
+{
+    using Statement = ReadStatement<ResultCount>;
+
+public:
+    PooledReadStatement(Utils::SmallStringView sqlStatement, ReadConnectionPool &pool)
+        : m_sqlStatement(sqlStatement)
+        , m_pool(pool)
+        , m_statements(pool.size())
+    {
+        // Prepare once right away to report errors in the statement early.
+        auto connection = m_pool.acquire();
+        statement(connection);
+    }
+
+    template<typename ResultType, typename... QueryTypes>
+    auto values(std::size_t reserveSize, const QueryTypes &...queryValues)
+    {
+        auto connection = m_pool.acquire();
+        return statement(connection).template values<ResultType>(reserveSize, queryValues...);
+    }
+
+    template<typename ResultType, typename... QueryTypes>
+    auto value(const QueryTypes &...queryValues)
+    {
+        auto connection = m_pool.acquire();
+        return statement(connection).template value<ResultType>(queryValues...);
+    }
+
+    template<typename Callable, typename... QueryTypes>
+    void readCallback(Callable &&callable, const QueryTypes &...queryValues)
+    {
+        auto connection = m_pool.acquire();
+        statement(connection).readCallback(std::forward<Callable>(callable), queryValues...);
+    }
+
+    template<int ResultTypeCount = 1, typename Container, typename... QueryTypes>
+    void readTo(Container &container, const QueryTypes &...queryValues)
+    {
+        auto connection = m_pool.acquire();
+        statement(connection).template readTo<ResultTypeCount>(container, queryValues...);
+    }
+
+private:
+    // Only the holder of the connection touches its slot, so no further locking is needed.
+    Statement &statement(const ReadConnectionPool::Connection &connection)
+    {
+        std::unique_ptr<Statement> &statement = m_statements[connection.index()];
+        if (!statement)
+            statement = std::make_unique<Statement>(m_sqlStatement, connection.database());
+
+        return *statement;
+    }
+
+private:
+    Utils::SmallString m_sqlStatement;
+    ReadConnectionPool &m_pool;
+    std::vector<std::unique_ptr<Statement>> m_statements;
+};
+
+} // namespace Sqlite
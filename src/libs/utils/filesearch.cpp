@@ -30,13 +30,16 @@
 #include "mapreduce.h"
 #include "qtcassert.h"
 #include "stringutils.h"
+#include "trigramindex.h"
 
 #include <QCoreApplication>
 #include <QMutex>
 #include <QRegularExpression>
 #include <QTextCodec>
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 
 using namespace Utils;
 
@@ -84,16 +87,167 @@ bool getFileContent(const QString &filePath,
     return true;
 }
 
+const int utf8MibEnum = 106;
+const int latin1MibEnum = 4;
+
+char toLowerAscii(char character)
+{
+    return character >= 'A' && character <= 'Z' ? char(character - 'A' + 'a') : character;
+}
+
+char toUpperAscii(char character)
+{
+    return character >= 'a' && character <= 'z' ? char(character - 'a' + 'A') : character;
+}
+
+// QTextStream::readLine() does not end a line at a single carriage return, the byte search
+// would report other line numbers for such files.
+bool hasLoneCarriageReturn(const char *begin, const char *end)
+{
+    for (const char *current = begin; current != end; ++current) {
+        current = static_cast<const char *>(std::memchr(current, '\r', end - current));
+        if (!current)
+            return false;
+        if (current + 1 == end || current[1] != '\n')
+            return true;
+    }
+
+    return false;
+}
+
+// memchr() is vectorized by the C library. The first byte is searched with it and the last
+// byte is checked before the full comparison.
+const char *findBytes(const char *begin, const char *end, const QByteArray &term)
+{
+    const std::ptrdiff_t length = term.size();
+    const char first = term.front();
+    const char last = term.back();
+
+    for (const char *current = begin; end - current >= length; ++current) {
+        current = static_cast<const char *>(std::memchr(current, first, end - current - length + 1));
+        if (!current)
+            return end;
+        if (current[length - 1] == last && std::memcmp(current + 1, term.constData() + 1, length - 1) == 0)
+            return current;
+    }
+
+    return end;
+}
+
+const char *findBytesIgnoringAsciiCase(const char *begin, const char *end, const QByteArray &term)
+{
+    const std::ptrdiff_t length = term.size();
+    const char lowerFirst = toLowerAscii(term.front());
+    const char upperFirst = toUpperAscii(term.front());
+    const char lowerLast = toLowerAscii(term.back());
+
+    auto next = [&](const char *from, char character) {
+        const std::ptrdiff_t range = end - from - length + 1;
+        auto found = range > 0 ? static_cast<const char *>(std::memchr(from, character, range))
+                               : nullptr;
+        return found ? found : end;
+    };
+
+    const char *nextLower = next(begin, lowerFirst);
+    const char *nextUpper = lowerFirst == upperFirst ? end : next(begin, upperFirst);
+
+    while (true) {
+        const char *current = std::min(nextLower, nextUpper);
+        if (current == end)
+            return end;
+
+        auto equalIgnoringCase = [&] {
+            if (toLowerAscii(current[length - 1]) != lowerLast)
+                return false;
+            for (std::ptrdiff_t index = 1; index < length - 1; ++index) {
+                if (toLowerAscii(current[index]) != toLowerAscii(term.at(int(index))))
+                    return false;
+            }
+            return true;
+        };
+
+        if (equalIgnoringCase())
+            return current;
+
+        if (current == nextLower)
+            nextLower = next(current + 1, lowerFirst);
+        else
+            nextUpper = next(current + 1, upperFirst);
+    }
+}
+
+class IndexedFiles
+{
+public:
+    IndexedFiles(TrigramIndex *index, const QString &searchTerm, bool isRegExp)
+        : index(index)
+        , candidateFilter(index ? index->candidateFilter(searchTerm, isRegExp)
+                                : TrigramIndex::FileFilter())
+    {}
+
+    bool cannotMatch(const QString &filePath,
+                     const QMap<QString, QString> &fileToContentsMap) const
+    {
+        return candidateFilter && !fileToContentsMap.contains(filePath)
+               && !candidateFilter(filePath);
+    }
+
+    bool needsContent(const QString &filePath) const
+    {
+        return index && !index->isIndexed(filePath);
+    }
+
+    // Taken before the file is read, so that changes while reading are noticed.
+    TrigramIndex::FileStamp stamp(const QString &filePath,
+                                  const QMap<QString, QString> &fileToContentsMap) const
+    {
+        if (!index || fileToContentsMap.contains(filePath))
+            return {};
+
+        return TrigramIndex::FileStamp::fromFile(filePath);
+    }
+
+    void add(const QString &filePath,
+             const QString &content,
+             const TrigramIndex::FileStamp &stamp) const
+    {
+        if (stamp.isValid())
+            index->addFile(filePath, content, stamp);
+    }
+
+private:
+    TrigramIndex *index;
+    TrigramIndex::FileFilter candidateFilter;
+};
+
+void reportNoMatches(QFutureInterface<FileSearchResultList> &futureInterface)
+{
+    futureInterface.reportResult(FileSearchResultList());
+    futureInterface.setProgressValue(1);
+}
+
 class FileSearch
 {
 public:
     FileSearch(const QString &searchTerm, QTextDocument::FindFlags flags,
-               const QMap<QString, QString> &fileToContentsMap);
+               const QMap<QString, QString> &fileToContentsMap, TrigramIndex *index);
     void operator()(QFutureInterface<FileSearchResultList> &futureInterface,
                     const FileIterator::Item &item) const;
 
 private:
+    void searchLine(const QString &chunk,
+                    int lineNr,
+                    const QString &filePath,
+                    FileSearchResultList &results) const;
+    QByteArray byteSearchTerm(QTextCodec *encoding) const;
+    bool searchFileBytes(QFutureInterface<FileSearchResultList> &futureInterface,
+                         const FileIterator::Item &item,
+                         FileSearchResultList &results) const;
+
     QMap<QString, QString> fileToContentsMap;
+    IndexedFiles indexedFiles;
+    QByteArray searchTermUtf8;
+    QByteArray searchTermLatin1;
     QString searchTermLower;
     QString searchTermUpper;
     int termMaxIndex;
@@ -102,13 +256,14 @@ private:
     const QChar *termDataUpper;
     bool caseSensitive;
     bool wholeWord;
+    bool termIsAscii = true;
 };
 
 class FileSearchRegExp
 {
 public:
     FileSearchRegExp(const QString &searchTerm, QTextDocument::FindFlags flags,
-                     const QMap<QString, QString> &fileToContentsMap);
+                     const QMap<QString, QString> &fileToContentsMap, TrigramIndex *index);
     FileSearchRegExp(const FileSearchRegExp &other);
     void operator()(QFutureInterface<FileSearchResultList> &futureInterface,
                     const FileIterator::Item &item) const;
@@ -117,12 +272,14 @@ private:
     QRegularExpressionMatch doGuardedMatch(const QString &line, int offset) const;
 
     QMap<QString, QString> fileToContentsMap;
+    IndexedFiles indexedFiles;
     QRegularExpression expression;
     mutable QMutex mutex;
 };
 
 FileSearch::FileSearch(const QString &searchTerm, QTextDocument::FindFlags flags,
-                       const QMap<QString, QString> &fileToContentsMap)
+                       const QMap<QString, QString> &fileToContentsMap, TrigramIndex *index)
+    : indexedFiles(index, searchTerm, false)
 {
     this->fileToContentsMap = fileToContentsMap;
     caseSensitive = (flags & QTextDocument::FindCaseSensitively);
@@ -133,6 +290,17 @@ FileSearch::FileSearch(const QString &searchTerm, QTextDocument::FindFlags flags
     termData = searchTerm.constData();
     termDataLower = searchTermLower.constData();
     termDataUpper = searchTermUpper.constData();
+
+    bool termIsLatin1 = true;
+    for (const QChar character : searchTerm) {
+        termIsAscii = termIsAscii && character.unicode() < 0x80;
+        termIsLatin1 = termIsLatin1 && character.unicode() < 0x100;
+    }
+    searchTermUtf8 = searchTerm.toUtf8();
+    if (QString::fromUtf8(searchTermUtf8) != searchTerm)
+        searchTermUtf8.clear();
+    if (termIsLatin1)
+        searchTermLatin1 = searchTerm.toLatin1();
 }
 
 void FileSearch::operator()(QFutureInterface<FileSearchResultList> &futureInterface,
@@ -142,90 +310,194 @@ void FileSearch::operator()(QFutureInterface<FileSearchResultList> &futureInterf
         return;
     futureInterface.setProgressRange(0, 1);
     futureInterface.setProgressValue(0);
-    FileSearchResultList results;
-    QString tempString;
-    if (!getFileContent(item.filePath, item.encoding, &tempString, fileToContentsMap)) {
-        futureInterface.cancel(); // failure
+    if (indexedFiles.cannotMatch(item.filePath, fileToContentsMap)) {
+        reportNoMatches(futureInterface);
         return;
     }
-    QTextStream stream(&tempString);
-    int lineNr = 0;
+    FileSearchResultList results;
+    if (!searchFileBytes(futureInterface, item, results)) {
+        QString tempString;
+        const TrigramIndex::FileStamp stamp = indexedFiles.stamp(item.filePath, fileToContentsMap);
+        if (!getFileContent(item.filePath, item.encoding, &tempString, fileToContentsMap)) {
+            futureInterface.cancel(); // failure
+            return;
+        }
+        indexedFiles.add(item.filePath, tempString, stamp);
+        QTextStream stream(&tempString);
+        int lineNr = 0;
+
+        while (!stream.atEnd()) {
+            ++lineNr;
+            searchLine(stream.readLine(), lineNr, item.filePath, results);
+            if (futureInterface.isPaused())
+                futureInterface.waitForResume();
+            if (futureInterface.isCanceled())
+                break;
+        }
+    }
+    if (!futureInterface.isCanceled()) {
+        futureInterface.reportResult(results);
+        futureInterface.setProgressValue(1);
+    }
+}
 
-    while (!stream.atEnd()) {
-        ++lineNr;
-        const QString chunk = stream.readLine();
-        const QString resultItemText = clippedText(chunk, MAX_LINE_SIZE);
-        int chunkLength = chunk.length();
-        const QChar *chunkPtr = chunk.constData();
-        const QChar *chunkEnd = chunkPtr + chunkLength - 1;
-        for (const QChar *regionPtr = chunkPtr; regionPtr + termMaxIndex <= chunkEnd; ++regionPtr) {
-            const QChar *regionEnd = regionPtr + termMaxIndex;
-            if ( /* optimization check for start and end of region */
-                    // case sensitive
-                    (caseSensitive && *regionPtr == termData[0]
-                     && *regionEnd == termData[termMaxIndex])
-                    ||
-                    // case insensitive
-                    (!caseSensitive && (*regionPtr == termDataLower[0]
-                                        || *regionPtr == termDataUpper[0])
-                     && (*regionEnd == termDataLower[termMaxIndex]
-                         || *regionEnd == termDataUpper[termMaxIndex]))
-                     ) {
-                bool equal = true;
-
-                // whole word check
-                const QChar *beforeRegion = regionPtr - 1;
-                const QChar *afterRegion = regionEnd + 1;
-                if (wholeWord
-                        && (((beforeRegion >= chunkPtr)
-                             && (beforeRegion->isLetterOrNumber()
-                                 || ((*beforeRegion) == QLatin1Char('_'))))
-                            ||
-                            ((afterRegion <= chunkEnd)
-                             && (afterRegion->isLetterOrNumber()
-                                 || ((*afterRegion) == QLatin1Char('_'))))
-                            )) {
-                    equal = false;
-                } else {
-                    // check all chars
-                    int regionIndex = 1;
-                    for (const QChar *regionCursor = regionPtr + 1;
-                         regionCursor < regionEnd;
-                         ++regionCursor, ++regionIndex) {
-                        if (  // case sensitive
-                              (caseSensitive
-                               && *regionCursor != termData[regionIndex])
-                              ||
-                              // case insensitive
-                              (!caseSensitive
-                               && *regionCursor != termDataLower[regionIndex]
-                               && *regionCursor != termDataUpper[regionIndex])
-                              ) {
-                            equal = false;
-                        }
+void FileSearch::searchLine(const QString &chunk,
+                            int lineNr,
+                            const QString &filePath,
+                            FileSearchResultList &results) const
+{
+    const QString resultItemText = clippedText(chunk, MAX_LINE_SIZE);
+    int chunkLength = chunk.length();
+    const QChar *chunkPtr = chunk.constData();
+    const QChar *chunkEnd = chunkPtr + chunkLength - 1;
+    for (const QChar *regionPtr = chunkPtr; regionPtr + termMaxIndex <= chunkEnd; ++regionPtr) {
+        const QChar *regionEnd = regionPtr + termMaxIndex;
+        if ( /* optimization check for start and end of region */
+                // case sensitive
+                (caseSensitive && *regionPtr == termData[0]
+                 && *regionEnd == termData[termMaxIndex])
+                ||
+                // case insensitive
+                (!caseSensitive && (*regionPtr == termDataLower[0]
+                                    || *regionPtr == termDataUpper[0])
+                 && (*regionEnd == termDataLower[termMaxIndex]
+                     || *regionEnd == termDataUpper[termMaxIndex]))
+                 ) {
+            bool equal = true;
+
+            // whole word check
+            const QChar *beforeRegion = regionPtr - 1;
+            const QChar *afterRegion = regionEnd + 1;
+            if (wholeWord
+                    && (((beforeRegion >= chunkPtr)
+                         && (beforeRegion->isLetterOrNumber()
+                             || ((*beforeRegion) == QLatin1Char('_'))))
+                        ||
+                        ((afterRegion <= chunkEnd)
+                         && (afterRegion->isLetterOrNumber()
+                             || ((*afterRegion) == QLatin1Char('_'))))
+                        )) {
+                equal = false;
+            } else {
+                // check all chars
+                int regionIndex = 1;
+                for (const QChar *regionCursor = regionPtr + 1;
+                     regionCursor < regionEnd;
+                     ++regionCursor, ++regionIndex) {
+                    if (  // case sensitive
+                          (caseSensitive
+                           && *regionCursor != termData[regionIndex])
+                          ||
+                          // case insensitive
+                          (!caseSensitive
+                           && *regionCursor != termDataLower[regionIndex]
+                           && *regionCursor != termDataUpper[regionIndex])
+                          ) {
+                        equal = false;
                     }
                 }
-                if (equal) {
-                    results << FileSearchResult(item.filePath, lineNr, resultItemText,
-                                                regionPtr - chunkPtr, termMaxIndex + 1,
-                                                QStringList());
-                    regionPtr += termMaxIndex; // another +1 done by for-loop
-                }
             }
+            if (equal) {
+                results << FileSearchResult(filePath, lineNr, resultItemText,
+                                            regionPtr - chunkPtr, termMaxIndex + 1,
+                                            QStringList());
+                regionPtr += termMaxIndex; // another +1 done by for-loop
+            }
+        }
+    }
+}
+
+QByteArray FileSearch::byteSearchTerm(QTextCodec *encoding) const
+{
+    if (!encoding || (!caseSensitive && !termIsAscii))
+        return {};
+
+    switch (encoding->mibEnum()) {
+    case utf8MibEnum:
+        return searchTermUtf8;
+    case latin1MibEnum:
+        return searchTermLatin1;
+    }
+
+    return {};
+}
+
+// Searches the raw bytes of UTF-8 and Latin-1 files and only decodes the lines with a byte
+// match. Those lines go through searchLine(), so the results are the same as for the decoded
+// file. Returns false if the file needs the decoding path.
+bool FileSearch::searchFileBytes(QFutureInterface<FileSearchResultList> &futureInterface,
+                                 const FileIterator::Item &item,
+                                 FileSearchResultList &results) const
+{
+    if (fileToContentsMap.contains(item.filePath) || indexedFiles.needsContent(item.filePath))
+        return false;
+
+    const QByteArray term = byteSearchTerm(item.encoding);
+    if (term.isEmpty())
+        return false;
+
+    QFile file(item.filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QByteArray content;
+    const char *data = nullptr;
+    qint64 size = file.size();
+    if (size > 0) {
+        if (const uchar *mapped = file.map(0, size)) {
+            data = reinterpret_cast<const char *>(mapped);
+        } else {
+            content = file.readAll();
+            data = content.constData();
+            size = content.size();
         }
+    }
+
+    const char *end = data + size;
+    if (hasLoneCarriageReturn(data, end))
+        return false;
+
+    const char *position = data;
+    const char *countedPosition = data;
+    int lineNr = 1;
+
+    while (position != end) {
+        const char *match = caseSensitive ? findBytes(position, end, term)
+                                          : findBytesIgnoringAsciiCase(position, end, term);
+        if (match == end)
+            break;
+
+        const char *lineStart = match;
+        while (lineStart != position && lineStart[-1] != '\n')
+            --lineStart;
+        const char *lineEnd = static_cast<const char *>(std::memchr(match, '\n', end - match));
+        if (!lineEnd)
+            lineEnd = end;
+        const char *textEnd = lineEnd != lineStart && lineEnd[-1] == '\r' ? lineEnd - 1 : lineEnd;
+
+        lineNr += int(std::count(countedPosition, lineStart, '\n'));
+        countedPosition = lineStart;
+
+        searchLine(item.encoding->toUnicode(lineStart, int(textEnd - lineStart)),
+                   lineNr,
+                   item.filePath,
+                   results);
+
         if (futureInterface.isPaused())
             futureInterface.waitForResume();
         if (futureInterface.isCanceled())
             break;
+
+        position = lineEnd == end ? end : lineEnd + 1;
     }
-    if (!futureInterface.isCanceled()) {
-        futureInterface.reportResult(results);
-        futureInterface.setProgressValue(1);
-    }
+
+    return true;
 }
 
 FileSearchRegExp::FileSearchRegExp(const QString &searchTerm, QTextDocument::FindFlags flags,
-                                   const QMap<QString, QString> &fileToContentsMap)
+                                   const QMap<QString, QString> &fileToContentsMap,
+                                   TrigramIndex *index)
+    : indexedFiles(index, searchTerm, true)
 {
     this->fileToContentsMap = fileToContentsMap;
     QString term = searchTerm;
@@ -238,6 +510,7 @@ FileSearchRegExp::FileSearchRegExp(const QString &searchTerm, QTextDocument::Fin
 
 FileSearchRegExp::FileSearchRegExp(const FileSearchRegExp &other)
     : fileToContentsMap(other.fileToContentsMap),
+      indexedFiles(other.indexedFiles),
       expression(other.expression)
 {
 }
@@ -259,12 +532,18 @@ void FileSearchRegExp::operator()(QFutureInterface<FileSearchResultList> &future
         return;
     futureInterface.setProgressRange(0, 1);
     futureInterface.setProgressValue(0);
+    if (indexedFiles.cannotMatch(item.filePath, fileToContentsMap)) {
+        reportNoMatches(futureInterface);
+        return;
+    }
     FileSearchResultList results;
     QString tempString;
+    const TrigramIndex::FileStamp stamp = indexedFiles.stamp(item.filePath, fileToContentsMap);
     if (!getFileContent(item.filePath, item.encoding, &tempString, fileToContentsMap)) {
         futureInterface.cancel(); // failure
         return;
     }
+    indexedFiles.add(item.filePath, tempString, stamp);
     QTextStream stream(&tempString);
     int lineNr = 0;
 
@@ -361,25 +640,27 @@ void cleanUpFileSearch(QFutureInterface<FileSearchResultList> &futureInterface,
 } // namespace
 
 QFuture<FileSearchResultList> Utils::findInFiles(const QString &searchTerm, FileIterator *files,
-    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap)
+    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap,
+    TrigramIndex *index)
 {
     return mapReduce(files->begin(), files->end(),
                      [searchTerm, files](QFutureInterface<FileSearchResultList> &futureInterface) {
                          return initFileSearch(futureInterface, searchTerm, files);
                      },
-                     FileSearch(searchTerm, flags, fileToContentsMap),
+                     FileSearch(searchTerm, flags, fileToContentsMap, index),
                      &collectSearchResults,
                      &cleanUpFileSearch);
 }
 
 QFuture<FileSearchResultList> Utils::findInFilesRegExp(const QString &searchTerm, FileIterator *files,
-    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap)
+    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap,
+    TrigramIndex *index)
 {
     return mapReduce(files->begin(), files->end(),
                      [searchTerm, files](QFutureInterface<FileSearchResultList> &futureInterface) {
                          return initFileSearch(futureInterface, searchTerm, files);
                      },
-                     FileSearchRegExp(searchTerm, flags, fileToContentsMap),
+                     FileSearchRegExp(searchTerm, flags, fileToContentsMap, index),
                      &collectSearchResults,
                      &cleanUpFileSearch);
 }
@@ -39,6 +39,8 @@ QT_FORWARD_DECLARE_CLASS(QTextCodec)
 
 namespace Utils {
 
+class TrigramIndex;
+
 QTCREATOR_UTILS_EXPORT
 std::function<bool(const QString &)>
 filterFileFunction(const QStringList &filterRegs, const QStringList &exclusionRegs);
@@ -192,11 +194,14 @@ public:
 
 using FileSearchResultList = QList<FileSearchResult>;
 
+// If an index is given, files it rules out are not read and files read from disk are added to it.
 QTCREATOR_UTILS_EXPORT QFuture<FileSearchResultList> findInFiles(const QString &searchTerm, FileIterator *files,
-    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap = QMap<QString, QString>());
+    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap = QMap<QString, QString>(),
+    TrigramIndex *index = nullptr);
 
 QTCREATOR_UTILS_EXPORT QFuture<FileSearchResultList> findInFilesRegExp(const QString &searchTerm, FileIterator *files,
-    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap = QMap<QString, QString>());
+    QTextDocument::FindFlags flags, const QMap<QString, QString> &fileToContentsMap = QMap<QString, QString>(),
+    TrigramIndex *index = nullptr);
 
 QTCREATOR_UTILS_EXPORT QString expandRegExpReplacement(const QString &replaceText, const QStringList &capturedTexts);
 QTCREATOR_UTILS_EXPORT QString matchCaseReplacement(const QString &originalText, const QString &replaceText);
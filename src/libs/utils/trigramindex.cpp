@@ -0,0 +1,518 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "trigramindex.h"
+
+#include "qtcassert.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <unordered_set>
+
+namespace Utils {
+
+namespace {
+
+const quint32 indexMagic = 0x54524731; // "TRG1"
+const qint32 indexVersion = 2;
+const int minimumRemovedFilesForCompaction = 1024;
+
+// Only trigrams of case folded ASCII characters are indexed. A case insensitive match of any
+// other character is not guaranteed to fold to the same character.
+bool isIndexable(QChar character)
+{
+    return character.unicode() < 0x80 && character != '\n' && character != '\r';
+}
+
+quint64 trigram(QChar first, QChar second, QChar third)
+{
+    return (quint64(first.unicode()) << 32) | (quint64(second.unicode()) << 16)
+           | quint64(third.unicode());
+}
+
+template<typename Callback>
+void forEachTrigram(const QString &text, Callback callback)
+{
+    QChar first;
+    QChar second;
+    int indexableCount = 0;
+
+    for (const QChar character : text) {
+        const QChar folded = character.toCaseFolded();
+        if (!isIndexable(folded)) {
+            indexableCount = 0;
+            continue;
+        }
+
+        if (++indexableCount >= 3)
+            callback(trigram(first, second, folded));
+
+        first = second;
+        second = folded;
+    }
+}
+
+void addTrigrams(const QString &literal, QVector<quint64> &trigrams)
+{
+    forEachTrigram(literal, [&](quint64 trigram) {
+        if (!trigrams.contains(trigram))
+            trigrams.append(trigram);
+    });
+}
+
+bool isBreakingEscape(QChar character)
+{
+    return QStringLiteral("wWdDsSbBntrfv").contains(character);
+}
+
+bool isAllowedGroupPrefix(QChar character)
+{
+    return character == ':' || character == '=' || character == '!' || character == '<';
+}
+
+// Collects the trigrams of the literal runs outside of groups. Patterns with alternations or
+// escapes which could stand for arbitrary characters give no trigrams at all.
+QVector<quint64> regExpTrigrams(const QString &pattern)
+{
+    QVector<quint64> trigrams;
+    QString run;
+    int depth = 0;
+
+    auto endRun = [&] {
+        if (depth == 0)
+            addTrigrams(run, trigrams);
+        run.clear();
+    };
+
+    for (int index = 0; index < pattern.size(); ++index) {
+        const QChar character = pattern.at(index);
+
+        switch (character.unicode()) {
+        case '|':
+            return {};
+        case '\\': {
+            if (++index >= pattern.size())
+                return {};
+            const QChar escaped = pattern.at(index);
+            if (escaped.isLetterOrNumber()) {
+                if (!isBreakingEscape(escaped))
+                    return {};
+                endRun();
+            } else if (depth == 0) {
+                run.append(escaped);
+            }
+            break;
+        }
+        case '?':
+        case '*':
+            run.chop(1);
+            endRun();
+            break;
+        case '{':
+            run.chop(1);
+            endRun();
+            while (index < pattern.size() && pattern.at(index) != '}')
+                ++index;
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            endRun();
+            break;
+        case '(':
+            if (index + 1 < pattern.size() && pattern.at(index + 1) == '?'
+                && (index + 2 >= pattern.size() || !isAllowedGroupPrefix(pattern.at(index + 2)))) {
+                return {};
+            }
+            endRun();
+            ++depth;
+            break;
+        case ')':
+            endRun();
+            depth = std::max(0, depth - 1);
+            break;
+        case '[': {
+            endRun();
+            int end = index + 1;
+            if (end < pattern.size() && pattern.at(end) == '^')
+                ++end;
+            if (end < pattern.size() && pattern.at(end) == ']')
+                ++end;
+            while (end < pattern.size() && pattern.at(end) != ']') {
+                if (pattern.at(end) == '\\')
+                    ++end;
+                ++end;
+            }
+            index = end;
+            break;
+        }
+        default:
+            if (depth == 0)
+                run.append(character);
+            break;
+        }
+    }
+
+    endRun();
+
+    return trigrams;
+}
+
+} // namespace
+
+TrigramIndex::FileStamp TrigramIndex::FileStamp::fromFile(const QString &filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    FileStamp stamp;
+
+    if (fileInfo.exists()) {
+        stamp.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+        stamp.statusChanged = fileInfo.metadataChangeTime().toMSecsSinceEpoch();
+        stamp.size = fileInfo.size();
+    }
+
+    return stamp;
+}
+
+TrigramIndex::TrigramIndex(QObject *parent)
+    : QObject(parent)
+{}
+
+TrigramIndex::~TrigramIndex() = default;
+
+void TrigramIndex::addFile(const QString &filePath, const QString &content, const FileStamp &stamp)
+{
+    if (!stamp.isValid())
+        return;
+
+    {
+        QReadLocker locker(&m_lock);
+
+        const int id = m_fileIds.value(filePath, -1);
+        if (id >= 0 && m_files.at(id).stamp == stamp)
+            return;
+    }
+
+    std::unordered_set<quint64> trigrams;
+    forEachTrigram(content, [&](quint64 trigram) { trigrams.insert(trigram); });
+
+    const bool isUnchangedSinceReading = FileStamp::fromFile(filePath) == stamp;
+
+    QWriteLocker locker(&m_lock);
+
+    const int oldId = m_fileIds.value(filePath, -1);
+    if (oldId >= 0) {
+        if (m_files.at(oldId).stamp == stamp)
+            return;
+        removeFileUnlocked(filePath);
+    }
+
+    if (!isUnchangedSinceReading)
+        return;
+
+    FileEntry entry;
+    entry.filePath = filePath;
+    entry.stamp = stamp;
+
+    const int id = m_files.size();
+    m_files.append(entry);
+    m_fileIds.insert(filePath, id);
+
+    for (quint64 trigram : trigrams)
+        m_postings[trigram].push_back(id);
+    m_isModified = true;
+
+    if (m_removedFileCount > minimumRemovedFilesForCompaction
+        && m_removedFileCount > m_files.size() / 2) {
+        compactUnlocked();
+    }
+}
+
+void TrigramIndex::removeFile(const QString &filePath)
+{
+    QWriteLocker locker(&m_lock);
+
+    removeFileUnlocked(filePath);
+}
+
+bool TrigramIndex::isIndexed(const QString &filePath) const
+{
+    QReadLocker locker(&m_lock);
+
+    return m_fileIds.contains(filePath);
+}
+
+int TrigramIndex::fileCount() const
+{
+    QReadLocker locker(&m_lock);
+
+    return m_fileIds.size();
+}
+
+bool TrigramIndex::isModified() const
+{
+    return m_isModified;
+}
+
+TrigramIndex::FileFilter TrigramIndex::candidateFilter(const QString &searchTerm,
+                                                       bool isRegExp) const
+{
+    const QVector<quint64> trigrams = requiredTrigrams(searchTerm, isRegExp);
+    if (trigrams.isEmpty())
+        return {};
+
+    QReadLocker locker(&m_lock);
+
+    std::vector<const FileIds *> postings;
+    postings.reserve(trigrams.size());
+    for (quint64 trigram : trigrams) {
+        auto found = m_postings.find(trigram);
+        if (found == m_postings.end()) {
+            postings.clear();
+            break;
+        }
+        postings.push_back(&found->second);
+    }
+
+    auto candidates = std::make_shared<FileIds>();
+    if (!postings.empty()) {
+        std::sort(postings.begin(), postings.end(), [](const FileIds *first, const FileIds *second) {
+            return first->size() < second->size();
+        });
+
+        *candidates = *postings.front();
+        FileIds intersection;
+        for (auto current = std::next(postings.begin()); current != postings.end(); ++current) {
+            intersection.clear();
+            std::set_intersection(candidates->begin(), candidates->end(),
+                                  (*current)->begin(), (*current)->end(),
+                                  std::back_inserter(intersection));
+            candidates->swap(intersection);
+        }
+    }
+
+    const int generation = m_generation;
+    const int firstNewFileId = m_files.size();
+
+    return [this, candidates, generation, firstNewFileId](const QString &filePath) {
+        FileEntry entry;
+        {
+            QReadLocker locker(&m_lock);
+
+            if (generation != m_generation)
+                return true;
+
+            const int id = m_fileIds.value(filePath, -1);
+            if (id < 0 || id >= firstNewFileId)
+                return true;
+
+            if (std::binary_search(candidates->begin(), candidates->end(), id))
+                return true;
+
+            entry = m_files.at(id);
+        }
+
+        return entry.isRemoved || !isUnchanged(entry);
+    };
+}
+
+bool TrigramIndex::load(const QString &indexFilePath)
+{
+    QFile file(indexFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    qint32 version = 0;
+    stream >> magic >> version;
+    if (magic != indexMagic || version != indexVersion)
+        return false;
+
+    QVector<FileEntry> files;
+    qint32 fileCount = 0;
+    stream >> fileCount;
+    files.reserve(fileCount);
+    for (qint32 index = 0; index < fileCount && stream.status() == QDataStream::Ok; ++index) {
+        FileEntry entry;
+        stream >> entry.filePath >> entry.stamp.lastModified >> entry.stamp.statusChanged
+            >> entry.stamp.size >> entry.isRemoved;
+        files.append(entry);
+    }
+
+    std::unordered_map<quint64, FileIds> postings;
+    qint32 postingCount = 0;
+    stream >> postingCount;
+    for (qint32 index = 0; index < postingCount && stream.status() == QDataStream::Ok; ++index) {
+        quint64 trigram = 0;
+        qint32 idCount = 0;
+        stream >> trigram >> idCount;
+        FileIds &ids = postings[trigram];
+        ids.reserve(std::size_t(std::max(0, idCount)));
+        for (qint32 idIndex = 0; idIndex < idCount; ++idIndex) {
+            qint32 id = -1;
+            stream >> id;
+            if (id < 0 || id >= files.size())
+                return false;
+            ids.push_back(id);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    QWriteLocker locker(&m_lock);
+
+    m_files = std::move(files);
+    m_postings = std::move(postings);
+    m_fileIds.clear();
+    m_removedFileCount = 0;
+    for (int id = 0; id < m_files.size(); ++id) {
+        const FileEntry &entry = m_files.at(id);
+        if (entry.isRemoved)
+            ++m_removedFileCount;
+        else
+            m_fileIds.insert(entry.filePath, id);
+    }
+    ++m_generation;
+    m_isModified = false;
+
+    return true;
+}
+
+bool TrigramIndex::save(const QString &indexFilePath) const
+{
+    QSaveFile file(indexFilePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream << indexMagic << indexVersion;
+
+    {
+        QReadLocker locker(&m_lock);
+
+        stream << qint32(m_files.size());
+        for (const FileEntry &entry : m_files)
+            stream << entry.filePath << entry.stamp.lastModified << entry.stamp.statusChanged
+                   << entry.stamp.size << entry.isRemoved;
+
+        stream << qint32(m_postings.size());
+        for (const auto &posting : m_postings) {
+            stream << posting.first << qint32(posting.second.size());
+            for (int id : posting.second)
+                stream << qint32(id);
+        }
+
+        // Files added while the file is committed mark the index as modified again.
+        m_isModified = false;
+    }
+
+    if (stream.status() == QDataStream::Ok && file.commit())
+        return true;
+
+    m_isModified = true;
+    return false;
+}
+
+QVector<quint64> TrigramIndex::requiredTrigrams(const QString &searchTerm, bool isRegExp)
+{
+    if (isRegExp)
+        return regExpTrigrams(searchTerm);
+
+    QVector<quint64> trigrams;
+    addTrigrams(searchTerm, trigrams);
+
+    return trigrams;
+}
+
+bool TrigramIndex::isUnchanged(const FileEntry &entry) const
+{
+    return FileStamp::fromFile(entry.filePath) == entry.stamp;
+}
+
+// The postings keep the id of a removed file until the next compaction, so the file is only
+// marked as removed.
+void TrigramIndex::removeFileUnlocked(const QString &filePath)
+{
+    if (!m_fileIds.contains(filePath))
+        return;
+
+    const int id = m_fileIds.take(filePath);
+    if (id < 0 || id >= m_files.size() || m_files.at(id).filePath != filePath)
+        return;
+
+    m_files[id].isRemoved = true;
+    ++m_removedFileCount;
+    m_isModified = true;
+}
+
+void TrigramIndex::compactUnlocked()
+{
+    QVector<int> newIds(m_files.size(), -1);
+    QVector<FileEntry> files;
+    files.reserve(m_files.size() - m_removedFileCount);
+
+    for (int id = 0; id < m_files.size(); ++id) {
+        if (!m_files.at(id).isRemoved) {
+            newIds[id] = files.size();
+            files.append(m_files.at(id));
+        }
+    }
+
+    for (auto current = m_postings.begin(); current != m_postings.end();) {
+        FileIds &ids = current->second;
+        FileIds compactedIds;
+        compactedIds.reserve(ids.size());
+        for (int id : ids) {
+            if (newIds.at(id) >= 0)
+                compactedIds.push_back(newIds.at(id));
+        }
+
+        if (compactedIds.empty()) {
+            current = m_postings.erase(current);
+        } else {
+            ids = std::move(compactedIds);
+            ++current;
+        }
+    }
+
+    m_files = std::move(files);
+    m_fileIds.clear();
+    for (int id = 0; id < m_files.size(); ++id)
+        m_fileIds.insert(m_files.at(id).filePath, id);
+
+    m_removedFileCount = 0;
+    ++m_generation;
+}
+
+} // namespace Utils
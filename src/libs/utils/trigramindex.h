@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "utils_global.h"
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Utils {
+
+// Maps lower case trigrams to the files containing them. Searches use it to skip files which
+// cannot contain a match. Files are added with the content a search has read anyway. Before a
+// file is ruled out, its size, modification and status change time are compared with the ones
+// from indexing. A file that changed on disk is searched, so the index only ever narrows the
+// file set.
+class QTCREATOR_UTILS_EXPORT TrigramIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FileFilter = std::function<bool(const QString &filePath)>;
+
+    class QTCREATOR_UTILS_EXPORT FileStamp
+    {
+    public:
+        static FileStamp fromFile(const QString &filePath);
+
+        bool isValid() const { return size >= 0; }
+
+        friend bool operator==(const FileStamp &first, const FileStamp &second)
+        {
+            return first.lastModified == second.lastModified
+                   && first.statusChanged == second.statusChanged && first.size == second.size;
+        }
+
+    public:
+        qint64 lastModified = 0;
+        // The status change time is also updated by writes which restore the modification time.
+        qint64 statusChanged = 0;
+        qint64 size = -1;
+    };
+
+    explicit TrigramIndex(QObject *parent = nullptr);
+    ~TrigramIndex() override;
+
+    // The stamp must be taken before the content was read. If the file changed in the meantime,
+    // it is not indexed.
+    void addFile(const QString &filePath, const QString &content, const FileStamp &stamp);
+    void removeFile(const QString &filePath);
+    bool isIndexed(const QString &filePath) const;
+    int fileCount() const;
+
+    // Returns a filter which returns false for files that cannot contain a match. The filter
+    // is empty if the search term has no trigram every match must contain. The index is case
+    // folded, so the filter fits case sensitive and insensitive searches.
+    FileFilter candidateFilter(const QString &searchTerm, bool isRegExp) const;
+
+    // A loaded or saved index is unmodified until files are added or removed.
+    bool isModified() const;
+    bool load(const QString &indexFilePath);
+    bool save(const QString &indexFilePath) const;
+
+    static QVector<quint64> requiredTrigrams(const QString &searchTerm, bool isRegExp);
+
+private:
+    class FileEntry
+    {
+    public:
+        QString filePath;
+        FileStamp stamp;
+        bool isRemoved = false;
+    };
+
+    using FileIds = std::vector<int>;
+
+    bool isUnchanged(const FileEntry &entry) const;
+    void removeFileUnlocked(const QString &filePath);
+    void compactUnlocked();
+
+    mutable QReadWriteLock m_lock;
+    QVector<FileEntry> m_files;
+    QHash<QString, int> m_fileIds;
+    std::unordered_map<quint64, FileIds> m_postings;
+    int m_removedFileCount = 0;
+    int m_generation = 0;
+    mutable std::atomic<bool> m_isModified{false};
+};
+
+} // namespace Utils
@@ -109,6 +109,7 @@ SOURCES += \
     $$PWD/itemviews.cpp \
     $$PWD/treemodel.cpp \
     $$PWD/treeviewcombobox.cpp \
+    $$PWD/trigramindex.cpp \
     $$PWD/proxycredentialsdialog.cpp \
     $$PWD/macroexpander.cpp \
     $$PWD/theme/theme.cpp \
@@ -240,6 +241,7 @@ HEADERS += \
     $$PWD/itemviews.h \
     $$PWD/treemodel.h \
     $$PWD/treeviewcombobox.h \
+    $$PWD/trigramindex.h \
     $$PWD/scopedswap.h \
     $$PWD/algorithm.h \
     $$PWD/QtConcurrentTools \
@@ -55,6 +55,8 @@
 #include <QDir>
 #include <QTextBlock>
 
+#include <algorithm>
+
 using namespace CPlusPlus;
 using namespace ClangBackEnd;
 using namespace TextEditor;
@@ -77,6 +79,7 @@ public:
 
     void documentsOpened(const DocumentsOpenedMessage &) override {}
     void documentsChanged(const DocumentsChangedMessage &) override {}
+    void documentTextChanged(const DocumentTextChangedMessage &) override {}
     void documentsClosed(const DocumentsClosedMessage &) override {}
     void documentVisibilityChanged(const DocumentVisibilityChangedMessage &) override {}
 
@@ -99,6 +102,9 @@ BackendCommunicator::BackendCommunicator()
             this, &BackendCommunicator::logStartTimeOut);
 
     m_receiver.setAliveHandler([this]() { m_connection.resetProcessAliveTimer(); });
+    m_receiver.setDocumentOutOfSyncHandler([this](const QString &filePath) {
+        onDocumentOutOfSync(filePath);
+    });
 
     connect(Core::EditorManager::instance(), &Core::EditorManager::editorAboutToClose,
             this, &BackendCommunicator::onEditorAboutToClose);
@@ -395,6 +401,7 @@ void BackendCommunicator::onConnectedToBackend()
 
     m_receiver.reset();
     m_sender.reset(new BackendSender(&m_connection));
+    m_sentDocuments.clear();
 
     initializeBackendWithCurrentData();
 }
@@ -408,6 +415,7 @@ void BackendCommunicator::onEditorAboutToClose(Core::IEditor *editor)
 void BackendCommunicator::setupDummySender()
 {
     m_sender.reset(new DummyBackendSender);
+    m_sentDocuments.clear();
 }
 
 void BackendCommunicator::logExecutableDoesNotExist()
@@ -466,18 +474,31 @@ void BackendCommunicator::documentsOpened(const FileContainers &fileContainers)
 
     const DocumentsOpenedMessage message(fileContainers, currentDocument, visibleDocuments);
     m_sender->documentsOpened(message);
+    updateSentDocuments(fileContainers);
 }
 
 void BackendCommunicator::documentsChanged(const FileContainers &fileContainers)
 {
-    const DocumentsChangedMessage message(fileContainers);
+    FileContainers fullFileContainers;
+    for (const FileContainer &fileContainer : fileContainers) {
+        if (!documentTextChanged(fileContainer))
+            fullFileContainers.append(fileContainer);
+    }
+
+    if (fullFileContainers.isEmpty())
+        return;
+
+    const DocumentsChangedMessage message(fullFileContainers);
     m_sender->documentsChanged(message);
+    updateSentDocuments(fullFileContainers);
 }
 
 void BackendCommunicator::documentsClosed(const FileContainers &fileContainers)
 {
     const DocumentsClosedMessage message(fileContainers);
     m_sender->documentsClosed(message);
+    for (const FileContainer &fileContainer : fileContainers)
+        m_sentDocuments.remove(fileContainer.filePath);
     documentVisibilityChanged(); // QTCREATORBUG-25193
 }
 
@@ -485,12 +506,108 @@ void BackendCommunicator::unsavedFilesUpdated(const FileContainers &fileContaine
 {
     const UnsavedFilesUpdatedMessage message(fileContainers);
     m_sender->unsavedFilesUpdated(message);
+    for (const FileContainer &fileContainer : fileContainers)
+        m_sentDocuments.remove(fileContainer.filePath);
 }
 
 void BackendCommunicator::unsavedFilesRemoved(const FileContainers &fileContainers)
 {
     const UnsavedFilesRemovedMessage message(fileContainers);
     m_sender->unsavedFilesRemoved(message);
+    for (const FileContainer &fileContainer : fileContainers)
+        m_sentDocuments.remove(fileContainer.filePath);
+}
+
+static void advanceLineAndColumn(const QByteArray &text,
+                                 int from,
+                                 int to,
+                                 quint32 &line,
+                                 quint32 &column)
+{
+    for (int position = from; position < to; ++position) {
+        if (text.at(position) == '\n') {
+            ++line;
+            column = 1;
+        } else {
+            ++column;
+        }
+    }
+}
+
+// Single change replacing everything between the common prefix and the common suffix.
+static TextChangeContainer textChangeBetween(const QByteArray &oldText, const QByteArray &newText)
+{
+    const int commonSize = qMin(oldText.size(), newText.size());
+    const int prefixSize = int(std::mismatch(oldText.cbegin(),
+                                             oldText.cbegin() + commonSize,
+                                             newText.cbegin()).first
+                               - oldText.cbegin());
+    const int suffixSize = int(std::mismatch(oldText.crbegin(),
+                                             oldText.crbegin() + (commonSize - prefixSize),
+                                             newText.crbegin()).first
+                               - oldText.crbegin());
+
+    quint32 startLine = 1;
+    quint32 startColumn = 1;
+    advanceLineAndColumn(oldText, 0, prefixSize, startLine, startColumn);
+    quint32 endLine = startLine;
+    quint32 endColumn = startColumn;
+    advanceLineAndColumn(oldText, prefixSize, oldText.size() - suffixSize, endLine, endColumn);
+
+    const QByteArray text = newText.mid(prefixSize, newText.size() - suffixSize - prefixSize);
+
+    return {startLine, startColumn, endLine, endColumn, Utf8String::fromByteArray(text)};
+}
+
+bool BackendCommunicator::documentTextChanged(const FileContainer &fileContainer)
+{
+    if (!fileContainer.hasUnsavedFileContent)
+        return false;
+
+    const auto sentDocument = m_sentDocuments.find(fileContainer.filePath);
+    if (sentDocument == m_sentDocuments.end())
+        return false;
+
+    const QByteArray &contents = fileContainer.unsavedFileContent.toByteArray();
+    if (sentDocument->documentRevision == fileContainer.documentRevision)
+        return sentDocument->contents == contents; // Nothing new for the backend
+
+    const TextChangeContainer textChange = textChangeBetween(sentDocument->contents, contents);
+    if (textChange.text.byteSize() > contents.size() / 2)
+        return false; // Mostly new content, so send it as a whole
+
+    FileContainer changedFileContainer = fileContainer;
+    changedFileContainer.unsavedFileContent = Utf8String();
+    const DocumentTextChangedMessage message(changedFileContainer,
+                                             sentDocument->documentRevision,
+                                             {textChange});
+    m_sender->documentTextChanged(message);
+
+    sentDocument->contents = contents;
+    sentDocument->documentRevision = fileContainer.documentRevision;
+
+    return true;
+}
+
+void BackendCommunicator::updateSentDocuments(const FileContainers &fileContainers)
+{
+    for (const FileContainer &fileContainer : fileContainers) {
+        if (fileContainer.hasUnsavedFileContent) {
+            m_sentDocuments.insert(fileContainer.filePath,
+                                   {fileContainer.unsavedFileContent.toByteArray(),
+                                    fileContainer.documentRevision});
+        } else {
+            m_sentDocuments.remove(fileContainer.filePath);
+        }
+    }
+}
+
+void BackendCommunicator::onDocumentOutOfSync(const QString &filePath)
+{
+    // The backend rejected the text changes, so fall back to the full content.
+    m_sentDocuments.remove(filePath);
+    if (cppDocument(filePath))
+        documentsChangedFromCppEditorDocument(filePath);
 }
 
 void BackendCommunicator::requestCompletions(ClangCompletionAssistProcessor *assistProcessor,
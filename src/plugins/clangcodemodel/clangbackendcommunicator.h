@@ -34,6 +34,7 @@
 #include <clangsupport/filecontainer.h>
 
 #include <QFuture>
+#include <QHash>
 #include <QObject>
 #include <QVector>
 #include <QTimer>
@@ -133,7 +134,18 @@ private:
     void documentVisibilityChanged(const Utf8String &currentEditorFilePath,
                                    const Utf8StringVector &visibleEditorsFilePaths);
 
+    bool documentTextChanged(const FileContainer &fileContainer);
+    void updateSentDocuments(const FileContainers &fileContainers);
+    void onDocumentOutOfSync(const QString &filePath);
+
 private:
+    // Unsaved content as the backend knows it, so that only the changes need to be sent.
+    struct SentDocument {
+        QByteArray contents;
+        uint documentRevision = 0;
+    };
+    QHash<Utf8String, SentDocument> m_sentDocuments;
+
     BackendReceiver m_receiver;
     ClangBackEnd::ClangCodeModelConnectionClient m_connection;
     QTimer m_backendStartTimeOut;
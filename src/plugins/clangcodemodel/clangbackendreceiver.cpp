@@ -75,6 +75,12 @@ void BackendReceiver::setAliveHandler(const BackendReceiver::AliveHandler &handl
     m_aliveHandler = handler;
 }
 
+void BackendReceiver::setDocumentOutOfSyncHandler(
+        const BackendReceiver::DocumentOutOfSyncHandler &handler)
+{
+    m_documentOutOfSyncHandler = handler;
+}
+
 void BackendReceiver::addExpectedCompletionsMessage(
         quint64 ticket,
         ClangCompletionAssistProcessor *processor)
@@ -229,6 +235,14 @@ void BackendReceiver::annotations(const AnnotationsMessage &message)
                                   documentRevision);
 }
 
+void BackendReceiver::documentOutOfSync(const DocumentOutOfSyncMessage &message)
+{
+    qCDebugIpc() << message;
+
+    QTC_ASSERT(m_documentOutOfSyncHandler, return);
+    m_documentOutOfSyncHandler(message.filePath);
+}
+
 static
 CppTools::CursorInfo::Range toCursorInfoRange(const SourceRangeContainer &sourceRange)
 {
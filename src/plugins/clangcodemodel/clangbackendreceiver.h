@@ -54,6 +54,9 @@ public:
     using AliveHandler = std::function<void ()>;
     void setAliveHandler(const AliveHandler &handler);
 
+    using DocumentOutOfSyncHandler = std::function<void (const QString &filePath)>;
+    void setDocumentOutOfSyncHandler(const DocumentOutOfSyncHandler &handler);
+
     void addExpectedCompletionsMessage(quint64 ticket, ClangCompletionAssistProcessor *processor);
     void cancelProcessor(TextEditor::IAssistProcessor *processor);
     void deleteProcessorsOfEditorWidget(TextEditor::TextEditorWidget *textEditorWidget);
@@ -74,12 +77,14 @@ private:
     void completions(const ClangBackEnd::CompletionsMessage &message) override;
 
     void annotations(const ClangBackEnd::AnnotationsMessage &message) override;
+    void documentOutOfSync(const ClangBackEnd::DocumentOutOfSyncMessage &message) override;
     void references(const ClangBackEnd::ReferencesMessage &message) override;
     void tooltip(const ClangBackEnd::ToolTipMessage &message) override;
     void followSymbol(const ClangBackEnd::FollowSymbolMessage &message) override;
 
 private:
     AliveHandler m_aliveHandler;
+    DocumentOutOfSyncHandler m_documentOutOfSyncHandler;
     QHash<quint64, ClangCompletionAssistProcessor *> m_assistProcessorsTable;
 
     struct ReferencesEntry {
@@ -64,6 +64,13 @@ void BackendSender::documentsChanged(const DocumentsChangedMessage &message)
     m_connection->serverProxy().documentsChanged(message);
 }
 
+void BackendSender::documentTextChanged(const DocumentTextChangedMessage &message)
+{
+    QTC_CHECK(m_connection->isConnected());
+    qCDebugIpc() << message;
+    m_connection->serverProxy().documentTextChanged(message);
+}
+
 void BackendSender::documentsClosed(const DocumentsClosedMessage &message)
 {
      QTC_CHECK(m_connection->isConnected());
@@ -41,6 +41,7 @@ public:
 
     void documentsOpened(const ClangBackEnd::DocumentsOpenedMessage &message) override;
     void documentsChanged(const ClangBackEnd::DocumentsChangedMessage &message) override;
+    void documentTextChanged(const ClangBackEnd::DocumentTextChangedMessage &message) override;
     void documentsClosed(const ClangBackEnd::DocumentsClosedMessage &message) override;
     void documentVisibilityChanged(const ClangBackEnd::DocumentVisibilityChangedMessage &message) override;
 
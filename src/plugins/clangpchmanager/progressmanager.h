@@ -60,6 +60,12 @@ public:
             finish();
     }
 
+    void setProgressText(const QString &text)
+    {
+        if (m_promise)
+            m_promise->setProgressValueAndText(m_promise->progressValue(), text);
+    }
+
     Promise *promise()
     {
         return m_promise.get();
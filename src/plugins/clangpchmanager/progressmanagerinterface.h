@@ -25,12 +25,19 @@
 
 #pragma once
 
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QString;
+QT_END_NAMESPACE
+
 namespace ClangPchManager {
 
 class ProgressManagerInterface
 {
 public:
     virtual void setProgress(int currentProgress,  int maximumProgress) = 0;
+    virtual void setProgressText(const QString &text) = 0;
 
 protected:
     ~ProgressManagerInterface() = default;
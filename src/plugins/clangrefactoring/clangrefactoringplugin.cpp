@@ -30,6 +30,7 @@
 #include "qtcreatorrefactoringprojectupdater.h"
 #include "querysqlitestatementfactory.h"
 #include "sqlitedatabase.h"
+#include "sqlitereadconnectionpool.h"
 #include "sqlitereadstatement.h"
 #include "symbolquery.h"
 
@@ -54,7 +55,9 @@
 #include <QDir>
 #include <QApplication>
 
+#include <algorithm>
 #include <chrono>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -71,6 +74,11 @@ QString backendProcessPath()
             + QStringLiteral(QTC_HOST_EXE_SUFFIX);
 }
 
+std::size_t readConnectionCount()
+{
+    return std::clamp(std::thread::hardware_concurrency() / 2, 2u, 8u);
+}
+
 } // anonymous namespace
 
 std::unique_ptr<ClangRefactoringPluginData> ClangRefactoringPlugin::d;
@@ -78,13 +86,15 @@ std::unique_ptr<ClangRefactoringPluginData> ClangRefactoringPlugin::d;
 class ClangRefactoringPluginData
 {
 public:
-    using QuerySqliteReadStatementFactory = QuerySqliteStatementFactory<Sqlite::Database,
-                                                                        Sqlite::ReadStatement>;
+    using QuerySqliteReadStatementFactory = QuerySqliteStatementFactory<Sqlite::ReadConnectionPool>;
     Sqlite::Database database{Utils::PathString{Core::ICore::cacheResourcePath()
                                                 + "/symbol-experimental-v1.db"},
                               1000ms};
     ClangBackEnd::RefactoringDatabaseInitializer<Sqlite::Database> databaseInitializer{database};
     ClangBackEnd::FilePathCaching filePathCache{database};
+    // Symbol queries run on their own connections, so they are not serialized with writes.
+    Sqlite::ReadConnectionPool readConnectionPool{database.databaseFilePath(),
+                                                  readConnectionCount()};
     ClangPchManager::ProgressManager progressManager{
         [] (QFutureInterface<void> &promise) {
             auto title = QCoreApplication::translate("ClangRefactoringProgressManager", "C++ Indexing");
@@ -92,7 +102,7 @@ public:
     RefactoringClient refactoringClient{progressManager};
     QtCreatorEditorManager editorManager{filePathCache};
     ClangBackEnd::RefactoringConnectionClient connectionClient{&refactoringClient};
-    QuerySqliteReadStatementFactory statementFactory{database};
+    QuerySqliteReadStatementFactory statementFactory{readConnectionPool};
     SymbolQuery<QuerySqliteReadStatementFactory> symbolQuery{statementFactory};
     ClangBackEnd::ProjectPartsStorage<Sqlite::Database> projectPartsStorage{database};
     RefactoringEngine engine{connectionClient.serverProxy(), refactoringClient, filePathCache, symbolQuery};
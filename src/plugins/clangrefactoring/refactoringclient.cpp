@@ -32,6 +32,8 @@
 #include <filepathcachinginterface.h>
 #include <refactoringconnectionclient.h>
 
+#include <QCoreApplication>
+
 namespace ClangRefactoring {
 
 void RefactoringClient::alive()
@@ -57,6 +59,13 @@ void RefactoringClient::sourceRangesForQueryMessage(ClangBackEnd::SourceRangesFo
 void RefactoringClient::progress(ClangBackEnd::ProgressMessage &&message)
 {
     m_progressManager.setProgress(message.progress, message.total);
+
+    if (message.itemsPerSecond > 0) {
+        m_progressManager.setProgressText(
+            QCoreApplication::translate("ClangRefactoring::RefactoringClient",
+                                        "%1 translation units per second")
+                .arg(message.itemsPerSecond));
+    }
 }
 
 void RefactoringClient::setRefactoringEngine(RefactoringEngine *refactoringEngine)
@@ -63,8 +63,9 @@ static QString itemText(const QModelIndex &index)
     const QString text = index.data(Qt::DisplayRole).toString();
     // show number of subresults in displayString
     if (index.model()->hasChildren(index)) {
-        return text + QLatin1String(" (") + QString::number(index.model()->rowCount(index))
-               + QLatin1Char(')');
+        // not all subresults might be fetched yet, the model counts the ones the filter accepts
+        const int count = index.data(ItemDataRoles::ChildrenCountRole).toInt();
+        return text + QLatin1String(" (") + QString::number(count) + QLatin1Char(')');
     }
     return text;
 }
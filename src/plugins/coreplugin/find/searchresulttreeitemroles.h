@@ -41,7 +41,8 @@ enum Roles
     ResultHighlightForegroundColor,
     ResultBeginColumnNumberRole,
     SearchTermLengthRole,
-    IsGeneratedRole
+    IsGeneratedRole,
+    ChildrenCountRole
 };
 
 } // namespace Internal
@@ -39,6 +39,7 @@ SearchResultTreeItem::SearchResultTreeItem(const SearchResultItem &item,
 
 SearchResultTreeItem::~SearchResultTreeItem()
 {
+    m_parent = nullptr; // the parent is going away as well or does not count this item anymore
     clearChildren();
 }
 
@@ -47,20 +48,67 @@ bool SearchResultTreeItem::isLeaf() const
     return childrenCount() == 0 && parent() != nullptr;
 }
 
+// The check state of an item with children is derived from the counts of checked and
+// unchecked children, so adding results does not need to visit all siblings.
 Qt::CheckState SearchResultTreeItem::checkState() const
 {
-    return m_checkState;
+    if (m_children.isEmpty())
+        return m_checkState;
+
+    const int partiallyCheckedCount = m_children.count() - m_checkedChildrenCount
+                                      - m_uncheckedChildrenCount;
+    const bool hasChecked = m_checkedChildrenCount > 0 || partiallyCheckedCount > 0;
+    const bool hasUnchecked = m_uncheckedChildrenCount > 0 || partiallyCheckedCount > 0;
+
+    if (hasChecked && hasUnchecked)
+        return Qt::PartiallyChecked;
+    if (hasChecked)
+        return Qt::Checked;
+    return Qt::Unchecked;
 }
 
 void SearchResultTreeItem::setCheckState(Qt::CheckState checkState)
 {
+    const Qt::CheckState oldCheckState = this->checkState();
     m_checkState = checkState;
+    const Qt::CheckState newCheckState = this->checkState();
+
+    if (m_parent && oldCheckState != newCheckState)
+        m_parent->childCheckStateChanged(oldCheckState, newCheckState);
+}
+
+void SearchResultTreeItem::updateChildCheckStateCount(Qt::CheckState checkState, int difference)
+{
+    if (checkState == Qt::Checked)
+        m_checkedChildrenCount += difference;
+    else if (checkState == Qt::Unchecked)
+        m_uncheckedChildrenCount += difference;
+}
+
+void SearchResultTreeItem::childCheckStateChanged(Qt::CheckState oldChildCheckState,
+                                                  Qt::CheckState newChildCheckState)
+{
+    const Qt::CheckState oldCheckState = checkState();
+    updateChildCheckStateCount(oldChildCheckState, -1);
+    updateChildCheckStateCount(newChildCheckState, 1);
+    const Qt::CheckState newCheckState = checkState();
+
+    if (m_parent && oldCheckState != newCheckState)
+        m_parent->childCheckStateChanged(oldCheckState, newCheckState);
 }
 
 void SearchResultTreeItem::clearChildren()
 {
+    const Qt::CheckState oldCheckState = checkState();
+
     qDeleteAll(m_children);
     m_children.clear();
+    m_fetchedChildrenCount = 0;
+    m_checkedChildrenCount = 0;
+    m_uncheckedChildrenCount = 0;
+
+    if (m_parent && oldCheckState != m_checkState)
+        m_parent->childCheckStateChanged(oldCheckState, m_checkState);
 }
 
 int SearchResultTreeItem::childrenCount() const
@@ -70,7 +118,14 @@ int SearchResultTreeItem::childrenCount() const
 
 int SearchResultTreeItem::rowOfItem() const
 {
-    return (m_parent ? m_parent->m_children.indexOf(const_cast<SearchResultTreeItem*>(this)):0);
+    if (!m_parent)
+        return 0;
+
+    const QList<SearchResultTreeItem *> &siblings = m_parent->m_children;
+    if (m_row >= siblings.count() || siblings.at(m_row) != this)
+        m_row = siblings.indexOf(const_cast<SearchResultTreeItem *>(this));
+
+    return m_row;
 }
 
 SearchResultTreeItem* SearchResultTreeItem::childAt(int index) const
@@ -108,7 +163,15 @@ int SearchResultTreeItem::insertionIndex(const SearchResultItem &item, SearchRes
 
 void SearchResultTreeItem::insertChild(int index, SearchResultTreeItem *child)
 {
+    const Qt::CheckState oldCheckState = checkState();
+
     m_children.insert(index, child);
+    child->m_row = index;
+    updateChildCheckStateCount(child->checkState(), 1);
+
+    const Qt::CheckState newCheckState = checkState();
+    if (m_parent && oldCheckState != newCheckState)
+        m_parent->childCheckStateChanged(oldCheckState, newCheckState);
 }
 
 void SearchResultTreeItem::insertChild(int index, const SearchResultItem &item)
@@ -52,6 +52,10 @@ public:
     int rowOfItem() const;
     void clearChildren();
 
+    // The model only shows the first fetched children, the others are fetched in batches.
+    int fetchedChildrenCount() const { return m_fetchedChildrenCount; }
+    void setFetchedChildrenCount(int count) { m_fetchedChildrenCount = count; }
+
     Qt::CheckState checkState() const;
     void setCheckState(Qt::CheckState checkState);
 
@@ -61,8 +65,15 @@ public:
     SearchResultItem item;
 
 private:
+    void updateChildCheckStateCount(Qt::CheckState checkState, int difference);
+    void childCheckStateChanged(Qt::CheckState oldCheckState, Qt::CheckState newCheckState);
+
     SearchResultTreeItem *m_parent;
     QList<SearchResultTreeItem *> m_children;
+    mutable int m_row = 0; // hint, rows shift if items are inserted in front
+    int m_fetchedChildrenCount = 0;
+    int m_checkedChildrenCount = 0;
+    int m_uncheckedChildrenCount = 0;
     bool m_isGenerated;
     Qt::CheckState m_checkState;
 };
@@ -37,6 +37,11 @@
 namespace Core {
 namespace Internal {
 
+// Results beyond the first rows of a parent are only announced to the views when they ask
+// for them with fetchMore(), in batches of this size, so huge searches neither block the UI
+// nor make the views keep an entry for every result.
+const int fetchBatchSize = 1000;
+
 class SearchResultTreeModel : public QAbstractItemModel
 {
     Q_OBJECT
@@ -52,13 +57,20 @@ public:
     QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
     QModelIndex parent(const QModelIndex &child) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
-    QModelIndex next(const QModelIndex &idx, bool includeGenerated = false, bool *wrapped = nullptr) const;
-    QModelIndex prev(const QModelIndex &idx, bool includeGenerated = false, bool *wrapped = nullptr) const;
+    SearchResultTreeItem *next(SearchResultTreeItem *item, bool includeGenerated = false,
+                               bool *wrapped = nullptr) const;
+    SearchResultTreeItem *prev(SearchResultTreeItem *item, bool includeGenerated = false,
+                               bool *wrapped = nullptr) const;
+    QModelIndex fetchIndex(SearchResultTreeItem *item);
+    const SearchResultTreeItem *rootItem() const { return m_rootItem; }
 
     QList<QModelIndex> addResults(const QList<SearchResultItem> &items, SearchResult::AddMode mode);
 
@@ -73,13 +85,17 @@ public slots:
 
 private:
     QModelIndex index(SearchResultTreeItem *item) const;
+    SearchResultTreeItem *treeItemAtParentIndex(const QModelIndex &parent) const;
+    void fetchChildren(const QModelIndex &parent, SearchResultTreeItem *parentItem, int count);
+    void insertChild(const QModelIndex &parent, SearchResultTreeItem *parentItem, int row,
+                     SearchResultTreeItem *child);
     void addResultsToCurrentParent(const QList<SearchResultItem> &items, SearchResult::AddMode mode);
     QSet<SearchResultTreeItem *> addPath(const QStringList &path);
     QVariant data(const SearchResultTreeItem *row, int role) const;
-    bool setCheckState(const QModelIndex &idx, Qt::CheckState checkState, bool firstCall = true);
-    void updateCheckStateFromChildren(const QModelIndex &idx, SearchResultTreeItem *item);
-    QModelIndex nextIndex(const QModelIndex &idx, bool *wrapped = nullptr) const;
-    QModelIndex prevIndex(const QModelIndex &idx, bool *wrapped = nullptr) const;
+    bool setCheckState(const QModelIndex &idx, Qt::CheckState checkState);
+    void emitCheckStateChanged(const QModelIndex &idx);
+    SearchResultTreeItem *nextItem(SearchResultTreeItem *item, bool *wrapped = nullptr) const;
+    SearchResultTreeItem *prevItem(SearchResultTreeItem *item, bool *wrapped = nullptr) const;
 
     SearchResultTreeItem *m_rootItem;
     SearchResultTreeItem *m_currentParent;
@@ -151,13 +167,7 @@ QModelIndex SearchResultTreeModel::index(int row, int column,
     if (!hasIndex(row, column, parent))
         return QModelIndex();
 
-    const SearchResultTreeItem *parentItem;
-
-    if (!parent.isValid())
-        parentItem = m_rootItem;
-    else
-        parentItem = treeItemAtIndex(parent);
-
+    const SearchResultTreeItem *parentItem = treeItemAtParentIndex(parent);
     const SearchResultTreeItem *childItem = parentItem->childAt(row);
     if (childItem)
         return createIndex(row, column, const_cast<SearchResultTreeItem *>(childItem));
@@ -189,14 +199,66 @@ int SearchResultTreeModel::rowCount(const QModelIndex &parent) const
     if (parent.column() > 0)
         return 0;
 
-    const SearchResultTreeItem *parentItem;
+    return treeItemAtParentIndex(parent)->fetchedChildrenCount();
+}
 
-    if (!parent.isValid())
-        parentItem = m_rootItem;
-    else
-        parentItem = treeItemAtIndex(parent);
+bool SearchResultTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return false;
+
+    return treeItemAtParentIndex(parent)->childrenCount() > 0;
+}
+
+bool SearchResultTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return false;
+
+    const SearchResultTreeItem *parentItem = treeItemAtParentIndex(parent);
+    return parentItem->fetchedChildrenCount() < parentItem->childrenCount();
+}
+
+void SearchResultTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.column() > 0)
+        return;
+
+    fetchChildren(parent, treeItemAtParentIndex(parent), fetchBatchSize);
+}
 
-    return parentItem->childrenCount();
+void SearchResultTreeModel::fetchChildren(const QModelIndex &parent,
+                                          SearchResultTreeItem *parentItem,
+                                          int count)
+{
+    const int fetchedCount = parentItem->fetchedChildrenCount();
+    count = qMin(count, parentItem->childrenCount() - fetchedCount);
+    if (count <= 0)
+        return;
+
+    beginInsertRows(parent, fetchedCount, fetchedCount + count - 1);
+    parentItem->setFetchedChildrenCount(fetchedCount + count);
+    endInsertRows();
+}
+
+// Inserts the child and announces it if it lands among the fetched rows, otherwise the
+// row is left for fetchMore().
+void SearchResultTreeModel::insertChild(const QModelIndex &parent,
+                                        SearchResultTreeItem *parentItem,
+                                        int row,
+                                        SearchResultTreeItem *child)
+{
+    const int fetchedCount = parentItem->fetchedChildrenCount();
+    const bool allFetched = fetchedCount == parentItem->childrenCount();
+    if (row < fetchedCount || (allFetched && fetchedCount < fetchBatchSize)) {
+        beginInsertRows(parent, row, row);
+        parentItem->insertChild(row, child);
+        parentItem->setFetchedChildrenCount(fetchedCount + 1);
+        endInsertRows();
+        return;
+    }
+
+    parentItem->insertChild(row, child);
 }
 
 int SearchResultTreeModel::columnCount(const QModelIndex &parent) const
@@ -210,6 +272,11 @@ SearchResultTreeItem *SearchResultTreeModel::treeItemAtIndex(const QModelIndex &
     return static_cast<SearchResultTreeItem*>(idx.internalPointer());
 }
 
+SearchResultTreeItem *SearchResultTreeModel::treeItemAtParentIndex(const QModelIndex &parent) const
+{
+    return parent.isValid() ? treeItemAtIndex(parent) : m_rootItem;
+}
+
 QVariant SearchResultTreeModel::data(const QModelIndex &idx, int role) const
 {
     if (!idx.isValid())
@@ -240,51 +307,41 @@ bool SearchResultTreeModel::setData(const QModelIndex &idx, const QVariant &valu
     return QAbstractItemModel::setData(idx, value, role);
 }
 
-bool SearchResultTreeModel::setCheckState(const QModelIndex &idx, Qt::CheckState checkState, bool firstCall)
+static void setCheckStateRecursively(SearchResultTreeItem *item, Qt::CheckState checkState)
+{
+    for (int i = 0; i < item->childrenCount(); ++i)
+        setCheckStateRecursively(item->childAt(i), checkState);
+    item->setCheckState(checkState);
+}
+
+bool SearchResultTreeModel::setCheckState(const QModelIndex &idx, Qt::CheckState checkState)
 {
     SearchResultTreeItem *item = treeItemAtIndex(idx);
     if (item->checkState() == checkState)
         return false;
-    item->setCheckState(checkState);
-    if (firstCall) {
-        emit dataChanged(idx, idx);
-        updateCheckStateFromChildren(idx.parent(), item->parent());
-    }
-    // check children
-    if (int children = item->childrenCount()) {
-        for (int i = 0; i < children; ++i)
-            setCheckState(index(i, 0, idx), checkState, false);
-        emit dataChanged(index(0, 0, idx), index(children-1, 0, idx));
+
+    // The items keep the check state of their parents up to date.
+    setCheckStateRecursively(item, checkState);
+
+    // Only the fetched rows are known to the views.
+    QList<QModelIndex> changeQueue;
+    changeQueue.append(idx);
+    while (!changeQueue.isEmpty()) {
+        const QModelIndex current = changeQueue.takeFirst();
+        if (const int children = rowCount(current)) {
+            emit dataChanged(index(0, 0, current), index(children - 1, 0, current));
+            for (int r = 0; r < children; ++r)
+                changeQueue.append(index(r, 0, current));
+        }
     }
+    emitCheckStateChanged(idx);
     return true;
 }
 
-void SearchResultTreeModel::updateCheckStateFromChildren(const QModelIndex &idx,
-                                                         SearchResultTreeItem *item)
+void SearchResultTreeModel::emitCheckStateChanged(const QModelIndex &idx)
 {
-    if (!item)
-        return;
-
-    bool hasChecked = false;
-    bool hasUnchecked = false;
-    for (int i = 0; i < item->childrenCount(); ++i) {
-        SearchResultTreeItem *child = item->childAt(i);
-        if (child->checkState() == Qt::Checked)
-            hasChecked = true;
-        else if (child->checkState() == Qt::Unchecked)
-            hasUnchecked = true;
-        else if (child->checkState() == Qt::PartiallyChecked)
-            hasChecked = hasUnchecked = true;
-    }
-    if (hasChecked && hasUnchecked)
-        item->setCheckState(Qt::PartiallyChecked);
-    else if (hasChecked)
-        item->setCheckState(Qt::Checked);
-    else
-        item->setCheckState(Qt::Unchecked);
-    emit dataChanged(idx, idx);
-
-    updateCheckStateFromChildren(idx.parent(), item->parent());
+    for (QModelIndex current = idx; current.isValid(); current = current.parent())
+        emit dataChanged(current, current);
 }
 
 void setDataInternal(const QModelIndex &index, const QVariant &value, int role);
@@ -341,6 +398,9 @@ QVariant SearchResultTreeModel::data(const SearchResultTreeItem *row, int role)
     case ItemDataRoles::IsGeneratedRole:
         result = row->isGenerated();
         break;
+    case ItemDataRoles::ChildrenCountRole:
+        result = row->childrenCount();
+        break;
     default:
         result = QVariant();
         break;
@@ -379,9 +439,14 @@ QSet<SearchResultTreeItem *> SearchResultTreeModel::addPath(const QStringList &p
             if (m_showReplaceUI)
                 partItem->setCheckState(Qt::Checked);
             partItem->setGenerated(true);
+            // path nodes are always shown, so the views can expand them
+            fetchChildren(currentItemIndex, currentItem, insertionIndex - currentItem->fetchedChildrenCount());
             beginInsertRows(currentItemIndex, insertionIndex, insertionIndex);
             currentItem->insertChild(insertionIndex, partItem);
+            currentItem->setFetchedChildrenCount(currentItem->fetchedChildrenCount() + 1);
             endInsertRows();
+        } else {
+            fetchChildren(currentItemIndex, currentItem, insertionIndex + 1 - currentItem->fetchedChildrenCount());
         }
         pathNodes << partItem;
         currentItemIndex = index(insertionIndex, 0, currentItemIndex);
@@ -402,11 +467,20 @@ void SearchResultTreeModel::addResultsToCurrentParent(const QList<SearchResultIt
 
     if (mode == SearchResult::AddOrdered) {
         // this is the mode for e.g. text search
-        beginInsertRows(m_currentIndex, m_currentParent->childrenCount(), m_currentParent->childrenCount() + items.count());
+        const int fetchedCount = m_currentParent->fetchedChildrenCount();
+        const bool allFetched = fetchedCount == m_currentParent->childrenCount();
+        const int visibleCount = allFetched ? qMin(items.count(), fetchBatchSize - fetchedCount) : 0;
+        if (visibleCount > 0)
+            beginInsertRows(m_currentIndex, fetchedCount, fetchedCount + visibleCount - 1);
         foreach (const SearchResultItem &item, items) {
-            m_currentParent->appendChild(item);
+            SearchResultItem storedItem = item;
+            storedItem.setPath(m_currentPath); // share the path with the siblings
+            m_currentParent->appendChild(storedItem);
+        }
+        if (visibleCount > 0) {
+            m_currentParent->setFetchedChildrenCount(fetchedCount + visibleCount);
+            endInsertRows();
         }
-        endInsertRows();
     } else if (mode == SearchResult::AddSorted) {
         foreach (const SearchResultItem &item, items) {
             SearchResultTreeItem *existingItem;
@@ -414,17 +488,21 @@ void SearchResultTreeModel::addResultsToCurrentParent(const QList<SearchResultIt
             if (existingItem) {
                 existingItem->setGenerated(false);
                 existingItem->item = item;
-                QModelIndex itemIndex = index(insertionIndex, 0, m_currentIndex);
-                emit dataChanged(itemIndex, itemIndex);
+                existingItem->item.setPath(m_currentPath);
+                if (insertionIndex < m_currentParent->fetchedChildrenCount()) {
+                    QModelIndex itemIndex = index(insertionIndex, 0, m_currentIndex);
+                    emit dataChanged(itemIndex, itemIndex);
+                }
             } else {
-                beginInsertRows(m_currentIndex, insertionIndex, insertionIndex);
-                m_currentParent->insertChild(insertionIndex, item);
-                endInsertRows();
+                SearchResultItem storedItem = item;
+                storedItem.setPath(m_currentPath);
+                insertChild(m_currentIndex, m_currentParent, insertionIndex,
+                            new SearchResultTreeItem(storedItem, m_currentParent));
             }
         }
     }
-    updateCheckStateFromChildren(index(m_currentParent), m_currentParent);
-    emit dataChanged(m_currentIndex, m_currentIndex); // Make sure that the number after the file name gets updated
+    // Make sure that the check state and the number after the file name get updated
+    emitCheckStateChanged(m_currentIndex);
 }
 
 static bool lessThanByPath(const SearchResultItem &a, const SearchResultItem &b)
@@ -484,58 +562,62 @@ void SearchResultTreeModel::clear()
     endResetModel();
 }
 
-QModelIndex SearchResultTreeModel::nextIndex(const QModelIndex &idx, bool *wrapped) const
+// Navigation walks the items instead of the rows, so it does not need to fetch rows.
+// The navigation actions fetch the rows of the found item with fetchIndex().
+SearchResultTreeItem *SearchResultTreeModel::nextItem(SearchResultTreeItem *item,
+                                                      bool *wrapped) const
 {
     // pathological
-    if (!idx.isValid())
-        return index(0, 0);
+    if (m_rootItem->childrenCount() == 0)
+        return nullptr;
+    if (!item)
+        return m_rootItem->childAt(0);
 
-    if (rowCount(idx) > 0) {
+    if (item->childrenCount() > 0) {
         // node with children
-        return index(0, 0, idx);
+        return item->childAt(0);
     }
     // leaf node
-    QModelIndex nextIndex;
-    QModelIndex current = idx;
-    while (!nextIndex.isValid()) {
-        int row = current.row();
-        current = current.parent();
-        if (row + 1 < rowCount(current)) {
+    SearchResultTreeItem *current = item;
+    while (current != m_rootItem) {
+        SearchResultTreeItem *parentItem = current->parent();
+        const int row = current->rowOfItem();
+        if (row + 1 < parentItem->childrenCount()) {
             // Same parent has another child
-            nextIndex = index(row + 1, 0, current);
-        } else {
-            // go up one parent
-            if (!current.isValid()) {
-                // we start from the beginning
-                if (wrapped)
-                    *wrapped = true;
-                nextIndex = index(0, 0);
-            }
+            return parentItem->childAt(row + 1);
         }
+        // go up one parent
+        current = parentItem;
     }
-    return nextIndex;
+    // we start from the beginning
+    if (wrapped)
+        *wrapped = true;
+    return m_rootItem->childAt(0);
 }
 
-QModelIndex SearchResultTreeModel::next(const QModelIndex &idx, bool includeGenerated, bool *wrapped) const
+SearchResultTreeItem *SearchResultTreeModel::next(SearchResultTreeItem *item,
+                                                  bool includeGenerated, bool *wrapped) const
 {
-    QModelIndex value = idx;
+    SearchResultTreeItem *value = item;
     do {
-        value = nextIndex(value, wrapped);
-    } while (value != idx && !includeGenerated && treeItemAtIndex(value)->isGenerated());
+        value = nextItem(value, wrapped);
+    } while (value && value != item && !includeGenerated && value->isGenerated());
     return value;
 }
 
-QModelIndex SearchResultTreeModel::prevIndex(const QModelIndex &idx, bool *wrapped) const
+SearchResultTreeItem *SearchResultTreeModel::prevItem(SearchResultTreeItem *item,
+                                                      bool *wrapped) const
 {
-    QModelIndex current = idx;
+    SearchResultTreeItem *current = item ? item : m_rootItem;
     bool checkForChildren = true;
-    if (current.isValid()) {
-        int row = current.row();
+    if (current != m_rootItem) {
+        SearchResultTreeItem *parentItem = current->parent();
+        const int row = current->rowOfItem();
         if (row > 0) {
-            current = index(row - 1, 0, current.parent());
+            current = parentItem->childAt(row - 1);
         } else {
-            current = current.parent();
-            checkForChildren = !current.isValid();
+            current = parentItem;
+            checkForChildren = current == m_rootItem;
             if (checkForChildren && wrapped) {
                 // we start from the end
                 *wrapped = true;
@@ -544,22 +626,36 @@ QModelIndex SearchResultTreeModel::prevIndex(const QModelIndex &idx, bool *wrapp
     }
     if (checkForChildren) {
         // traverse down the hierarchy
-        while (int rc = rowCount(current)) {
-            current = index(rc - 1, 0, current);
-        }
+        while (current->childrenCount() > 0)
+            current = current->childAt(current->childrenCount() - 1);
     }
-    return current;
+    return current == m_rootItem ? nullptr : current;
 }
 
-QModelIndex SearchResultTreeModel::prev(const QModelIndex &idx, bool includeGenerated, bool *wrapped) const
+SearchResultTreeItem *SearchResultTreeModel::prev(SearchResultTreeItem *item,
+                                                  bool includeGenerated, bool *wrapped) const
 {
-    QModelIndex value = idx;
+    SearchResultTreeItem *value = item;
     do {
-        value = prevIndex(value, wrapped);
-    } while (value != idx && !includeGenerated && treeItemAtIndex(value)->isGenerated());
+        value = prevItem(value, wrapped);
+    } while (value && value != item && !includeGenerated && value->isGenerated());
     return value;
 }
 
+// Fetches the rows up to the item under all of its parents, so that the item has an index.
+QModelIndex SearchResultTreeModel::fetchIndex(SearchResultTreeItem *item)
+{
+    if (!item || item == m_rootItem)
+        return QModelIndex();
+
+    SearchResultTreeItem *parentItem = item->parent();
+    const QModelIndex parent = fetchIndex(parentItem);
+    const int row = item->rowOfItem();
+    fetchChildren(parent, parentItem, row + 1 - parentItem->fetchedChildrenCount());
+
+    return index(row, 0, parent);
+}
+
 SearchResultFilterModel::SearchResultFilterModel(QObject *parent) : QSortFilterProxyModel(parent)
 {
     setSourceModel(new SearchResultTreeModel(this));
@@ -606,32 +702,73 @@ void SearchResultFilterModel::clear()
     sourceModel()->clear();
 }
 
-QModelIndex SearchResultFilterModel::nextOrPrev(const QModelIndex &idx, bool *wrapped,
-        const std::function<QModelIndex (const QModelIndex &)> &func) const
+// Walks the items instead of the rows, because most of those might not be fetched.
+QList<SearchResultItem> SearchResultFilterModel::checkedItems() const
+{
+    QList<SearchResultItem> result;
+    const SearchResultTreeItem * const rootItem = sourceModel()->rootItem();
+    const int fileCount = rootItem->childrenCount();
+    for (int fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+        const SearchResultTreeItem * const fileItem = rootItem->childAt(fileIndex);
+        if (!isAccepted(fileItem))
+            continue;
+        const int itemCount = fileItem->childrenCount();
+        for (int itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+            const SearchResultTreeItem * const rowItem = fileItem->childAt(itemIndex);
+            if (rowItem->checkState() && isAccepted(rowItem))
+                result << rowItem->item;
+        }
+    }
+    return result;
+}
+
+QModelIndex SearchResultFilterModel::fetchIndex(SearchResultTreeItem *item)
+{
+    return mapFromSource(sourceModel()->fetchIndex(item));
+}
+
+SearchResultTreeItem *SearchResultFilterModel::nextOrPrev(const QModelIndex &idx, bool *wrapped,
+        const std::function<SearchResultTreeItem *(SearchResultTreeItem *)> &func) const
 {
     if (wrapped)
         *wrapped = false;
-    const QModelIndex sourceIndex = mapToSource(idx);
-    QModelIndex nextOrPrevSourceIndex = func(sourceIndex);
-    while (nextOrPrevSourceIndex != sourceIndex
-           && !filterAcceptsRow(nextOrPrevSourceIndex.row(), nextOrPrevSourceIndex.parent())) {
-        nextOrPrevSourceIndex = func(nextOrPrevSourceIndex);
-    }
-    return mapFromSource(nextOrPrevSourceIndex);
+    SearchResultTreeItem * const item = itemForIndex(idx);
+    SearchResultTreeItem *nextOrPrevItem = func(item);
+    while (nextOrPrevItem && nextOrPrevItem != item && !isAccepted(nextOrPrevItem))
+        nextOrPrevItem = func(nextOrPrevItem);
+    return nextOrPrevItem;
 }
 
-QModelIndex SearchResultFilterModel::next(const QModelIndex &idx, bool includeGenerated,
-                                          bool *wrapped) const
+SearchResultTreeItem *SearchResultFilterModel::next(const QModelIndex &idx, bool includeGenerated,
+                                                    bool *wrapped) const
 {
-    return nextOrPrev(idx, wrapped, [this, includeGenerated, wrapped](const QModelIndex &index) {
-        return sourceModel()->next(index, includeGenerated, wrapped); });
+    return nextOrPrev(idx, wrapped, [this, includeGenerated, wrapped](SearchResultTreeItem *item) {
+        return sourceModel()->next(item, includeGenerated, wrapped); });
 }
 
-QModelIndex SearchResultFilterModel::prev(const QModelIndex &idx, bool includeGenerated,
-                                          bool *wrapped) const
+SearchResultTreeItem *SearchResultFilterModel::prev(const QModelIndex &idx, bool includeGenerated,
+                                                    bool *wrapped) const
 {
-    return nextOrPrev(idx, wrapped, [this, includeGenerated, wrapped](const QModelIndex &index) {
-        return sourceModel()->prev(index, includeGenerated, wrapped); });
+    return nextOrPrev(idx, wrapped, [this, includeGenerated, wrapped](SearchResultTreeItem *item) {
+        return sourceModel()->prev(item, includeGenerated, wrapped); });
+}
+
+// The rows of a parent might not be fetched yet, so the count comes from its items.
+QVariant SearchResultFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (role == ItemDataRoles::ChildrenCountRole && m_filter) {
+        const SearchResultTreeItem * const item = itemForIndex(index);
+        if (!item)
+            return QVariant();
+        int count = 0;
+        const int childCount = item->childrenCount();
+        for (int i = 0; i < childCount; ++i) {
+            if (filterAcceptsItem(item->childAt(i)))
+                ++count;
+        }
+        return count;
+    }
+    return QSortFilterProxyModel::data(index, role);
 }
 
 SearchResultTreeItem *SearchResultFilterModel::itemForIndex(const QModelIndex &index) const
@@ -646,13 +783,24 @@ bool SearchResultFilterModel::filterAcceptsRow(int source_row,
     const SearchResultTreeItem * const item = SearchResultTreeModel::treeItemAtIndex(idx);
     if (!item)
         return false;
+    return isAccepted(item);
+}
+
+bool SearchResultFilterModel::isAccepted(const SearchResultTreeItem *item) const
+{
     if (!m_filter)
         return true;
+    return filterAcceptsItem(item);
+}
+
+// Looks at the items instead of the source rows, because those might not be fetched yet.
+bool SearchResultFilterModel::filterAcceptsItem(const SearchResultTreeItem *item) const
+{
     if (item->item.userData().isValid())
         return m_filter->matches(item->item);
-    const int childCount = sourceModel()->rowCount(idx);
+    const int childCount = item->childrenCount();
     for (int i = 0; i < childCount; ++i) {
-        if (filterAcceptsRow(i, idx))
+        if (filterAcceptsItem(item->childAt(i)))
             return true;
     }
     return false;
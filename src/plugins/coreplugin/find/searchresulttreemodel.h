@@ -50,10 +50,15 @@ public:
     void setTextEditorFont(const QFont &font, const SearchResultColors &colors);
     QList<QModelIndex> addResults(const QList<SearchResultItem> &items, SearchResult::AddMode mode);
     void clear();
-    QModelIndex next(const QModelIndex &idx, bool includeGenerated = false,
-                     bool *wrapped = nullptr) const;
-    QModelIndex prev(const QModelIndex &idx, bool includeGenerated = false,
-                     bool *wrapped = nullptr) const;
+    QList<SearchResultItem> checkedItems() const;
+    SearchResultTreeItem *next(const QModelIndex &idx, bool includeGenerated = false,
+                               bool *wrapped = nullptr) const;
+    SearchResultTreeItem *prev(const QModelIndex &idx, bool includeGenerated = false,
+                               bool *wrapped = nullptr) const;
+    // Fetches the rows needed to show an item found by next() or prev().
+    QModelIndex fetchIndex(SearchResultTreeItem *item);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
     SearchResultTreeItem *itemForIndex(const QModelIndex &index) const;
 
@@ -62,9 +67,12 @@ signals:
 
 private:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
+    bool filterAcceptsItem(const SearchResultTreeItem *item) const;
+    bool isAccepted(const SearchResultTreeItem *item) const;
 
-    QModelIndex nextOrPrev(const QModelIndex &idx, bool *wrapped,
-                           const std::function<QModelIndex(const QModelIndex &)> &func) const;
+    SearchResultTreeItem *nextOrPrev(
+        const QModelIndex &idx, bool *wrapped,
+        const std::function<SearchResultTreeItem *(SearchResultTreeItem *)> &func) const;
     SearchResultTreeModel *sourceModel() const;
 
     SearchResultFilter *m_filter = nullptr;
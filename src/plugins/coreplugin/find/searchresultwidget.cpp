@@ -391,7 +391,8 @@ void SearchResultWidget::goToNext()
 {
     if (m_count == 0)
         return;
-    QModelIndex idx = m_searchResultTreeView->model()->next(m_searchResultTreeView->currentIndex());
+    SearchResultFilterModel *model = m_searchResultTreeView->model();
+    QModelIndex idx = model->fetchIndex(model->next(m_searchResultTreeView->currentIndex()));
     if (idx.isValid()) {
         m_searchResultTreeView->setCurrentIndex(idx);
         m_searchResultTreeView->emitJumpToSearchResult(idx);
@@ -402,7 +403,8 @@ void SearchResultWidget::goToPrevious()
 {
     if (!m_searchResultTreeView->model()->rowCount())
         return;
-    QModelIndex idx = m_searchResultTreeView->model()->prev(m_searchResultTreeView->currentIndex());
+    SearchResultFilterModel *model = m_searchResultTreeView->model();
+    QModelIndex idx = model->fetchIndex(model->prev(m_searchResultTreeView->currentIndex()));
     if (idx.isValid()) {
         m_searchResultTreeView->setCurrentIndex(idx);
         m_searchResultTreeView->emitJumpToSearchResult(idx);
@@ -520,21 +522,7 @@ void SearchResultWidget::searchAgain()
 
 QList<SearchResultItem> SearchResultWidget::checkedItems() const
 {
-    QList<SearchResultItem> result;
-    SearchResultFilterModel *model = m_searchResultTreeView->model();
-    const int fileCount = model->rowCount();
-    for (int i = 0; i < fileCount; ++i) {
-        const QModelIndex fileIndex = model->index(i, 0);
-        const int itemCount = model->rowCount(fileIndex);
-        for (int rowIndex = 0; rowIndex < itemCount; ++rowIndex) {
-            const QModelIndex textIndex = model->index(rowIndex, 0, fileIndex);
-            const SearchResultTreeItem * const rowItem = model->itemForIndex(textIndex);
-            QTC_ASSERT(rowItem != nullptr, continue);
-            if (rowItem->checkState())
-                result << rowItem->item;
-        }
-    }
-    return result;
+    return m_searchResultTreeView->model()->checkedItems();
 }
 
 void SearchResultWidget::updateMatchesFoundLabel()
@@ -40,14 +40,22 @@
 #include <coreplugin/progressmanager/progressmanager.h>
 
 #include <cplusplus/LookupContext.h>
+#include <cplusplus/Overview.h>
+#include <utils/mapreduce.h>
 #include <utils/qtcassert.h>
 #include <utils/runextensions.h>
 #include <utils/stringutils.h>
 #include <utils/temporarydirectory.h>
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QElapsedTimer>
+#include <QMutex>
 #include <QRegularExpression>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
 
 using namespace CppTools;
 using namespace CppTools::Internal;
@@ -55,6 +63,134 @@ using namespace CppTools::Internal;
 static const bool FindErrorsIndexing = qgetenv("QTC_FIND_ERRORS_INDEXING") == "1";
 static Q_LOGGING_CATEGORY(indexerLog, "qtc.cpptools.indexer", QtWarningMsg)
 
+namespace CppTools {
+namespace Internal {
+
+// Keeps the SearchSymbols trees of the documents in the snapshot, one per document and
+// symbol types, so that repeated searches only need to match. An entry is identified by the
+// document instance it was created from; reparsing a file creates a new instance. The least
+// recently used trees are dropped when the cache holds too many items.
+class SearchSymbolsCache
+{
+public:
+    IndexItem::Ptr searchSymbols(SearchSymbols &search, const CPlusPlus::Document::Ptr &doc,
+                                 SymbolSearcher::SymbolTypes types)
+    {
+        const Key key(doc->fileName(), int(types));
+        {
+            QMutexLocker locker(&m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end() && it->document.toStrongRef() == doc) {
+                it->lastUse = ++m_useCount;
+                return it->root;
+            }
+        }
+
+        Entry entry;
+        entry.document = doc;
+        entry.root = search(doc);
+        entry.root->visitAllChildren([&entry](const IndexItem::Ptr &) {
+            ++entry.itemCount;
+            return IndexItem::Recurse;
+        });
+
+        QMutexLocker locker(&m_mutex);
+        entry.lastUse = ++m_useCount;
+        m_itemCount += entry.itemCount;
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            m_itemCount -= it->itemCount;
+            *it = entry;
+        } else {
+            m_entries.insert(key, entry);
+        }
+        if (m_itemCount > MaximumItemCount)
+            removeLeastRecentlyUsedEntries();
+        return entry.root;
+    }
+
+    void removeObsoleteEntries()
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+            if (it->document.isNull()) {
+                m_itemCount -= it->itemCount;
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    using Key = QPair<QString, int>;
+
+    struct Entry
+    {
+        QWeakPointer<CPlusPlus::Document> document;
+        IndexItem::Ptr root;
+        int itemCount = 0;
+        quint64 lastUse = 0;
+    };
+
+    enum { MaximumItemCount = 500000 };
+
+    // Drops down to three quarters of the maximum, so that the next searches do not need
+    // to drop entries right away.
+    void removeLeastRecentlyUsedEntries()
+    {
+        QVector<QPair<quint64, Key>> uses;
+        uses.reserve(m_entries.size());
+        for (auto it = m_entries.cbegin(), end = m_entries.cend(); it != end; ++it)
+            uses.append({it->lastUse, it.key()});
+        std::sort(uses.begin(), uses.end());
+
+        for (const QPair<quint64, Key> &use : qAsConst(uses)) {
+            if (m_itemCount <= MaximumItemCount / 4 * 3)
+                break;
+            m_itemCount -= m_entries.take(use.second).itemCount;
+        }
+    }
+
+    QMutex m_mutex;
+    QHash<Key, Entry> m_entries;
+    qint64 m_itemCount = 0;
+    quint64 m_useCount = 0;
+};
+
+// Remembers the exported surface fingerprint of the documents of the last pass, so that the
+// fingerprint of a document is only computed once: the new document of one pass is the previous
+// document of the next one. Entries are identified by the document instance they belong to.
+class SurfaceFingerprintCache
+{
+public:
+    QByteArray fingerprint(const CPlusPlus::Document::Ptr &document);
+
+    void removeObsoleteEntries()
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+            if (it->document.isNull())
+                it = m_entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        QWeakPointer<CPlusPlus::Document> document;
+        QByteArray fingerprint;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+};
+
+} // namespace Internal
+} // namespace CppTools
+
 namespace {
 
 class ParseParams
@@ -64,6 +200,14 @@ public:
     WorkingCopy workingCopy;
     QSet<QString> sourceFiles;
     int indexerFileSizeLimitInMb = -1;
+    int indexerThreadCount = 1;
+    CPlusPlus::Snapshot snapshot;
+    // Reindexes the files depending on a changed exported surface.
+    std::function<void (const QSet<QString> &)> reindexDependents;
+    std::shared_ptr<SurfaceFingerprintCache> surfaceFingerprints;
+    // Set if the cached document summaries should be restored. Returns the source files
+    // that need not be parsed.
+    std::function<QSet<QString> ()> restoreSummaries;
 };
 
 class WriteTaskFileForDiagnostics
@@ -241,20 +385,289 @@ void index(QFutureInterface<void> &indexingFuture,
     qCDebug(indexerLog) << "Indexing finished.";
 }
 
-void parse(QFutureInterface<void> &indexingFuture, const ParseParams params)
+class ParallelIndexingState
+{
+public:
+    ParallelIndexingState(const QStringList &files, int sourceCount)
+        : files(files)
+        , sourceCount(sourceCount)
+    {}
+
+    // Workers grab the next unprocessed file instead of a fixed share, so that a worker busy
+    // with expensive translation units does not hold back the others.
+    int takeNextFile()
+    {
+        const int index = m_nextFile.fetch_add(1);
+        return index < files.size() ? index : -1;
+    }
+
+    int markFileDone() { return ++m_doneFiles; }
+
+    const QStringList files;
+    const int sourceCount;
+    CppSourceProcessor::SharedDocuments documents;
+
+private:
+    std::atomic_int m_nextFile{0};
+    std::atomic_int m_doneFiles{0};
+};
+
+void indexWorker(QFutureInterface<void> &indexingFuture,
+                 const ParseParams &params,
+                 ParallelIndexingState &state,
+                 int workerId)
+{
+    QScopedPointer<CppSourceProcessor> sourceProcessor(CppModelManager::createSourceProcessor());
+    sourceProcessor->setFileSizeLimitInMb(params.indexerFileSizeLimitInMb);
+    sourceProcessor->setWorkingCopy(params.workingCopy);
+    sourceProcessor->setSharedDocuments(&state.documents);
+
+    foreach (const QString &file, params.sourceFiles)
+        sourceProcessor->removeFromCache(file);
+
+    const QString conf = CppModelManager::configurationFileName();
+    bool processingHeaders = false;
+
+    CppModelManager *cmm = CppModelManager::instance();
+    const ProjectExplorer::HeaderPaths fallbackHeaderPaths = cmm->headerPaths();
+    const CPlusPlus::LanguageFeatures defaultFeatures =
+            CPlusPlus::LanguageFeatures::defaultFeatures();
+
+    QElapsedTimer timer;
+    timer.start();
+    int indexedFiles = 0;
+
+    for (int i = state.takeNextFile(); i != -1; i = state.takeNextFile()) {
+        if (indexingFuture.isCanceled())
+            break;
+
+        const QString fileName = state.files.at(i);
+        const QList<ProjectPart::Ptr> parts = cmm->projectPart(fileName);
+        const CPlusPlus::LanguageFeatures languageFeatures = parts.isEmpty()
+                ? defaultFeatures
+                : parts.first()->languageFeatures;
+        sourceProcessor->setLanguageFeatures(languageFeatures);
+
+        const bool isSourceFile = i < state.sourceCount;
+        if (isSourceFile) {
+            (void) sourceProcessor->run(conf);
+        } else if (!processingHeaders) {
+            (void) sourceProcessor->run(conf);
+
+            processingHeaders = true;
+        }
+
+        qCDebug(indexerLog) << "  Worker" << workerId << "indexing" << i + 1 << "of"
+                            << state.files.size() << ":" << fileName;
+        ProjectExplorer::HeaderPaths headerPaths = parts.isEmpty()
+                ? fallbackHeaderPaths
+                : parts.first()->headerPaths;
+        sourceProcessor->setHeaderPaths(headerPaths);
+        sourceProcessor->run(fileName);
+        ++indexedFiles;
+
+        indexingFuture.setProgressValue(state.markFileDone());
+
+        if (isSourceFile)
+            sourceProcessor->resetEnvironment();
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    qCDebug(indexerLog).nospace() << "Worker " << workerId << " indexed " << indexedFiles
+                                  << " files in " << elapsed << " ms ("
+                                  << (elapsed > 0 ? indexedFiles * 1000.0 / elapsed : 0.0)
+                                  << " files/s).";
+}
+
+void indexInParallel(QFutureInterface<void> &indexingFuture,
+                     const ParseParams &params,
+                     int workerCount)
+{
+    QStringList sources;
+    QStringList headers;
+    classifyFiles(params.sourceFiles, &headers, &sources);
+    ParallelIndexingState state(sources + headers, sources.size());
+
+    qCDebug(indexerLog) << "About to index" << state.files.size() << "files with"
+                        << workerCount << "workers.";
+    QElapsedTimer timer;
+    timer.start();
+
+    // The calling thread is worker 0. The other workers get a pool of their own, so they
+    // neither wait for nor block the jobs of the model manager's shared pool.
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerCount - 1);
+    pool.setStackSize(CppModelManager::instance()->sharedThreadPool()->stackSize());
+    for (int workerId = 1; workerId < workerCount; ++workerId) {
+        Utils::runAsync(&pool, [&indexingFuture, &params, &state, workerId] {
+            indexWorker(indexingFuture, params, state, workerId);
+        });
+    }
+    indexWorker(indexingFuture, params, state, 0);
+    pool.waitForDone();
+
+    qCDebug(indexerLog) << "Indexing finished in" << timer.elapsed() << "ms.";
+}
+
+void addScopeToSurface(QCryptographicHash &hash,
+                       const CPlusPlus::Scope *scope,
+                       const CPlusPlus::Overview &overview)
+{
+    using namespace CPlusPlus;
+
+    for (int i = 0, end = scope->memberCount(); i < end; ++i) {
+        const Symbol *member = scope->memberAt(i);
+        hash.addData(overview.prettyName(member->name()).toUtf8());
+        hash.addData(overview.prettyType(member->type()).toUtf8());
+        hash.addData(QByteArray::number(member->storage()));
+        hash.addData(QByteArray::number(member->visibility()));
+        if (const Declaration *declaration = member->asDeclaration()) {
+            if (const EnumeratorDeclaration *enumerator = declaration->asEnumeratorDeclarator()) {
+                if (const StringLiteral *value = enumerator->constantValue())
+                    hash.addData(value->chars(), value->size());
+            }
+        }
+
+        // Function bodies are not visible to the documents including this one.
+        if (member->isFunction() || member->isBlock())
+            continue;
+        if (const Scope *memberScope = member->asScope())
+            addScopeToSurface(hash, memberScope, overview);
+    }
+}
+
+// Hashes what documents including this one can observe: includes, macros and declarations.
+QByteArray exportedSurfaceFingerprint(const CPlusPlus::Document::Ptr &document)
 {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach (const QString &includedFile, document->includedFiles())
+        hash.addData(includedFile.toUtf8());
+
+    foreach (const CPlusPlus::Macro &macro, document->definedMacros()) {
+        hash.addData(macro.isHidden() ? "#undef " : "#define ");
+        hash.addData(macro.name());
+        hash.addData(" ", 1);
+        hash.addData(macro.definitionText());
+    }
+
+    if (const CPlusPlus::Namespace *globalNamespace = document->globalNamespace())
+        addScopeToSurface(hash, globalNamespace, CPlusPlus::Overview());
+
+    return hash.result();
+}
+
+// Returns the documents directly including a reindexed document whose exported surface
+// changed. Edits in function bodies or comments do not affect these. Once reindexed, the
+// surfaces of the includers are checked in turn, so changes only spread as far as they are
+// visible. If a header is included by too many documents, they are not reindexed, as before.
+QSet<QString> dependentsOfChangedSurfaces(const ParseParams &params)
+{
+    enum { MaximumDependentCount = 500 };
+
+    CppModelManager *cmm = CppModelManager::instance();
+
+    QHash<QString, QStringList> includers;
+    for (auto it = params.snapshot.begin(), end = params.snapshot.end(); it != end; ++it) {
+        foreach (const QString &includedFile, it.value()->includedFiles())
+            includers[includedFile].append(it.key().toString());
+    }
+
+    const auto isQueued = [&params](const QString &fileName) {
+        return params.sourceFiles.contains(fileName);
+    };
+
+    SurfaceFingerprintCache &fingerprints = *params.surfaceFingerprints;
+    QSet<QString> dependents;
+    for (const QString &fileName : params.sourceFiles) {
+        // Includers that are reindexed anyway are checked on their own.
+        const QStringList fileIncluders = includers.value(fileName);
+        if (std::all_of(fileIncluders.cbegin(), fileIncluders.cend(), isQueued))
+            continue;
+        const CPlusPlus::Document::Ptr previousDocument = params.snapshot.document(fileName);
+        const CPlusPlus::Document::Ptr document = cmm->document(fileName);
+        if (!previousDocument || !document || previousDocument == document)
+            continue;
+        if (fingerprints.fingerprint(previousDocument) == fingerprints.fingerprint(document))
+            continue;
+
+        qCDebug(indexerLog) << "Exported surface of" << fileName << "changed.";
+        for (const QString &includer : fileIncluders) {
+            if (!isQueued(includer))
+                dependents.insert(includer);
+        }
+    }
+    dependents.remove(CppModelManager::configurationFileName());
+    fingerprints.removeObsoleteEntries();
+
+    if (dependents.size() > MaximumDependentCount) {
+        qCDebug(indexerLog) << "Not reindexing" << dependents.size() << "dependent files.";
+        return {};
+    }
+    return dependents;
+}
+
+} // anonymous namespace
+
+namespace CppTools {
+namespace Internal {
+
+QByteArray SurfaceFingerprintCache::fingerprint(const CPlusPlus::Document::Ptr &document)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        const Entry entry = m_entries.value(document->fileName());
+        if (entry.document.toStrongRef() == document)
+            return entry.fingerprint;
+    }
+
+    Entry entry;
+    entry.document = document;
+    entry.fingerprint = exportedSurfaceFingerprint(document);
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(document->fileName(), entry);
+    return entry.fingerprint;
+}
+
+} // namespace Internal
+} // namespace CppTools
+
+namespace {
+
+void parse(QFutureInterface<void> &indexingFuture, ParseParams params)
+{
+    if (params.restoreSummaries) {
+        const QSet<QString> upToDateFiles = params.restoreSummaries();
+        qCDebug(indexerLog) << "Skipping" << upToDateFiles.size()
+                            << "files with up to date summaries.";
+        params.sourceFiles.subtract(upToDateFiles);
+    }
+
     const QSet<QString> &files = params.sourceFiles;
     if (files.isEmpty())
         return;
 
     indexingFuture.setProgressRange(0, files.size());
 
+    const int workerCount = qMin(params.indexerThreadCount, files.size());
     if (FindErrorsIndexing)
         indexFindErrors(indexingFuture, params);
+    else if (workerCount > 1)
+        indexInParallel(indexingFuture, params, workerCount);
     else
         index(indexingFuture, params);
 
     indexingFuture.setProgressValue(files.size());
+
+    if (params.reindexDependents && !indexingFuture.isCanceled()) {
+        const QSet<QString> dependents = dependentsOfChangedSurfaces(params);
+        if (!dependents.isEmpty()) {
+            qCDebug(indexerLog) << "Reindexing" << dependents.size() << "dependent files.";
+            params.reindexDependents(dependents);
+        }
+    }
+
     CppModelManager::instance()->finishedRefreshingSourceFiles(files);
 }
 
@@ -262,23 +675,34 @@ class BuiltinSymbolSearcher: public SymbolSearcher
 {
 public:
     BuiltinSymbolSearcher(const CPlusPlus::Snapshot &snapshot,
-                          const Parameters &parameters, const QSet<QString> &fileNames)
+                          const Parameters &parameters, const QSet<QString> &fileNames,
+                          const std::shared_ptr<SearchSymbolsCache> &cache)
         : m_snapshot(snapshot)
         , m_parameters(parameters)
         , m_fileNames(fileNames)
+        , m_cache(cache)
     {}
 
     ~BuiltinSymbolSearcher() override = default;
 
     void runSearch(QFutureInterface<Core::SearchResultItem> &future) override
     {
-        future.setProgressRange(0, m_snapshot.size());
+        // Documents are searched in chunks, so that each map call has enough work to be
+        // worth the scheduling, while results can still be reported early and in order.
+        const int chunkSize = 32;
+        QVector<QVector<CPlusPlus::Document::Ptr>> chunks;
+        for (auto it = m_snapshot.begin(), end = m_snapshot.end(); it != end; ++it) {
+            if (!m_fileNames.isEmpty() && !m_fileNames.contains(it.value()->fileName()))
+                continue;
+            if (chunks.isEmpty() || chunks.last().size() == chunkSize)
+                chunks.append({});
+            chunks.last().append(it.value());
+        }
+
+        future.setProgressRange(0, chunks.size());
         future.setProgressValue(0);
-        int progress = 0;
 
-        SearchSymbols search;
-        search.setSymbolsToSearchFor(m_parameters.types);
-        CPlusPlus::Snapshot::const_iterator it = m_snapshot.begin();
+        m_cache->removeObsoleteEntries();
 
         QString findString = (m_parameters.flags & Core::FindRegularExpression
                               ? m_parameters.text : QRegularExpression::escape(m_parameters.text));
@@ -288,56 +712,74 @@ public:
                                                 ? QRegularExpression::NoPatternOption
                                                 : QRegularExpression::CaseInsensitiveOption));
         matcher.optimize();
-        while (it != m_snapshot.end()) {
-            if (future.isPaused())
-                future.waitForResume();
-            if (future.isCanceled())
-                break;
-            if (m_fileNames.isEmpty() || m_fileNames.contains(it.value()->fileName())) {
-                QVector<Core::SearchResultItem> resultItems;
-                auto filter = [&](const IndexItem::Ptr &info) -> IndexItem::VisitorResult {
-                    if (matcher.match(info->symbolName()).hasMatch()) {
-                        QString text = info->symbolName();
-                        QString scope = info->symbolScope();
-                        if (info->type() == IndexItem::Function) {
-                            QString name;
-                            info->unqualifiedNameAndScope(info->symbolName(), &name, &scope);
-                            text = name + info->symbolType();
-                        } else if (info->type() == IndexItem::Declaration){
-                            text = info->representDeclaration();
-                        }
-
-                        Core::SearchResultItem item;
-                        item.setPath(scope.split(QLatin1String("::"), Qt::SkipEmptyParts));
-                        item.setLineText(text);
-                        item.setIcon(info->icon());
-                        item.setUserData(QVariant::fromValue(info));
-                        resultItems << item;
-                    }
 
+        const auto searchChunk = [this, &future, &matcher](
+                const QVector<CPlusPlus::Document::Ptr> &documents) {
+            QVector<Core::SearchResultItem> resultItems;
+            SearchSymbols search;
+            search.setSymbolsToSearchFor(m_parameters.types);
+            for (const CPlusPlus::Document::Ptr &doc : documents) {
+                if (future.isPaused())
+                    future.waitForResume();
+                if (future.isCanceled())
+                    break;
+                const IndexItem::Ptr root = m_cache->searchSymbols(search, doc,
+                                                                   m_parameters.types);
+                root->visitAllChildren([&](const IndexItem::Ptr &info) {
+                    if (matcher.match(info->symbolName()).hasMatch())
+                        resultItems << searchResultItem(info);
                     return IndexItem::Recurse;
-                };
-                search(it.value())->visitAllChildren(filter);
-                if (!resultItems.isEmpty())
-                    future.reportResults(resultItems);
+                });
             }
-            ++it;
-            ++progress;
-            future.setProgressValue(progress);
-        }
+            return resultItems;
+        };
+        const auto reportChunk = [&future](int &progress,
+                                           const QVector<Core::SearchResultItem> &resultItems) {
+            if (!resultItems.isEmpty())
+                future.reportResults(resultItems);
+            future.setProgressValue(++progress);
+        };
+
+        QThreadPool pool;
+        Utils::mapReduce(chunks.cbegin(), chunks.cend(), searchChunk, 0, reportChunk,
+                         Utils::MapReduceOption::Ordered, &pool).waitForFinished();
+
         if (future.isPaused())
             future.waitForResume();
     }
 
 private:
+    static Core::SearchResultItem searchResultItem(const IndexItem::Ptr &info)
+    {
+        QString text = info->symbolName();
+        QString scope = info->symbolScope();
+        if (info->type() == IndexItem::Function) {
+            QString name;
+            info->unqualifiedNameAndScope(info->symbolName(), &name, &scope);
+            text = name + info->symbolType();
+        } else if (info->type() == IndexItem::Declaration){
+            text = info->representDeclaration();
+        }
+
+        Core::SearchResultItem item;
+        item.setPath(scope.split(QLatin1String("::"), Qt::SkipEmptyParts));
+        item.setLineText(text);
+        item.setIcon(info->icon());
+        item.setUserData(QVariant::fromValue(info));
+        return item;
+    }
+
     const CPlusPlus::Snapshot m_snapshot;
     const Parameters m_parameters;
     const QSet<QString> m_fileNames;
+    const std::shared_ptr<SearchSymbolsCache> m_cache;
 };
 
 } // anonymous namespace
 
 BuiltinIndexingSupport::BuiltinIndexingSupport()
+    : m_searchSymbolsCache(std::make_shared<SearchSymbolsCache>())
+    , m_surfaceFingerprintCache(std::make_shared<SurfaceFingerprintCache>())
 {
     m_synchronizer.setCancelOnWait(true);
 }
@@ -346,14 +788,31 @@ BuiltinIndexingSupport::~BuiltinIndexingSupport() = default;
 
 QFuture<void> BuiltinIndexingSupport::refreshSourceFiles(
     const QSet<QString> &sourceFiles, CppModelManager::ProgressNotificationMode mode)
+{
+    return refreshSourceFiles(sourceFiles, mode, {});
+}
+
+QFuture<void> BuiltinIndexingSupport::refreshSourceFiles(
+    const QSet<QString> &sourceFiles,
+    CppModelManager::ProgressNotificationMode mode,
+    const std::function<QSet<QString> ()> &restoreSummaries)
 {
     CppModelManager *mgr = CppModelManager::instance();
 
     ParseParams params;
     params.indexerFileSizeLimitInMb = indexerFileSizeLimitInMb();
+    params.indexerThreadCount = indexerThreadCount();
     params.headerPaths = mgr->headerPaths();
     params.workingCopy = mgr->workingCopy();
     params.sourceFiles = sourceFiles;
+    params.snapshot = mgr->snapshot();
+    params.restoreSummaries = restoreSummaries;
+    params.surfaceFingerprints = m_surfaceFingerprintCache;
+    params.reindexDependents = [this, mgr](const QSet<QString> &dependents) {
+        QMetaObject::invokeMethod(mgr, [this, dependents] {
+            refreshSourceFiles(dependents, CppModelManager::ReservedProgressNotification);
+        }, Qt::QueuedConnection);
+    };
 
     QFuture<void> result = Utils::runAsync(mgr->sharedThreadPool(), parse, params);
 
@@ -381,7 +840,8 @@ QFuture<void> BuiltinIndexingSupport::refreshSourceFiles(
 SymbolSearcher *BuiltinIndexingSupport::createSymbolSearcher(
         const SymbolSearcher::Parameters &parameters, const QSet<QString> &fileNames)
 {
-    return new BuiltinSymbolSearcher(CppModelManager::instance()->snapshot(), parameters, fileNames);
+    return new BuiltinSymbolSearcher(CppModelManager::instance()->snapshot(), parameters, fileNames,
+                                     m_searchSymbolsCache);
 }
 
 bool BuiltinIndexingSupport::isFindErrorsIndexingActive()
@@ -30,9 +30,15 @@
 
 #include <QFutureSynchronizer>
 
+#include <functional>
+#include <memory>
+
 namespace CppTools {
 namespace Internal {
 
+class SearchSymbolsCache;
+class SurfaceFingerprintCache;
+
 class BuiltinIndexingSupport: public CppIndexingSupport {
 public:
     BuiltinIndexingSupport();
@@ -40,6 +46,11 @@ public:
 
     QFuture<void> refreshSourceFiles(const QSet<QString> &sourceFiles,
                                      CppModelManager::ProgressNotificationMode mode) override;
+    // Calls restoreSummaries in the indexing thread first, and does not parse the source
+    // files it returns.
+    QFuture<void> refreshSourceFiles(const QSet<QString> &sourceFiles,
+                                     CppModelManager::ProgressNotificationMode mode,
+                                     const std::function<QSet<QString> ()> &restoreSummaries);
     SymbolSearcher *createSymbolSearcher(const SymbolSearcher::Parameters &parameters,
                                          const QSet<QString> &fileNames) override;
 
@@ -48,6 +59,8 @@ public:
 
 private:
     QFutureSynchronizer<void> m_synchronizer;
+    std::shared_ptr<SearchSymbolsCache> m_searchSymbolsCache;
+    std::shared_ptr<SurfaceFingerprintCache> m_surfaceFingerprintCache;
 };
 
 } // namespace Internal
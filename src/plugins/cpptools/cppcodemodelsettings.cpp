@@ -60,6 +60,12 @@ static QString skipIndexingBigFilesKey()
 static QString indexerFileSizeLimitKey()
 { return QLatin1String(Constants::CPPTOOLS_INDEXER_FILE_SIZE_LIMIT); }
 
+static QString indexerThreadCountKey()
+{ return QLatin1String(Constants::CPPTOOLS_INDEXER_THREAD_COUNT); }
+
+static QString cacheDocumentSummariesKey()
+{ return QLatin1String(Constants::CPPTOOLS_CACHE_DOCUMENT_SUMMARIES); }
+
 static Utils::Id clangDiagnosticConfigIdFromSettings(QSettings *s)
 {
     QTC_ASSERT(s->group() == QLatin1String(Constants::CPPTOOLS_SETTINGSGROUP), return Utils::Id());
@@ -160,6 +166,12 @@ void CppCodeModelSettings::fromSettings(QSettings *s)
     const QVariant indexerFileSizeLimit = s->value(indexerFileSizeLimitKey(), 5);
     setIndexerFileSizeLimitInMb(indexerFileSizeLimit.toInt());
 
+    const QVariant indexerThreadCount = s->value(indexerThreadCountKey(), 1);
+    setIndexerThreadCount(indexerThreadCount.toInt());
+
+    const QVariant cacheDocumentSummaries = s->value(cacheDocumentSummariesKey(), true);
+    setCacheDocumentSummaries(cacheDocumentSummaries.toBool());
+
     s->endGroup();
 
     if (write)
@@ -183,6 +195,8 @@ void CppCodeModelSettings::toSettings(QSettings *s)
     s->setValue(interpretAmbiguousHeadersAsCHeadersKey(), interpretAmbigiousHeadersAsCHeaders());
     s->setValue(skipIndexingBigFilesKey(), skipIndexingBigFiles());
     s->setValue(indexerFileSizeLimitKey(), indexerFileSizeLimitInMb());
+    s->setValue(indexerThreadCountKey(), indexerThreadCount());
+    s->setValue(cacheDocumentSummariesKey(), cacheDocumentSummaries());
 
     s->endGroup();
 
@@ -273,6 +287,26 @@ void CppCodeModelSettings::setIndexerFileSizeLimitInMb(int sizeInMB)
     m_indexerFileSizeLimitInMB = sizeInMB;
 }
 
+int CppCodeModelSettings::indexerThreadCount() const
+{
+    return m_indexerThreadCount;
+}
+
+void CppCodeModelSettings::setIndexerThreadCount(int threadCount)
+{
+    m_indexerThreadCount = qMax(0, threadCount);
+}
+
+bool CppCodeModelSettings::cacheDocumentSummaries() const
+{
+    return m_cacheDocumentSummaries;
+}
+
+void CppCodeModelSettings::setCacheDocumentSummaries(bool yesno)
+{
+    m_cacheDocumentSummaries = yesno;
+}
+
 bool CppCodeModelSettings::enableLowerClazyLevels() const
 {
     return m_enableLowerClazyLevels;
@@ -76,6 +76,13 @@ public:
     int indexerFileSizeLimitInMb() const;
     void setIndexerFileSizeLimitInMb(int sizeInMB);
 
+    // 0 means one worker per core.
+    int indexerThreadCount() const;
+    void setIndexerThreadCount(int threadCount);
+
+    bool cacheDocumentSummaries() const;
+    void setCacheDocumentSummaries(bool yesno);
+
 signals:
     void clangDiagnosticConfigsInvalidated(const QVector<Utils::Id> &configId);
     void changed();
@@ -85,6 +92,8 @@ private:
     bool m_interpretAmbigiousHeadersAsCHeaders = false;
     bool m_skipIndexingBigFiles = true;
     int m_indexerFileSizeLimitInMB = 5;
+    int m_indexerThreadCount = 1;
+    bool m_cacheDocumentSummaries = true;
     ClangDiagnosticConfigs m_clangCustomDiagnosticConfigs;
     Utils::Id m_clangDiagnosticConfigId;
     bool m_enableLowerClazyLevels = true; // For UI behavior only
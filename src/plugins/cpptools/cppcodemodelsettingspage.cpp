@@ -114,6 +114,8 @@ void CppCodeModelSettingsWidget::setupGeneralWidgets()
 
     m_ui->skipIndexingBigFilesCheckBox->setChecked(m_settings->skipIndexingBigFiles());
     m_ui->bigFilesLimitSpinBox->setValue(m_settings->indexerFileSizeLimitInMb());
+    m_ui->indexerThreadCountSpinBox->setValue(m_settings->indexerThreadCount());
+    m_ui->cacheDocumentSummariesCheckBox->setChecked(m_settings->cacheDocumentSummaries());
 
     const bool ignorePch = m_settings->pchUsage() == CppCodeModelSettings::PchUse_None;
     m_ui->ignorePCHCheckBox->setChecked(ignorePch);
@@ -163,6 +165,16 @@ bool CppCodeModelSettingsWidget::applyGeneralWidgetsToSettings() const
         m_settings->setIndexerFileSizeLimitInMb(newFileSizeLimit);
         settingsChanged = true;
     }
+    const int newIndexerThreadCount = m_ui->indexerThreadCountSpinBox->value();
+    if (m_settings->indexerThreadCount() != newIndexerThreadCount) {
+        m_settings->setIndexerThreadCount(newIndexerThreadCount);
+        settingsChanged = true;
+    }
+    const bool newCacheDocumentSummaries = m_ui->cacheDocumentSummariesCheckBox->isChecked();
+    if (m_settings->cacheDocumentSummaries() != newCacheDocumentSummaries) {
+        m_settings->setCacheDocumentSummaries(newCacheDocumentSummaries);
+        settingsChanged = true;
+    }
 
     const bool newIgnorePch = m_ui->ignorePCHCheckBox->isChecked();
     const bool previousIgnorePch = m_settings->pchUsage() == CppCodeModelSettings::PchUse_None;
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "cppsourceprocessertesthelper.h"
+#include "cpptoolsplugin.h"
+
+#include <cplusplus/Control.h>
+#include <cplusplus/CppDocument.h>
+#include <cplusplus/Literals.h>
+#include <cplusplus/MemoryPool.h>
+
+#include <QtTest>
+
+#include <cstring>
+
+using namespace CPlusPlus;
+
+namespace CppTools {
+namespace Internal {
+
+// Literals with the same characters share one buffer across controls, which stays valid
+// for as long as one of them is alive.
+void CppToolsPlugin::test_documentmemory_sharedLiterals()
+{
+    QScopedPointer<Control> first(new Control);
+    QScopedPointer<Control> second(new Control);
+
+    const Identifier *firstIdentifier = first->identifier("sharedIdentifier");
+    const Identifier *secondIdentifier = second->identifier("sharedIdentifier");
+    QVERIFY(firstIdentifier != secondIdentifier);
+    QVERIFY(firstIdentifier->chars() == secondIdentifier->chars());
+    QVERIFY(first->identifier("otherIdentifier")->chars() != firstIdentifier->chars());
+    QCOMPARE(first->findIdentifier("sharedIdentifier", 16), firstIdentifier);
+    QVERIFY(!second->findIdentifier("otherIdentifier", 15));
+
+    const StringLiteral *firstString = first->stringLiteral("\"text\"", 6);
+    const StringLiteral *secondString = second->stringLiteral("\"text\"", 6);
+    QVERIFY(firstString->chars() == secondString->chars());
+
+    first.reset();
+    QCOMPARE(QByteArray(secondIdentifier->chars(), secondIdentifier->size()),
+             QByteArray("sharedIdentifier"));
+    QCOMPARE(QByteArray(secondString->chars(), secondString->size()), QByteArray("\"text\""));
+}
+
+// Blocks of destroyed pools are handed to new pools; they must behave like fresh ones.
+void CppToolsPlugin::test_documentmemory_recycledPools()
+{
+    // Spans more blocks than a pool starts with.
+    const int allocationSize = 1000;
+    const int allocationCount = 512;
+
+    for (int round = 0; round < 3; ++round) {
+        MemoryPool pool;
+        QVector<char *> allocations;
+        for (int i = 0; i < allocationCount; ++i) {
+            char *allocation = static_cast<char *>(pool.allocate(allocationSize));
+            std::memset(allocation, i & 0x7f, allocationSize);
+            allocations.append(allocation);
+        }
+        for (int i = 0; i < allocationCount; ++i) {
+            const char *allocation = allocations.at(i);
+            QCOMPARE(int(allocation[0]), i & 0x7f);
+            QCOMPARE(int(allocation[allocationSize - 1]), i & 0x7f);
+        }
+    }
+}
+
+void CppToolsPlugin::test_documentmemory_benchmark_data()
+{
+    QTest::addColumn<bool>("recycle");
+    QTest::addColumn<bool>("countBytes");
+
+    QTest::newRow("recycled, allocations") << true << false;
+    QTest::newRow("recycled, bytes") << true << true;
+    QTest::newRow("not recycled, allocations") << false << false;
+    QTest::newRow("not recycled, bytes") << false << true;
+}
+
+// Parses and checks the same file as many documents, as the indexer does, and reports the
+// memory pool blocks and literal characters taken from the system allocator per document.
+void CppToolsPlugin::test_documentmemory_benchmark()
+{
+    QFETCH(bool, recycle);
+    QFETCH(bool, countBytes);
+
+    const QByteArray source = Tests::TestSources::lexerSource();
+    QVERIFY(!source.isEmpty());
+    const int documentCount = 50;
+
+    const auto allocations = [countBytes] {
+        return countBytes ? MemoryPool::allocatedBlockBytes() + Literal::allocatedCharactersBytes()
+                          : MemoryPool::allocatedBlockCount() + Literal::allocatedCharactersCount();
+    };
+
+    MemoryPool::setBlockRecyclingEnabled(recycle);
+    Literal::setCharacterSharingEnabled(recycle);
+    const unsigned long long allocationsBefore = allocations();
+    {
+        QList<Document::Ptr> documents;
+        for (int i = 0; i < documentCount; ++i) {
+            Document::Ptr document = Document::create(QString("file%1.cpp").arg(i));
+            document->setUtf8Source(source);
+            document->parse();
+            document->check();
+            document->releaseSourceAndAST();
+            documents.append(document);
+        }
+    }
+    const unsigned long long allocationsAfter = allocations();
+    MemoryPool::setBlockRecyclingEnabled(true);
+    Literal::setCharacterSharingEnabled(true);
+
+    QTest::setBenchmarkResult(qreal(allocationsAfter - allocationsBefore) / documentCount,
+                              countBytes ? QTest::BytesAllocated : QTest::Events);
+}
+
+} // namespace Internal
+} // namespace CppTools
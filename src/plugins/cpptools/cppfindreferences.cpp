@@ -50,6 +50,8 @@
 #include <QCheckBox>
 #include <QDir>
 #include <QFutureWatcher>
+#include <QMutex>
+#include <QTimer>
 #include <QVBoxLayout>
 
 #include <functional>
@@ -169,6 +171,88 @@ static QList<QByteArray> fullIdForSymbol(CPlusPlus::Symbol *symbol)
     return uid;
 }
 
+namespace CppTools {
+namespace Internal {
+
+// Keeps the usages found per file for the last searched symbols. An entry is only used while
+// the file's document and working copy revisions are unchanged, and the whole cache is dropped
+// whenever the code model snapshot changes, since the lookups depend on the other documents, too.
+// Results of a search that started before the last clear() are not stored.
+class FindUsagesCache
+{
+public:
+    struct FileRevision
+    {
+        unsigned document = 0;
+        unsigned workingCopy = 0;
+
+        bool operator==(const FileRevision &other) const
+        { return document == other.document && workingCopy == other.workingCopy; }
+    };
+
+    int generation() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_generation;
+    }
+
+    bool find(const QByteArray &symbolKey, const Utils::FilePath &fileName,
+              const FileRevision &revision, QList<CPlusPlus::Usage> *usages) const
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto symbolIt = m_symbols.constFind(symbolKey);
+        if (symbolIt == m_symbols.constEnd())
+            return false;
+        const auto fileIt = symbolIt->constFind(fileName);
+        if (fileIt == symbolIt->constEnd() || !(fileIt->revision == revision))
+            return false;
+        *usages = fileIt->usages;
+        return true;
+    }
+
+    void insert(int generation, const QByteArray &symbolKey, const Utils::FilePath &fileName,
+                const FileRevision &revision, const QList<CPlusPlus::Usage> &usages)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (generation != m_generation)
+            return;
+        if (!m_symbols.contains(symbolKey)) {
+            if (m_order.size() >= MaxSymbols)
+                m_symbols.remove(m_order.takeFirst());
+            m_order.append(symbolKey);
+        } else if (m_order.constLast() != symbolKey) {
+            m_order.removeOne(symbolKey);
+            m_order.append(symbolKey);
+        }
+        m_symbols[symbolKey].insert(fileName, {revision, usages});
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_generation;
+        m_symbols.clear();
+        m_order.clear();
+    }
+
+private:
+    struct FileUsages
+    {
+        FileRevision revision;
+        QList<CPlusPlus::Usage> usages;
+    };
+
+    enum { MaxSymbols = 8 };
+
+    mutable QMutex m_mutex;
+    int m_generation = 0;
+    QHash<QByteArray, QHash<Utils::FilePath, FileUsages>> m_symbols;
+    QList<QByteArray> m_order;
+};
+
+} // namespace Internal
+} // namespace CppTools
+
 namespace {
 
 class Filter : public Core::SearchResultFilter
@@ -237,6 +321,9 @@ class ProcessFile
     CPlusPlus::Document::Ptr symbolDocument;
     CPlusPlus::Symbol *symbol;
     QFutureInterface<CPlusPlus::Usage> *future;
+    const std::shared_ptr<FindUsagesCache> cache;
+    const QByteArray symbolKey;
+    const int cacheGeneration;
 
 public:
     // needed by QtConcurrent
@@ -247,12 +334,18 @@ public:
                 const CPlusPlus::Snapshot snapshot,
                 CPlusPlus::Document::Ptr symbolDocument,
                 CPlusPlus::Symbol *symbol,
-                QFutureInterface<CPlusPlus::Usage> *future)
+                QFutureInterface<CPlusPlus::Usage> *future,
+                const std::shared_ptr<FindUsagesCache> &cache,
+                const QByteArray &symbolKey,
+                int cacheGeneration)
         : workingCopy(workingCopy),
           snapshot(snapshot),
           symbolDocument(symbolDocument),
           symbol(symbol),
-          future(future)
+          future(future),
+          cache(cache),
+          symbolKey(symbolKey),
+          cacheGeneration(cacheGeneration)
     { }
 
     QList<CPlusPlus::Usage> operator()(const Utils::FilePath &fileName)
@@ -264,30 +357,35 @@ public:
             return usages;
         const CPlusPlus::Identifier *symbolId = symbol->identifier();
 
-        if (CPlusPlus::Document::Ptr previousDoc = snapshot.document(fileName)) {
-            CPlusPlus::Control *control = previousDoc->control();
-            if (!control->findIdentifier(symbolId->chars(), symbolId->size()))
-                return usages; // skip this document, it's not using symbolId.
-        }
-        CPlusPlus::Document::Ptr doc;
-        const QByteArray unpreprocessedSource = getSource(fileName, workingCopy);
-
         if (symbolDocument && fileName == Utils::FilePath::fromString(symbolDocument->fileName())) {
-            doc = symbolDocument;
+            const QByteArray unpreprocessedSource = getSource(fileName, workingCopy);
+            CPlusPlus::Control *control = symbolDocument->control();
+            if (control->findIdentifier(symbolId->chars(), symbolId->size()) != nullptr) {
+                CPlusPlus::FindUsages process(unpreprocessedSource, symbolDocument, snapshot);
+                process(symbol);
+                usages = process.usages();
+            }
         } else {
-            doc = snapshot.preprocessedDocument(unpreprocessedSource, fileName);
+            FindUsagesCache::FileRevision revision;
+            if (const CPlusPlus::Document::Ptr previousDoc = snapshot.document(fileName))
+                revision.document = previousDoc->revision();
+            revision.workingCopy = workingCopy.revision(fileName);
+            if (cache->find(symbolKey, fileName, revision, &usages))
+                return usages;
+
+            const QByteArray unpreprocessedSource = getSource(fileName, workingCopy);
+            CPlusPlus::Document::Ptr doc = snapshot.preprocessedDocument(unpreprocessedSource,
+                                                                         fileName);
             doc->tokenize();
-        }
-
-        CPlusPlus::Control *control = doc->control();
-        if (control->findIdentifier(symbolId->chars(), symbolId->size()) != nullptr) {
-            if (doc != symbolDocument)
+            CPlusPlus::Control *control = doc->control();
+            if (control->findIdentifier(symbolId->chars(), symbolId->size()) != nullptr) {
                 doc->check();
-
-            CPlusPlus::FindUsages process(unpreprocessedSource, doc, snapshot);
-            process(symbol);
-
-            usages = process.usages();
+                CPlusPlus::FindUsages process(unpreprocessedSource, doc, snapshot);
+                process(symbol);
+                usages = process.usages();
+            }
+            if (!future->isCanceled())
+                cache->insert(cacheGeneration, symbolKey, fileName, revision, usages);
         }
 
         if (future->isPaused())
@@ -316,8 +414,21 @@ public:
 
 CppFindReferences::CppFindReferences(CppModelManager *modelManager)
     : QObject(modelManager),
-      m_modelManager(modelManager)
+      m_modelManager(modelManager),
+      m_findUsagesCache(std::make_shared<FindUsagesCache>()),
+      m_findUsagesCacheTimer(new QTimer(this))
 {
+    // Searching again right away is the common case, so do not keep the usages for longer.
+    m_findUsagesCacheTimer->setSingleShot(true);
+    m_findUsagesCacheTimer->setInterval(5 * 60 * 1000);
+    connect(m_findUsagesCacheTimer, &QTimer::timeout,
+            this, [this] { m_findUsagesCache->clear(); });
+    connect(modelManager, &CppModelManager::documentUpdated,
+            this, [this] { m_findUsagesCache->clear(); });
+    connect(modelManager, &CppModelManager::aboutToRemoveFiles,
+            this, [this] { m_findUsagesCache->clear(); });
+    connect(modelManager, &CppModelManager::projectPartsUpdated,
+            this, [this] { m_findUsagesCache->clear(); });
 }
 
 CppFindReferences::~CppFindReferences() = default;
@@ -334,10 +445,21 @@ QList<int> CppFindReferences::references(CPlusPlus::Symbol *symbol,
     return references;
 }
 
+// The identifiers of a document in the snapshot are those of its preprocessed source, so a
+// document without the symbol's identifier cannot refer to the symbol.
+static bool mayUseIdentifier(const CPlusPlus::Snapshot &snapshot, const Utils::FilePath &fileName,
+                             const CPlusPlus::Identifier *identifier)
+{
+    const CPlusPlus::Document::Ptr doc = snapshot.document(fileName);
+    return !doc || doc->control()->findIdentifier(identifier->chars(), identifier->size());
+}
+
 static void find_helper(QFutureInterface<CPlusPlus::Usage> &future,
                         const WorkingCopy workingCopy,
                         const CPlusPlus::LookupContext &context,
-                        CPlusPlus::Symbol *symbol)
+                        CPlusPlus::Symbol *symbol,
+                        const std::shared_ptr<FindUsagesCache> &cache,
+                        int cacheGeneration)
 {
     const CPlusPlus::Identifier *symbolId = symbol->identifier();
     QTC_ASSERT(symbolId != nullptr, return);
@@ -353,24 +475,24 @@ static void find_helper(QFutureInterface<CPlusPlus::Usage> &future,
         || (symbol->enclosingScope()
             && !symbol->isStatic()
             && symbol->enclosingScope()->isNamespace())) {
-        const CPlusPlus::Snapshot snapshotFromContext = context.snapshot();
-        for (auto i = snapshotFromContext.begin(), ei = snapshotFromContext.end(); i != ei; ++i) {
-            if (i.key() == sourceFile)
-                continue;
-
-            const CPlusPlus::Control *control = i.value()->control();
-
-            if (control->findIdentifier(symbolId->chars(), symbolId->size()))
+        for (auto i = snapshot.begin(), ei = snapshot.end(); i != ei; ++i) {
+            if (i.key() != sourceFile)
                 files.append(i.key());
         }
     } else {
         files += snapshot.filesDependingOn(sourceFile);
     }
     files = Utils::filteredUnique(files);
+    Utils::erase(files, [&](const Utils::FilePath &fileName) {
+        return fileName != sourceFile && !mayUseIdentifier(snapshot, fileName, symbolId);
+    });
 
     future.setProgressRange(0, files.size());
 
-    ProcessFile process(workingCopy, snapshot, context.thisDocument(), symbol, &future);
+    QByteArray symbolKey = fullIdForSymbol(symbol).join('/');
+    symbolKey.append('@').append(symbol->fileName(), symbol->fileNameLength());
+    ProcessFile process(workingCopy, snapshot, context.thisDocument(), symbol, &future, cache,
+                        symbolKey, cacheGeneration);
     UpdateUI reduce(&future);
     // This thread waits for blockingMappedReduced to finish, so reduce the pool's used thread count
     // so the blockingMappedReduced can use one more thread, and increase it again afterwards.
@@ -449,7 +571,9 @@ void CppFindReferences::findAll_helper(SearchResult *search, CPlusPlus::Symbol *
     const WorkingCopy workingCopy = m_modelManager->workingCopy();
     QFuture<CPlusPlus::Usage> result;
     result = Utils::runAsync(m_modelManager->sharedThreadPool(), find_helper,
-                             workingCopy, context, symbol);
+                             workingCopy, context, symbol, m_findUsagesCache,
+                             m_findUsagesCache->generation());
+    m_findUsagesCacheTimer->start();
     createWatcher(result, search);
 
     FutureProgress *progress = ProgressManager::addTask(result, tr("Searching for Usages"),
@@ -31,6 +31,8 @@
 #include <QPointer>
 #include <QFuture>
 
+#include <memory>
+
 QT_FORWARD_DECLARE_CLASS(QTimer)
 
 namespace Core {
@@ -47,6 +49,8 @@ class CppModelManager;
 
 namespace Internal {
 
+class FindUsagesCache;
+
 class CppFindReferencesParameters
 {
 public:
@@ -90,6 +94,8 @@ private:
 
 private:
     QPointer<CppModelManager> m_modelManager;
+    std::shared_ptr<FindUsagesCache> m_findUsagesCache;
+    QTimer *m_findUsagesCacheTimer = nullptr;
 };
 
 } // namespace Internal
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "cppsourceprocessertesthelper.h"
+#include "cpptoolsplugin.h"
+
+#include <cplusplus/Lexer.h>
+#include <cplusplus/Token.h>
+
+#include <QtTest>
+
+using namespace CPlusPlus;
+
+namespace {
+
+QVector<Token> tokenize(const QByteArray &source, bool scalarScanning, int *endState = nullptr)
+{
+    Lexer lexer(source.constBegin(), source.constEnd());
+    lexer.setLanguageFeatures(LanguageFeatures::defaultFeatures());
+    lexer.setScanCommentTokens(true);
+    lexer.setScalarScanning(scalarScanning);
+
+    QVector<Token> tokens;
+    Token token;
+    do {
+        lexer.scan(&token);
+        tokens.append(token);
+    } while (token.kind() != T_EOF_SYMBOL);
+
+    if (endState)
+        *endState = lexer.state();
+    return tokens;
+}
+
+} // anonymous namespace
+
+namespace CppTools {
+namespace Internal {
+
+// Runs of identifier characters, blanks and comment text longer than one vector are skipped
+// vectorized. The token stream must not differ from scanning character by character.
+void CppToolsPlugin::test_lexer_vectorizedScanning()
+{
+    QFETCH(QByteArray, source);
+
+    int scalarEndState = 0;
+    int vectorizedEndState = 0;
+    const QVector<Token> scalarTokens = tokenize(source, true, &scalarEndState);
+    const QVector<Token> vectorizedTokens = tokenize(source, false, &vectorizedEndState);
+
+    QCOMPARE(vectorizedTokens.size(), scalarTokens.size());
+    for (int i = 0; i < scalarTokens.size(); ++i) {
+        const Token &expected = scalarTokens.at(i);
+        const Token &actual = vectorizedTokens.at(i);
+        QCOMPARE(actual.kind(), expected.kind());
+        QCOMPARE(actual.bytesBegin(), expected.bytesBegin());
+        QCOMPARE(actual.bytes(), expected.bytes());
+        QCOMPARE(actual.utf16charsBegin(), expected.utf16charsBegin());
+        QCOMPARE(actual.utf16chars(), expected.utf16chars());
+        QCOMPARE(quint64(actual.flags), quint64(expected.flags));
+    }
+    QCOMPARE(vectorizedEndState, scalarEndState);
+}
+
+void CppToolsPlugin::test_lexer_vectorizedScanning_data()
+{
+    QTest::addColumn<QByteArray>("source");
+
+    QTest::newRow("identifiers")
+        << QByteArray("int aVeryLongIdentifierName_with_digits_0123456789_and_$dollar =\n"
+                      "    anotherVeryLongIdentifierNameThatSpansSeveralVectors + x;\n");
+    QTest::newRow("non-ASCII identifiers")
+        << QByteArray("int gr\xc3\xb6\xc3\x9f" "eMitEinemSehrLangenNamenDer\xc3\x9c" "berVektorenGeht = 0;\n"
+                      "auto \xf0\x9d\x94\x98nicode_identifier_with_a_four_byte_code_point = 1;\n");
+    QTest::newRow("blanks")
+        << QByteArray("int\t\t\t\t                                        x;\r\n"
+                      "\v\f                                                  \r\n  y;");
+    QTest::newRow("block comments")
+        << QByteArray("/* a block comment that is longer than one vector of thirty-two bytes\n"
+                      " ** with stars * and / slashes */ int x; /** doxygen comment */\n"
+                      "/* \xc3\xbcn\xc3\xaf" "c\xc3\xb6" "d\xc3\xa9 inside a comment that is long enough */");
+    QTest::newRow("line comments")
+        << QByteArray("// a line comment that is longer than one vector of thirty-two bytes \\\n"
+                      "   continued on the next line\n"
+                      "int y; /// doxygen line comment that ends at the end of the buffer");
+    QTest::newRow("unterminated block comment")
+        << QByteArray("int z; /* never terminated, and long enough to use the vectorized path");
+    QTest::newRow("strings")
+        << QByteArray("const char *s = \"a string literal with spaces    and \\\"escapes\\\" in it\";\n"
+                      "auto u = u8\"\xc3\xbcn\xc3\xaf" "c\xc3\xb6" "d\xc3\xa9\"; auto c = L'x'; auto p = '\\'';\n"
+                      "#include <an/angle/string/literal/that/is/rather/long.h>\n");
+    QTest::newRow("raw strings")
+        << QByteArray("auto r = R\"delimiter(raw string with )\" quotes and spaces          "
+                      "     )delimiter\";\nauto s = R\"(short)\"; auto t = LR\"x(\n/* no comment */\n)x\";");
+    QTest::newRow("digraphs")
+        << QByteArray("%:define DIGRAPHS <: :> <% %> %:%: and_a_very_long_identifier_after_digraphs\n"
+                      "<::> ?\?= ?\?/ a<:0:> = b<%1%>;");
+    QTest::newRow("CR LF")
+        << QByteArray("line_one_with_trailing_spaces                        \r\nline_two\r\n"
+                      "/* comment\r\n spanning lines                                  */\r\n");
+    QTest::newRow("NUL")
+        << QByteArray("int a;                                 \0"
+                      "int b_with_a_long_identifier_after_the_nul_byte;", 88);
+    QTest::newRow("Lexer.cpp") << Tests::TestSources::lexerSource();
+}
+
+void CppToolsPlugin::test_lexer_benchmark_data()
+{
+    QTest::addColumn<bool>("scalarScanning");
+
+    QTest::newRow("vectorized") << false;
+    QTest::newRow("scalar") << true;
+}
+
+void CppToolsPlugin::test_lexer_benchmark()
+{
+    QFETCH(bool, scalarScanning);
+
+    const QByteArray source = Tests::TestSources::lexerSource();
+    QVERIFY(!source.isEmpty());
+
+    QBENCHMARK {
+        tokenize(source, scalarScanning);
+    }
+}
+
+} // namespace Internal
+} // namespace CppTools
@@ -40,6 +40,25 @@ CppLocatorData::CppLocatorData()
     m_pendingDocuments.reserve(MaxPendingDocuments);
 }
 
+QHash<QString, IndexItem::Ptr> CppLocatorData::allSymbols() const
+{
+    QMutexLocker locker(&m_pendingDocumentsMutex);
+    flushPendingDocument(true);
+    return m_infosByFile;
+}
+
+void CppLocatorData::addCachedSymbols(const QHash<QString, IndexItem::Ptr> &symbolsByFile)
+{
+    QMutexLocker locker(&m_pendingDocumentsMutex);
+    flushPendingDocument(true);
+
+    // Symbols of indexed documents are more recent, keep them.
+    for (auto it = symbolsByFile.cbegin(), end = symbolsByFile.cend(); it != end; ++it) {
+        if (!m_infosByFile.contains(it.key()))
+            insertInfo(it.key(), it.value());
+    }
+}
+
 void CppLocatorData::onDocumentUpdated(const CPlusPlus::Document::Ptr &document)
 {
     QMutexLocker locker(&m_pendingDocumentsMutex);
@@ -70,6 +89,7 @@ void CppLocatorData::onAboutToRemoveFiles(const QStringList &files)
 
     foreach (const QString &file, files) {
         m_infosByFile.remove(file);
+        m_symbolsByFile.remove(file);
 
         for (int i = 0; i < m_pendingDocuments.size(); ++i) {
             if (m_pendingDocuments.at(i)->fileName() == file) {
@@ -92,8 +112,44 @@ void CppLocatorData::flushPendingDocument(bool force) const
         return;
 
     foreach (CPlusPlus::Document::Ptr doc, m_pendingDocuments)
-        m_infosByFile.insert(StringTable::insert(doc->fileName()), m_search(doc));
+        insertInfo(doc->fileName(), m_search(doc));
 
     m_pendingDocuments.clear();
     m_pendingDocuments.reserve(MaxPendingDocuments);
 }
+
+void CppLocatorData::insertInfo(const QString &fileName, const IndexItem::Ptr &info) const
+{
+    QVector<IndexedSymbol> symbols;
+    info->visitAllChildren([&symbols](const IndexItem::Ptr &item) {
+        symbols.append({signature(item->scopedSymbolName() + item->symbolType()), item});
+        return item->type() & IndexItem::Enum ? IndexItem::Continue : IndexItem::Recurse;
+    });
+    symbols.squeeze();
+
+    const QString internedFileName = StringTable::insert(fileName);
+    m_infosByFile.insert(internedFileName, info);
+    m_symbolsByFile.insert(internedFileName, symbols);
+}
+
+quint64 CppLocatorData::signature(const QString &text)
+{
+    // One bit per letter, digit and some punctuation found in symbols,
+    // all other characters share the last bit.
+    static const QByteArray punctuation = "_:<>~*&,()[] ";
+    enum { OtherBit = 63 };
+
+    quint64 result = 0;
+    for (const QChar &c : text) {
+        const ushort u = c.toLower().unicode();
+        int bit = OtherBit;
+        if (u >= 'a' && u <= 'z')
+            bit = u - 'a';
+        else if (u >= '0' && u <= '9')
+            bit = 26 + u - '0';
+        else if (u < 128 && punctuation.contains(char(u)))
+            bit = 36 + punctuation.indexOf(char(u));
+        result |= quint64(1) << bit;
+    }
+    return result;
+}
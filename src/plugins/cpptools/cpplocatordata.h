@@ -55,16 +55,52 @@ public:
                 return;
     }
 
+    // Like filterAllFiles(), but visits only the items whose scoped name and type contain
+    // all characters of the given signature, without going through the item trees.
+    // Children of enums are not visited.
+    void filterAllFiles(quint64 requiredSignature, IndexItem::Visitor func) const
+    {
+        QMutexLocker locker(&m_pendingDocumentsMutex);
+        flushPendingDocument(true);
+        QHash<QString, QVector<IndexedSymbol>> symbolsByFile = m_symbolsByFile;
+        locker.unlock();
+        for (auto i = symbolsByFile.constBegin(), ei = symbolsByFile.constEnd(); i != ei; ++i) {
+            for (const IndexedSymbol &symbol : i.value()) {
+                if ((symbol.signature & requiredSignature) != requiredSignature)
+                    continue;
+                if (func(symbol.item) == IndexItem::Break)
+                    return;
+            }
+        }
+    }
+
+    // A case insensitive set of the characters in text.
+    static quint64 signature(const QString &text);
+
+    QHash<QString, IndexItem::Ptr> allSymbols() const;
+
+    // Symbols of files that are not indexed yet, e.g. restored from a cache.
+    void addCachedSymbols(const QHash<QString, IndexItem::Ptr> &symbolsByFile);
+
 public slots:
     void onDocumentUpdated(const CPlusPlus::Document::Ptr &document);
     void onAboutToRemoveFiles(const QStringList &files);
 
 private:
+    class IndexedSymbol
+    {
+    public:
+        quint64 signature;
+        IndexItem::Ptr item;
+    };
+
     // Ensure to protect every call to this method with m_pendingDocumentsMutex
     void flushPendingDocument(bool force) const;
+    void insertInfo(const QString &fileName, const IndexItem::Ptr &info) const;
 
     mutable SearchSymbols m_search;
     mutable QHash<QString, IndexItem::Ptr> m_infosByFile;
+    mutable QHash<QString, QVector<IndexedSymbol>> m_symbolsByFile;
 
     mutable QMutex m_pendingDocumentsMutex;
     mutable QVector<CPlusPlus::Document::Ptr> m_pendingDocuments;
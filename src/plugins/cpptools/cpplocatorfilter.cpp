@@ -75,7 +75,14 @@ QList<Core::LocatorFilterEntry> CppLocatorFilter::matchesFor(
     const QRegularExpression shortRegexp =
             hasColonColon ? createRegExp(entry.mid(entry.lastIndexOf("::") + 2)) : regexp;
 
-    m_data->filterAllFiles([&](const IndexItem::Ptr &info) -> IndexItem::VisitorResult {
+    // Every character of the entry except for the wildcards is part of a match, regardless of
+    // case. Items lacking any of them are skipped before running the regular expression.
+    QString requiredCharacters = entry;
+    requiredCharacters.remove('*').remove('?');
+    const quint64 requiredSignature = CppLocatorData::signature(requiredCharacters);
+
+    m_data->filterAllFiles(requiredSignature,
+                           [&](const IndexItem::Ptr &info) -> IndexItem::VisitorResult {
         if (future.isCanceled())
             return IndexItem::Break;
         const IndexItem::ItemType type = info->type();
@@ -122,10 +129,7 @@ QList<Core::LocatorFilterEntry> CppLocatorFilter::matchesFor(
             }
         }
 
-        if (info->type() & IndexItem::Enum)
-            return IndexItem::Continue;
-        else
-            return IndexItem::Recurse;
+        return IndexItem::Recurse;
     });
 
     for (auto &entry : entries) {
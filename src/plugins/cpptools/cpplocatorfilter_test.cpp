@@ -28,6 +28,7 @@
 #include "cppclassesfilter.h"
 #include "cppcurrentdocumentfilter.h"
 #include "cppfunctionsfilter.h"
+#include "cpplocatordata.h"
 #include "cpplocatorfilter.h"
 #include "cppmodelmanager.h"
 #include "cpptoolstestcase.h"
@@ -264,6 +265,16 @@ void CppToolsPlugin::test_cpplocatorfilters_CppLocatorFilter_data()
                ResultData("MyClass", testFileShort)
            };
 
+    QTest::newRow("CppClassesFilter-Wildcard")
+        << testFile
+        << cppClassesFilter
+        << "my*ass"
+        << ResultDataList{
+               ResultData("MyClass", "<anonymous namespace>"),
+               ResultData("MyClass", "MyNamespace"),
+               ResultData("MyClass", testFileShort)
+           };
+
     QTest::newRow("CppClassesFilter-WithNamespacePrefix")
         << testFile
         << cppClassesFilter
@@ -424,3 +435,32 @@ void CppToolsPlugin::test_cpplocatorfilters_CppFunctionsFilterHighlighting()
 
     CppLocatorFilterTestCase(filter, testFile, searchText, expectedResults);
 }
+
+void CppToolsPlugin::test_cpplocatorfilters_signature()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, searchText);
+    QFETCH(bool, mayMatch);
+
+    const quint64 required = CppLocatorData::signature(searchText);
+    QCOMPARE((CppLocatorData::signature(text) & required) == required, mayMatch);
+}
+
+void CppToolsPlugin::test_cpplocatorfilters_signature_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("searchText");
+    QTest::addColumn<bool>("mayMatch");
+
+    QTest::newRow("empty search") << "MyClass" << "" << true;
+    QTest::newRow("case insensitive") << "MyClass" << "MYCLASS" << true;
+    QTest::newRow("not contiguous") << "get_action_controller" << "gac" << true;
+    QTest::newRow("scope") << "MyNamespace::MyClass" << "ns::my" << true;
+    QTest::newRow("type") << "myFunction(bool, int)" << "myfunction(bool" << true;
+    QTest::newRow("digits") << "Vector3D" << "v3d" << true;
+    QTest::newRow("missing letter") << "MyClass" << "myclassz" << false;
+    QTest::newRow("missing digit") << "Vector3D" << "v2d" << false;
+    QTest::newRow("missing punctuation") << "MyClass" << "my::class" << false;
+    QTest::newRow("non-ascii") << QString::fromUtf8("Größe") << QString::fromUtf8("ß") << true;
+    QTest::newRow("missing non-ascii") << "Groesse" << QString::fromUtf8("ß") << false;
+}
@@ -46,6 +46,7 @@
 #include "cpptoolsplugin.h"
 #include "cpptoolsconstants.h"
 #include "cpptoolsreuse.h"
+#include "documentsummarycache.h"
 #include "editordocumenthandle.h"
 #include "stringtable.h"
 #include "symbolfinder.h"
@@ -66,13 +67,17 @@
 #include <projectexplorer/projectmacro.h>
 #include <projectexplorer/session.h>
 #include <texteditor/textdocument.h>
+#include <utils/algorithm.h>
 #include <utils/fileutils.h>
 #include <utils/hostosinfo.h>
 #include <utils/qtcassert.h>
+#include <utils/runextensions.h>
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
+#include <QFutureSynchronizer>
 #include <QFutureWatcher>
 #include <QMutexLocker>
 #include <QTextBlock>
@@ -171,7 +176,7 @@ public:
 
     // Indexing
     CppIndexingSupport *m_indexingSupporter;
-    CppIndexingSupport *m_internalIndexingSupport;
+    BuiltinIndexingSupport *m_internalIndexingSupport;
     bool m_indexerEnabled;
 
     CppFindReferences *m_findReferences;
@@ -187,6 +192,7 @@ public:
     REHash m_refactoringEngines;
 
     CppLocatorData m_locatorData;
+    QFutureSynchronizer<bool> m_documentSummarySaves;
     std::unique_ptr<Core::ILocatorFilter> m_locatorFilter;
     std::unique_ptr<Core::ILocatorFilter> m_classesFilter;
     std::unique_ptr<Core::ILocatorFilter> m_includesFilter;
@@ -683,6 +689,7 @@ CppModelManager::~CppModelManager()
 {
     ExtensionSystem::PluginManager::removeObject(this);
 
+    d->m_documentSummarySaves.waitForFinished();
     delete d->m_internalIndexingSupport;
     delete d;
 }
@@ -938,6 +945,13 @@ static QSet<QString> tooBigFilesRemoved(const QSet<QString> &files, int fileSize
 
 QFuture<void> CppModelManager::updateSourceFiles(const QSet<QString> &sourceFiles,
                                                  ProgressNotificationMode mode)
+{
+    return updateSourceFiles(sourceFiles, mode, {});
+}
+
+QFuture<void> CppModelManager::updateSourceFiles(
+        const QSet<QString> &sourceFiles, ProgressNotificationMode mode,
+        const std::function<QSet<QString> ()> &restoreSummaries)
 {
     if (sourceFiles.isEmpty() || !d->m_indexerEnabled)
         return QFuture<void>();
@@ -946,6 +960,10 @@ QFuture<void> CppModelManager::updateSourceFiles(const QSet<QString> &sourceFile
 
     if (d->m_indexingSupporter)
         d->m_indexingSupporter->refreshSourceFiles(filteredFiles, mode);
+    if (restoreSummaries) {
+        return d->m_internalIndexingSupport->refreshSourceFiles(filteredFiles, mode,
+                                                                restoreSummaries);
+    }
     return d->m_internalIndexingSupport->refreshSourceFiles(filteredFiles, mode);
 }
 
@@ -1138,6 +1156,7 @@ QFuture<void> CppModelManager::updateProjectInfo(const ProjectInfo &newProjectIn
     QSet<QString> filesToReindex;
     QStringList removedProjectParts;
     bool filesRemoved = false;
+    bool restoreSummaries = false;
     ProjectExplorer::Project *project = theNewProjectInfo.project().data();
 
     { // Only hold the mutex for a limited scope, so the dumping afterwards does not deadlock.
@@ -1189,6 +1208,7 @@ QFuture<void> CppModelManager::updateProjectInfo(const ProjectInfo &newProjectIn
         } else {
             d->m_dirty = true;
             filesToReindex.unite(newSourceFiles);
+            restoreSummaries = !oldProjectInfo.isValid();
         }
 
         // Update Project/ProjectInfo and File/ProjectPart table
@@ -1218,9 +1238,12 @@ QFuture<void> CppModelManager::updateProjectInfo(const ProjectInfo &newProjectIn
     // resolved includes that we could rely on.
     updateCppEditorDocuments(/*projectsUpdated = */ true);
 
-    // Trigger reindexing
-    const QFuture<void> indexingFuture = updateSourceFiles(filesToReindex,
-                                                           ForcedProgressNotification);
+    // Trigger reindexing. The symbols of the last session are available while the indexer
+    // is running, and files that did not change since then are not parsed again.
+    const QFuture<void> indexingFuture = updateSourceFiles(
+                filesToReindex, ForcedProgressNotification,
+                restoreSummaries ? documentSummaryRestorer(theNewProjectInfo)
+                                 : std::function<QSet<QString> ()>());
     if (!filesToReindex.isEmpty()) {
         d->m_projectToIndexerCanceled.insert(project, false);
     }
@@ -1319,11 +1342,88 @@ static QStringList removedProjectParts(const QStringList &before, const QStringL
     return Utils::toList(b);
 }
 
+static QByteArray definesFingerprint(const ProjectInfo &projectInfo)
+{
+    QVector<ProjectPart::Ptr> projectParts = projectInfo.projectParts();
+    Utils::sort(projectParts, [](const ProjectPart::Ptr &p1, const ProjectPart::Ptr &p2) {
+        return p1->id() < p2->id();
+    });
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const ProjectPart::Ptr &projectPart : qAsConst(projectParts)) {
+        hash.addData(projectPart->id().toUtf8());
+        hash.addData(ProjectExplorer::Macro::toByteArray(projectPart->toolChainMacros));
+        hash.addData(ProjectExplorer::Macro::toByteArray(projectPart->projectMacros));
+        for (const ProjectExplorer::HeaderPath &headerPath : projectPart->headerPaths)
+            hash.addData(headerPath.path.toUtf8());
+        hash.addData(QByteArray::number(projectPart->languageFeatures.flags));
+    }
+    return hash.result();
+}
+
+// The returned function runs in the indexing thread. It hands the cached symbols to the
+// locator and returns the source files that do not need to be parsed.
+std::function<QSet<QString> ()> CppModelManager::documentSummaryRestorer(
+        const ProjectInfo &projectInfo)
+{
+    if (!codeModelSettings()->cacheDocumentSummaries() || !projectInfo.project())
+        return {};
+
+    const QString cacheFilePath = DocumentSummaryCache::cacheFilePathForProject(
+                projectInfo.project()->projectFilePath().toString());
+    const QSet<QString> sourceFiles = projectInfo.sourceFiles();
+    const QByteArray fingerprint = definesFingerprint(projectInfo);
+    QPointer<ProjectExplorer::Project> project = projectInfo.project();
+
+    return [this, cacheFilePath, sourceFiles, fingerprint, project] {
+        QSet<QString> upToDateSourceFiles;
+        const DocumentSummaryCache::SymbolsByFile symbolsByFile
+                = DocumentSummaryCache(cacheFilePath).load(sourceFiles, fingerprint,
+                                                           &upToDateSourceFiles);
+        QMetaObject::invokeMethod(this, [this, project, symbolsByFile] {
+            // Do not restore symbols of files that nobody will remove from the locator again.
+            if (!project || !this->projectInfo(project).isValid())
+                return;
+            d->m_locatorData.addCachedSymbols(symbolsByFile);
+        }, Qt::QueuedConnection);
+        return upToDateSourceFiles;
+    };
+}
+
+void CppModelManager::saveDocumentSummaries(const ProjectInfo &projectInfo)
+{
+    if (!codeModelSettings()->cacheDocumentSummaries() || !projectInfo.project())
+        return;
+
+    const QString cacheFilePath = DocumentSummaryCache::cacheFilePathForProject(
+                projectInfo.project()->projectFilePath().toString());
+    const QSet<QString> sourceFiles = projectInfo.sourceFiles();
+    const Snapshot currentSnapshot = snapshot();
+    const DocumentSummaryCache::SymbolsByFile symbolsByFile = d->m_locatorData.allSymbols();
+    const QByteArray fingerprint = definesFingerprint(projectInfo);
+
+    // Writing the cache of a big project takes a while, so do not block closing it.
+    // The destructor waits for pending saves.
+    const QList<QFuture<bool>> saves = d->m_documentSummarySaves.futures();
+    d->m_documentSummarySaves.clearFutures();
+    for (const QFuture<bool> &save : saves) {
+        if (!save.isFinished())
+            d->m_documentSummarySaves.addFuture(save);
+    }
+    d->m_documentSummarySaves.addFuture(Utils::runAsync(
+        sharedThreadPool(), [cacheFilePath, sourceFiles, currentSnapshot, symbolsByFile,
+                             fingerprint] {
+            return DocumentSummaryCache(cacheFilePath).save(sourceFiles, currentSnapshot,
+                                                            symbolsByFile, fingerprint);
+        }));
+}
+
 void CppModelManager::onAboutToRemoveProject(ProjectExplorer::Project *project)
 {
     QStringList idsOfRemovedProjectParts;
 
     d->m_projectToIndexerCanceled.remove(project);
+    saveDocumentSummaries(projectInfo(project));
 
     {
         QMutexLocker locker(&d->m_projectMutex);
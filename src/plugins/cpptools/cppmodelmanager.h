@@ -41,6 +41,8 @@
 #include <QObject>
 #include <QStringList>
 
+#include <functional>
+
 namespace Core {
 class IDocument;
 class IEditor;
@@ -277,9 +279,15 @@ private:
     void onCurrentEditorChanged(Core::IEditor *editor);
     void onCoreAboutToClose();
 
+    QFuture<void> updateSourceFiles(const QSet<QString> &sourceFiles,
+                                    ProgressNotificationMode mode,
+                                    const std::function<QSet<QString> ()> &restoreSummaries);
+
     void initializeBuiltinModelManagerSupport();
     void delayedGC();
     void recalculateProjectPartMappings();
+    std::function<QSet<QString> ()> documentSummaryRestorer(const ProjectInfo &projectInfo);
+    void saveDocumentSummaries(const ProjectInfo &projectInfo);
     void watchForCanceledProjectIndexer(const QFuture<void> &future,
                                         ProjectExplorer::Project *project);
 
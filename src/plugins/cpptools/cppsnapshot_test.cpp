@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "cpptoolsplugin.h"
+
+#include <cplusplus/CppDocument.h>
+#include <utils/fileutils.h>
+
+#include <QHash>
+#include <QRandomGenerator>
+#include <QtTest>
+
+using namespace CPlusPlus;
+
+namespace {
+
+QString fileName(int i)
+{
+    return QString("/src/dir%1/file%2.cpp").arg(i % 97).arg(i);
+}
+
+QList<Document::Ptr> createDocuments(int count)
+{
+    QList<Document::Ptr> documents;
+    documents.reserve(count);
+    for (int i = 0; i < count; ++i)
+        documents.append(Document::create(fileName(i)));
+    return documents;
+}
+
+using Reference = QHash<QString, Document::Ptr>;
+
+bool equals(const Snapshot &snapshot, const Reference &reference)
+{
+    if (snapshot.size() != reference.size())
+        return false;
+    int iterated = 0;
+    for (auto it = snapshot.begin(), end = snapshot.end(); it != end; ++it) {
+        if (reference.value(it.key().toString()) != it.value())
+            return false;
+        ++iterated;
+    }
+    if (iterated != reference.size())
+        return false;
+    for (auto it = reference.cbegin(), end = reference.cend(); it != end; ++it) {
+        if (snapshot.document(it.key()) != it.value())
+            return false;
+    }
+    return true;
+}
+
+// Two file names with the same hash, found by trying names until two hashes are the same.
+// With 32 bit hashes, that takes about 80000 names.
+QPair<Utils::FilePath, Utils::FilePath> collidingFileNames()
+{
+    QHash<uint, Utils::FilePath> fileNamesByHash;
+    for (int i = 0; i < 4 * 1024 * 1024; ++i) {
+        const Utils::FilePath candidate = Utils::FilePath::fromString(fileName(i));
+        const uint hash = qHash(candidate);
+        const Utils::FilePath existing = fileNamesByHash.value(hash);
+        if (!existing.isEmpty())
+            return {existing, candidate};
+        fileNamesByHash.insert(hash, candidate);
+    }
+    return {};
+}
+
+} // anonymous namespace
+
+namespace CppTools {
+namespace Internal {
+
+// Random inserts and removes must match a QHash, and older copies must keep their contents.
+void CppToolsPlugin::test_snapshot_insertRemove()
+{
+    const int documentCount = 2000;
+    const QList<Document::Ptr> documents = createDocuments(documentCount);
+    QRandomGenerator random(42);
+
+    Snapshot snapshot;
+    Reference reference;
+    QList<QPair<Snapshot, Reference>> copies;
+
+    for (int step = 0; step < 20000; ++step) {
+        const int i = random.bounded(documentCount);
+        if (random.bounded(3) == 0) {
+            snapshot.remove(fileName(i));
+            reference.remove(fileName(i));
+        } else {
+            // Replacing a document with a new instance for the same file.
+            Document::Ptr document = random.bounded(2) ? documents.at(i)
+                                                       : Document::create(fileName(i));
+            snapshot.insert(document);
+            reference.insert(fileName(i), document);
+        }
+        QCOMPARE(snapshot.contains(fileName(i)), reference.contains(fileName(i)));
+        if (step % 1000 == 0)
+            copies.append({snapshot, reference});
+    }
+
+    QVERIFY(equals(snapshot, reference));
+    for (const QPair<Snapshot, Reference> &copy : qAsConst(copies))
+        QVERIFY(equals(copy.first, copy.second));
+
+    for (int i = 0; i < documentCount; ++i)
+        snapshot.remove(fileName(i));
+    QVERIFY(snapshot.isEmpty());
+    QVERIFY(snapshot.begin() == snapshot.end());
+}
+
+// Documents whose file names have the same hash end up in the same node of the last level.
+void CppToolsPlugin::test_snapshot_hashCollision()
+{
+    const QPair<Utils::FilePath, Utils::FilePath> fileNames = collidingFileNames();
+    const Utils::FilePath &first = fileNames.first;
+    const Utils::FilePath &second = fileNames.second;
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(qHash(first), qHash(second));
+
+    const Document::Ptr firstDocument = Document::create(first.toString());
+    const Document::Ptr secondDocument = Document::create(second.toString());
+    const Document::Ptr otherDocument = Document::create("/src/other.cpp");
+
+    Snapshot snapshot;
+    snapshot.insert(firstDocument);
+    snapshot.remove(second);
+    QCOMPARE(snapshot.size(), 1);
+    QVERIFY(!snapshot.contains(second));
+    QVERIFY(snapshot.find(second) == snapshot.end());
+
+    snapshot.insert(secondDocument);
+    snapshot.insert(otherDocument);
+    const Reference reference = {{first.toString(), firstDocument},
+                                 {second.toString(), secondDocument},
+                                 {otherDocument->fileName(), otherDocument}};
+    QVERIFY(equals(snapshot, reference));
+    QCOMPARE(snapshot.find(first).key(), first);
+    QCOMPARE(snapshot.find(second).value(), secondDocument);
+
+    // Replacing one of the documents keeps the other one.
+    const Document::Ptr newSecondDocument = Document::create(second.toString());
+    Snapshot copy = snapshot;
+    copy.insert(newSecondDocument);
+    QCOMPARE(copy.size(), 3);
+    QCOMPARE(copy.document(first), firstDocument);
+    QCOMPARE(copy.document(second), newSecondDocument);
+    QVERIFY(equals(snapshot, reference));
+
+    copy.remove(first);
+    QCOMPARE(copy.size(), 2);
+    QVERIFY(!copy.contains(first));
+    QCOMPARE(copy.document(second), newSecondDocument);
+    QVERIFY(equals(snapshot, reference));
+
+    copy.remove(second);
+    copy.remove(otherDocument->fileName());
+    QVERIFY(copy.isEmpty());
+    QVERIFY(copy.begin() == copy.end());
+}
+
+// Looking up documents, or copying a snapshot and updating the copy, as the model manager
+// does for each document. The documents and file names are created up front.
+void CppToolsPlugin::test_snapshot_benchmark()
+{
+    QFETCH(int, documentCount);
+    QFETCH(bool, lookUp);
+
+    const QList<Document::Ptr> documents = createDocuments(documentCount);
+    const QList<Document::Ptr> newDocuments = createDocuments(documentCount);
+    QVector<Utils::FilePath> fileNames;
+    fileNames.reserve(documentCount);
+    Snapshot snapshot;
+    for (const Document::Ptr &document : documents) {
+        snapshot.insert(document);
+        fileNames.append(Utils::FilePath::fromString(document->fileName()));
+    }
+
+    int i = 0;
+    if (lookUp) {
+        QBENCHMARK {
+            QVERIFY(snapshot.document(fileNames.at(i++ % documentCount)));
+        }
+    } else {
+        QBENCHMARK {
+            Snapshot copy = snapshot;
+            copy.insert(newDocuments.at(i++ % documentCount));
+            snapshot = copy;
+        }
+    }
+    QCOMPARE(snapshot.size(), documentCount);
+}
+
+void CppToolsPlugin::test_snapshot_benchmark_data()
+{
+    QTest::addColumn<int>("documentCount");
+    QTest::addColumn<bool>("lookUp");
+
+    QTest::newRow("10k, insert") << 10000 << false;
+    QTest::newRow("10k, look up") << 10000 << true;
+    QTest::newRow("100k, insert") << 100000 << false;
+    QTest::newRow("100k, look up") << 100000 << true;
+}
+
+} // namespace Internal
+} // namespace CppTools
@@ -26,6 +26,7 @@
 #include "cppsourceprocessertesthelper.h"
 
 #include <QDir>
+#include <QFile>
 
 namespace CppTools {
 namespace Tests {
@@ -56,5 +57,13 @@ QString TestIncludePaths::testFilePath(const QString &fileName)
     return Tests::TestIncludePaths::directoryOfTestFile() + QLatin1Char('/') + fileName;
 }
 
+QByteArray TestSources::lexerSource()
+{
+    QFile file(QLatin1String(SRCDIR "/../../libs/3rdparty/cplusplus/Lexer.cpp"));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
 } // namespace Tests
 } // namespace CppTools
@@ -28,6 +28,7 @@
 #include "cpptools_global.h"
 
 #include <QtGlobal>
+#include <QByteArray>
 #include <QString>
 
 QT_FORWARD_DECLARE_CLASS(QString)
@@ -47,5 +48,14 @@ public:
     static QString testFilePath(const QString &fileName = QLatin1String("file.cpp"));
 };
 
+class CPPTOOLS_EXPORT TestSources
+{
+    Q_DISABLE_COPY(TestSources)
+
+public:
+    // The C++ lexer, as a large real world source file. Empty if it cannot be read.
+    static QByteArray lexerSource();
+};
+
 } // namespace Tests
 } // namespace CppTools
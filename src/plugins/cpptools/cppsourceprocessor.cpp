@@ -109,6 +109,18 @@ inline const CPlusPlus::Macro revision(const WorkingCopy &workingCopy,
 
 } // anonymous namespace
 
+Document::Ptr CppSourceProcessor::SharedDocuments::document(const QString &fileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_snapshot.document(fileName);
+}
+
+void CppSourceProcessor::SharedDocuments::insert(const Document::Ptr &document)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshot.insert(document);
+}
+
 CppSourceProcessor::CppSourceProcessor(const Snapshot &snapshot, DocumentCallback documentFinished)
     : m_snapshot(snapshot),
       m_documentFinished(documentFinished),
@@ -140,11 +152,13 @@ void CppSourceProcessor::setHeaderPaths(const ProjectExplorer::HeaderPaths &head
         else
             m_headerPaths.append({cleanPath(path.path), path.type});
     }
+    updateConfigurationFingerprint();
 }
 
 void CppSourceProcessor::setLanguageFeatures(const LanguageFeatures languageFeatures)
 {
     m_languageFeatures = languageFeatures;
+    updateConfigurationFingerprint();
 }
 
 // Add the given framework path, and expand private frameworks.
@@ -184,6 +198,13 @@ void CppSourceProcessor::setTodo(const QSet<QString> &files)
     m_todo = files;
 }
 
+/// Documents finished by this processor are published to \a sharedDocuments, and documents
+/// already finished by other processors sharing it are reused instead of parsed again.
+void CppSourceProcessor::setSharedDocuments(SharedDocuments *sharedDocuments)
+{
+    m_sharedDocuments = sharedDocuments;
+}
+
 void CppSourceProcessor::run(const QString &fileName,
                              const QStringList &initialIncludes)
 {
@@ -395,7 +416,7 @@ void CppSourceProcessor::mergeEnvironment(Document::Ptr doc)
     if (m_processed.contains(fn))
         return;
 
-    m_processed.insert(fn);
+    insertProcessed(fn);
 
     foreach (const Document::Include &incl, doc->resolvedIncludes()) {
         const QString includedFile = incl.resolvedFileName();
@@ -409,6 +430,174 @@ void CppSourceProcessor::mergeEnvironment(Document::Ptr doc)
     m_env.addMacros(doc->definedMacros());
 }
 
+// The header paths and language features decide how a file is preprocessed just like the macros
+// do, so they are part of the environment fingerprint.
+void CppSourceProcessor::updateConfigurationFingerprint()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(m_languageFeatures.flags));
+    for (const ProjectExplorer::HeaderPath &headerPath : qAsConst(m_headerPaths)) {
+        hash.addData(headerPath.path.toUtf8());
+        hash.addData(QByteArray::number(int(headerPath.type)));
+    }
+    const QByteArray result = hash.result();
+    m_configurationFingerprint = *reinterpret_cast<const quint64 *>(result.constData());
+}
+
+quint64 CppSourceProcessor::environmentFingerprint() const
+{
+    return m_env.fingerprint() ^ m_configurationFingerprint;
+}
+
+// Reuses the document from the global snapshot without preprocessing it again if neither the
+// file nor the environment it is entered with changed since it was preprocessed. Its includes
+// are processed as usual and must turn out unchanged as well. The document records everything
+// the preprocessor would produce, so the environment is updated from its defined macros.
+// A failed replay leaves no trace, so that the file can be preprocessed normally afterwards:
+// The changes it made are undone from the journal.
+bool CppSourceProcessor::replayUnchangedDocument(const QString &absoluteFileName,
+                                                 const QFileInfo &info,
+                                                 quint64 environmentFingerprint)
+{
+    const Document::Ptr document = m_globalSnapshot.document(absoluteFileName);
+    if (!document || document->environmentFingerprint() != environmentFingerprint)
+        return false;
+    if (m_workingCopy.contains(absoluteFileName) || !info.exists()
+            || document->lastModified() != info.lastModified()
+            || document->fileSize() != info.size()) {
+        return false;
+    }
+
+    const int journalSize = m_journal.size();
+    const Environment::Checkpoint environment = m_env.checkpoint();
+    const int stagedDocumentCount = m_stagedDocuments.size();
+
+    const Document::Ptr previousDocument = switchCurrentDocument(Document::Ptr());
+    ++m_replayDepth;
+    const bool replayed = replayDirectives(document);
+    --m_replayDepth;
+    switchCurrentDocument(previousDocument);
+
+    if (!replayed) {
+        rollbackJournal(journalSize);
+        m_env.rollback(environment);
+        m_stagedDocuments.resize(stagedDocumentCount);
+        return false;
+    }
+
+    qCDebug(log) << "Replaying:" << absoluteFileName;
+
+    insertProcessed(absoluteFileName);
+    insertIntoSnapshot(document);
+    removeFromTodo(absoluteFileName);
+    publishDocument(document, false);
+
+    if (m_replayDepth == 0) {
+        m_journal.clear();
+        const QVector<StagedDocument> stagedDocuments = std::move(m_stagedDocuments);
+        m_stagedDocuments.clear();
+        for (const StagedDocument &staged : stagedDocuments)
+            publishDocument(staged.document, staged.finished);
+    }
+    return true;
+}
+
+// Binds the macros of the document and processes its includes in the order of their
+// directives, since an include can depend on the macros defined before it. Returns false as
+// soon as an include resolves to another document than last time.
+bool CppSourceProcessor::replayDirectives(const Document::Ptr &document)
+{
+    const QList<Macro> macros = document->definedMacros();
+    auto macro = macros.cbegin();
+    foreach (const Document::Include &include, document->resolvedIncludes()) {
+        for (; macro != macros.cend() && macro->line() < include.line(); ++macro)
+            m_env.bind(*macro);
+
+        const QString includedFile = include.resolvedFileName();
+        run(includedFile);
+        if (m_snapshot.document(includedFile) != m_globalSnapshot.document(includedFile))
+            return false;
+    }
+    for (; macro != macros.cend(); ++macro)
+        m_env.bind(*macro);
+
+    return true;
+}
+
+// While a replay is in progress, the changes to the processed files and the snapshot are
+// recorded, so that they can be undone if the replay fails.
+void CppSourceProcessor::insertIncluded(const QString &fileName)
+{
+    if (m_included.contains(fileName))
+        return;
+    m_included.insert(fileName);
+    if (m_replayDepth > 0)
+        m_journal.append({JournalEntry::Included, fileName, Document::Ptr()});
+}
+
+void CppSourceProcessor::insertProcessed(const QString &fileName)
+{
+    if (m_processed.contains(fileName))
+        return;
+    m_processed.insert(fileName);
+    if (m_replayDepth > 0)
+        m_journal.append({JournalEntry::Processed, fileName, Document::Ptr()});
+}
+
+void CppSourceProcessor::removeFromTodo(const QString &fileName)
+{
+    if (m_todo.remove(fileName) && m_replayDepth > 0)
+        m_journal.append({JournalEntry::RemovedFromTodo, fileName, Document::Ptr()});
+}
+
+void CppSourceProcessor::insertIntoSnapshot(const Document::Ptr &document)
+{
+    if (m_replayDepth > 0) {
+        m_journal.append({JournalEntry::InsertedIntoSnapshot, document->fileName(),
+                          m_snapshot.document(document->fileName())});
+    }
+    m_snapshot.insert(document);
+}
+
+void CppSourceProcessor::rollbackJournal(int size)
+{
+    while (m_journal.size() > size) {
+        const JournalEntry entry = m_journal.takeLast();
+        switch (entry.change) {
+        case JournalEntry::Included:
+            m_included.remove(entry.fileName);
+            break;
+        case JournalEntry::Processed:
+            m_processed.remove(entry.fileName);
+            break;
+        case JournalEntry::RemovedFromTodo:
+            m_todo.insert(entry.fileName);
+            break;
+        case JournalEntry::InsertedIntoSnapshot:
+            if (entry.replacedDocument)
+                m_snapshot.insert(entry.replacedDocument);
+            else
+                m_snapshot.remove(entry.fileName);
+            break;
+        }
+    }
+}
+
+// Hands a document to the callback and to the other source processors, or stages it while
+// a replay is still in progress.
+void CppSourceProcessor::publishDocument(const Document::Ptr &document, bool finished)
+{
+    if (m_replayDepth > 0) {
+        m_stagedDocuments.append({document, finished});
+        return;
+    }
+
+    if (finished)
+        m_documentFinished(document);
+    if (m_sharedDocuments)
+        m_sharedDocuments->insert(document);
+}
+
 void CppSourceProcessor::startSkippingBlocks(int utf16charsOffset)
 {
     if (m_currentDoc)
@@ -439,7 +628,7 @@ void CppSourceProcessor::sourceNeeded(int line, const QString &fileName, Include
     if (m_included.contains(absoluteFileName))
         return; // We've already seen this file.
     if (!isInjectedFile(absoluteFileName))
-        m_included.insert(absoluteFileName);
+        insertIncluded(absoluteFileName);
 
     // Already in snapshot? Use it!
     if (Document::Ptr document = m_snapshot.document(absoluteFileName)) {
@@ -447,10 +636,27 @@ void CppSourceProcessor::sourceNeeded(int line, const QString &fileName, Include
         return;
     }
 
+    // Already processed by another source processor? Use it!
+    if (m_sharedDocuments) {
+        if (Document::Ptr document = m_sharedDocuments->document(absoluteFileName)) {
+            insertIntoSnapshot(document);
+            removeFromTodo(absoluteFileName);
+            mergeEnvironment(document);
+            return;
+        }
+    }
+
     const QFileInfo info(absoluteFileName);
     if (fileSizeExceedsLimit(info, m_fileSizeLimitInMb))
         return; // TODO: Add diagnostic message
 
+    // Unchanged and entered with the same environment as last time? Replay it!
+    const quint64 incomingEnvironmentFingerprint = environmentFingerprint();
+    if (replayUnchangedDocument(absoluteFileName, info, incomingEnvironmentFingerprint))
+        return;
+    // A failed replay might have processed includes and changed the environment already.
+    const bool environmentIsIncoming = environmentFingerprint() == incomingEnvironmentFingerprint;
+
     // Otherwise get file contents
     unsigned editorRevision = 0;
     QByteArray contents;
@@ -466,12 +672,16 @@ void CppSourceProcessor::sourceNeeded(int line, const QString &fileName, Include
     document->setEditorRevision(editorRevision);
     document->setLanguageFeatures(m_languageFeatures);
     foreach (const QString &include, initialIncludes) {
-        m_included.insert(include);
+        insertIncluded(include);
         Document::Include inc(include, include, 0, IncludeLocal);
         document->addIncludeFile(inc);
     }
-    if (info.exists())
+    if (info.exists()) {
         document->setLastModified(info.lastModified());
+        document->setFileSize(info.size());
+    }
+    if (environmentIsIncoming && !m_workingCopy.contains(absoluteFileName))
+        document->setEnvironmentFingerprint(incomingEnvironmentFingerprint);
 
     const Document::Ptr previousDocument = switchCurrentDocument(document);
     const QByteArray preprocessedCode = m_preprocess.run(absoluteFileName, contents);
@@ -486,8 +696,8 @@ void CppSourceProcessor::sourceNeeded(int line, const QString &fileName, Include
     if (globalDocument && globalDocument->fingerprint() == document->fingerprint()) {
         switchCurrentDocument(previousDocument);
         mergeEnvironment(globalDocument);
-        m_snapshot.insert(globalDocument);
-        m_todo.remove(absoluteFileName);
+        insertIntoSnapshot(globalDocument);
+        removeFromTodo(absoluteFileName);
         return;
     }
 
@@ -498,10 +708,9 @@ void CppSourceProcessor::sourceNeeded(int line, const QString &fileName, Include
     document->check(m_workingCopy.contains(document->fileName()) ? Document::FullCheck
                                                                  : Document::FastCheck);
 
-    m_documentFinished(document);
-
-    m_snapshot.insert(document);
-    m_todo.remove(absoluteFileName);
+    insertIntoSnapshot(document);
+    publishDocument(document, true);
+    removeFromTodo(absoluteFileName);
     switchCurrentDocument(previousDocument);
 }
 
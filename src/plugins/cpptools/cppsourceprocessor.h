@@ -32,6 +32,7 @@
 #include <cplusplus/pp-engine.h>
 
 #include <QHash>
+#include <QMutex>
 #include <QPointer>
 #include <QSet>
 #include <QStringList>
@@ -53,6 +54,18 @@ class CppSourceProcessor: public CPlusPlus::Client
 public:
     using DocumentCallback = std::function<void (const CPlusPlus::Document::Ptr &)>;
 
+    // Documents finished by any of several source processors indexing in parallel.
+    class SharedDocuments
+    {
+    public:
+        CPlusPlus::Document::Ptr document(const QString &fileName) const;
+        void insert(const CPlusPlus::Document::Ptr &document);
+
+    private:
+        mutable QMutex m_mutex;
+        CPlusPlus::Snapshot m_snapshot;
+    };
+
 public:
     static QString cleanPath(const QString &path);
 
@@ -67,6 +80,7 @@ public:
     void setLanguageFeatures(CPlusPlus::LanguageFeatures languageFeatures);
     void setFileSizeLimitInMb(int fileSizeLimitInMb);
     void setTodo(const QSet<QString> &files);
+    void setSharedDocuments(SharedDocuments *sharedDocuments);
 
     void run(const QString &fileName, const QStringList &initialIncludes = QStringList());
     void removeFromCache(const QString &fileName);
@@ -90,6 +104,17 @@ private:
                                ProjectExplorer::HeaderPaths::Iterator headerPathsIt);
 
     void mergeEnvironment(CPlusPlus::Document::Ptr doc);
+    quint64 environmentFingerprint() const;
+    void updateConfigurationFingerprint();
+    bool replayUnchangedDocument(const QString &absoluteFileName, const QFileInfo &info,
+                                 quint64 environmentFingerprint);
+    bool replayDirectives(const CPlusPlus::Document::Ptr &document);
+    void publishDocument(const CPlusPlus::Document::Ptr &document, bool finished);
+    void insertIncluded(const QString &fileName);
+    void insertProcessed(const QString &fileName);
+    void removeFromTodo(const QString &fileName);
+    void insertIntoSnapshot(const CPlusPlus::Document::Ptr &document);
+    void rollbackJournal(int size);
 
     // Client interface
     void macroAdded(const CPlusPlus::Macro &macro) override;
@@ -124,7 +149,28 @@ private:
     QSet<QString> m_processed;
     QHash<QString, QString> m_fileNameCache;
     int m_fileSizeLimitInMb = -1;
+    quint64 m_configurationFingerprint = 0;
+    SharedDocuments *m_sharedDocuments = nullptr;
     QTextCodec *m_defaultCodec;
+
+    // Documents are only published once the outermost replay succeeded.
+    struct StagedDocument
+    {
+        CPlusPlus::Document::Ptr document;
+        bool finished;
+    };
+    QVector<StagedDocument> m_stagedDocuments;
+    int m_replayDepth = 0;
+
+    // Changes made while a replay is in progress.
+    struct JournalEntry
+    {
+        enum Change { Included, Processed, RemovedFromTodo, InsertedIntoSnapshot };
+        Change change;
+        QString fileName;
+        CPlusPlus::Document::Ptr replacedDocument;
+    };
+    QVector<JournalEntry> m_journal;
 };
 
 } // namespace Internal
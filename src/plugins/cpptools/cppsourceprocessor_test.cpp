@@ -37,6 +37,8 @@
 #include <texteditor/texteditor.h>
 
 #include <cplusplus/CppDocument.h>
+#include <cplusplus/Literals.h>
+#include <cplusplus/Symbol.h>
 #include <utils/fileutils.h>
 
 #include <QFile>
@@ -219,3 +221,85 @@ void CppToolsPlugin::test_cppsourceprocessor_includeNext()
     QVERIFY(mainDocument);
     QVERIFY(isMacroDefinedInDocument("OK_FEATURE_X_ENABLED", mainDocument));
 }
+
+/// Check: Documents finished by one source processor are reused by processors sharing them.
+void CppToolsPlugin::test_cppsourceprocessor_sharedDocuments()
+{
+    const QString mainFilePath
+            = TestIncludePaths::testFilePath(QLatin1String("test_main_resolvedUnresolved.cpp"));
+    const QString headerFilePath = TestIncludePaths::testFilePath(QLatin1String("header.h"));
+    const ProjectExplorer::HeaderPaths headerPaths
+            = {{TestIncludePaths::directoryOfTestFile(), HeaderPathType::User}};
+
+    int finishedDocuments = 0;
+    CppSourceProcessor::DocumentCallback documentCallback = [&](const Document::Ptr &) {
+        ++finishedDocuments;
+    };
+    CppSourceProcessor::SharedDocuments sharedDocuments;
+
+    CppSourceProcessor firstProcessor(Snapshot(), documentCallback);
+    firstProcessor.setHeaderPaths(headerPaths);
+    firstProcessor.setSharedDocuments(&sharedDocuments);
+    firstProcessor.run(mainFilePath);
+    const int finishedByFirstProcessor = finishedDocuments;
+    QVERIFY(finishedByFirstProcessor > 0);
+
+    CppSourceProcessor secondProcessor(Snapshot(), documentCallback);
+    secondProcessor.setHeaderPaths(headerPaths);
+    secondProcessor.setSharedDocuments(&sharedDocuments);
+    secondProcessor.run(mainFilePath);
+    QCOMPARE(finishedDocuments, finishedByFirstProcessor);
+
+    const Document::Ptr header = secondProcessor.snapshot().document(headerFilePath);
+    QVERIFY(header);
+    QCOMPARE(header, firstProcessor.snapshot().document(headerFilePath));
+}
+
+/// Check: Unchanged documents are replayed with their macros and includes in source order,
+/// so that an include depending on a macro defined before it is replayed as well.
+void CppToolsPlugin::test_cppsourceprocessor_replayMacroDependentInclude()
+{
+    TemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+    const QString mainFilePath = temporaryDir.createFile("main.cpp", "#include \"header.h\"\n");
+    const QString headerFilePath = temporaryDir.createFile("header.h",
+                                                           "#define SELECT 1\n"
+                                                           "#include \"dependent.h\"\n"
+                                                           "#define AFTER_INCLUDE 1\n");
+    const QString dependentFilePath = temporaryDir.createFile("dependent.h",
+                                                              "#if SELECT\n"
+                                                              "int selected();\n"
+                                                              "#else\n"
+                                                              "int notSelected();\n"
+                                                              "#endif\n");
+    const ProjectExplorer::HeaderPaths headerPaths
+            = {{temporaryDir.path(), HeaderPathType::User}};
+
+    int finishedDocuments = 0;
+    CppSourceProcessor::DocumentCallback documentCallback = [&](const Document::Ptr &) {
+        ++finishedDocuments;
+    };
+
+    CppSourceProcessor firstProcessor(Snapshot(), documentCallback);
+    firstProcessor.setHeaderPaths(headerPaths);
+    firstProcessor.run(mainFilePath);
+    QCOMPARE(finishedDocuments, 3);
+    const Snapshot globalSnapshot = firstProcessor.snapshot();
+
+    const Document::Ptr dependent = globalSnapshot.document(dependentFilePath);
+    QVERIFY(dependent);
+    QCOMPARE(dependent->globalSymbolCount(), 1);
+    const Identifier *identifier = dependent->globalSymbolAt(0)->identifier();
+    QVERIFY(identifier);
+    QCOMPARE(QByteArray(identifier->chars(), identifier->size()), QByteArray("selected"));
+
+    finishedDocuments = 0;
+    CppSourceProcessor secondProcessor(Snapshot(), documentCallback);
+    secondProcessor.setHeaderPaths(headerPaths);
+    secondProcessor.setGlobalSnapshot(globalSnapshot);
+    secondProcessor.run(mainFilePath);
+
+    QCOMPARE(finishedDocuments, 0);
+    for (const QString &filePath : {mainFilePath, headerFilePath, dependentFilePath})
+        QCOMPARE(secondProcessor.snapshot().document(filePath), globalSnapshot.document(filePath));
+}
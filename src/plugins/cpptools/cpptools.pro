@@ -71,6 +71,7 @@ HEADERS += \
     cppvirtualfunctionassistprovider.h \
     cppvirtualfunctionproposalitem.h \
     cppworkingcopy.h \
+    documentsummarycache.h \
     doxygengenerator.h \
     editordocumenthandle.h \
     followsymbolinterface.h \
@@ -164,6 +165,7 @@ SOURCES += \
     cppvirtualfunctionassistprovider.cpp \
     cppvirtualfunctionproposalitem.cpp \
     cppworkingcopy.cpp \
+    documentsummarycache.cpp \
     doxygengenerator.cpp \
     editordocumenthandle.cpp \
     functionutils.cpp \
@@ -206,11 +208,14 @@ equals(TEST, 1) {
     SOURCES += \
         cppcodegen_test.cpp \
         cppcompletion_test.cpp \
+        cppdocumentmemory_test.cpp \
         cppheadersource_test.cpp \
+        cpplexer_test.cpp \
         cpplocalsymbols_test.cpp \
         cpplocatorfilter_test.cpp \
         cppmodelmanager_test.cpp \
         cpppointerdeclarationformatter_test.cpp \
+        cppsnapshot_test.cpp \
         cppsourceprocessertesthelper.cpp \
         cppsourceprocessor_test.cpp \
         cpptoolstestcase.cpp \
@@ -107,6 +107,11 @@ private slots:
     void test_completion_prefix_first_QTCREATORBUG_8737();
     void test_completion_prefix_first_QTCREATORBUG_9236();
 
+    void test_documentmemory_sharedLiterals();
+    void test_documentmemory_recycledPools();
+    void test_documentmemory_benchmark_data();
+    void test_documentmemory_benchmark();
+
     void test_format_pointerdeclaration_in_simpledeclarations();
     void test_format_pointerdeclaration_in_simpledeclarations_data();
     void test_format_pointerdeclaration_in_controlflowstatements();
@@ -123,6 +128,18 @@ private slots:
     void test_cppsourceprocessor_includes_allDiagnostics();
     void test_cppsourceprocessor_macroUses();
     void test_cppsourceprocessor_includeNext();
+    void test_cppsourceprocessor_sharedDocuments();
+    void test_cppsourceprocessor_replayMacroDependentInclude();
+
+    void test_lexer_vectorizedScanning();
+    void test_lexer_vectorizedScanning_data();
+    void test_lexer_benchmark_data();
+    void test_lexer_benchmark();
+
+    void test_snapshot_insertRemove();
+    void test_snapshot_hashCollision();
+    void test_snapshot_benchmark();
+    void test_snapshot_benchmark_data();
 
     void test_functionutils_virtualFunctions();
     void test_functionutils_virtualFunctions_data();
@@ -152,9 +169,12 @@ private slots:
     void test_cpplocatorfilters_CppCurrentDocumentFilter();
     void test_cpplocatorfilters_CppCurrentDocumentHighlighting();
     void test_cpplocatorfilters_CppFunctionsFilterHighlighting();
+    void test_cpplocatorfilters_signature();
+    void test_cpplocatorfilters_signature_data();
 
     void test_builtinsymbolsearcher();
     void test_builtinsymbolsearcher_data();
+    void test_builtinsymbolsearcher_manyDocuments();
 
     void test_headersource_data();
     void test_headersource();
@@ -46,6 +46,7 @@
 #include <QSet>
 #include <QTextCursor>
 #include <QTextDocument>
+#include <QThread>
 
 using namespace CPlusPlus;
 
@@ -310,6 +311,18 @@ int indexerFileSizeLimitInMb()
     return -1;
 }
 
+int indexerThreadCount()
+{
+    const CppCodeModelSettings *settings = codeModelSettings();
+    QTC_ASSERT(settings, return 1);
+
+    const int threadCount = settings->indexerThreadCount();
+    if (threadCount == 0)
+        return qMax(1, QThread::idealThreadCount());
+
+    return threadCount;
+}
+
 bool fileSizeExceedsLimit(const QFileInfo &fileInfo, int sizeLimitInMb)
 {
     if (sizeLimitInMb <= 0)
@@ -81,6 +81,7 @@ CppCodeModelSettings CPPTOOLS_EXPORT *codeModelSettings();
 UsePrecompiledHeaders CPPTOOLS_EXPORT getPchUsage();
 
 int indexerFileSizeLimitInMb();
+int indexerThreadCount();
 bool fileSizeExceedsLimit(const QFileInfo &fileInfo, int sizeLimitInMb);
 
 class ClangDiagnosticConfigsModel;
@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "documentsummarycache.h"
+
+#include <coreplugin/icore.h>
+
+#include <utils/algorithm.h>
+#include <utils/fileutils.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+using namespace CPlusPlus;
+
+static Q_LOGGING_CATEGORY(log, "qtc.cpptools.summarycache", QtWarningMsg)
+
+namespace CppTools {
+namespace Internal {
+
+namespace {
+
+const char magic[] = "QTCCPPSUMMARIES";
+const qint32 formatVersion = 1;
+
+class Summary
+{
+public:
+    qint64 lastModified = 0;
+    qint64 size = 0;
+    QStringList includes;
+    IndexItem::Ptr symbols;
+};
+
+bool isUpToDate(const QString &fileName, const Summary &summary)
+{
+    const QFileInfo info(fileName);
+    return info.exists()
+            && info.size() == summary.size
+            && info.lastModified().toMSecsSinceEpoch() == summary.lastModified;
+}
+
+// Whether the file and all files it includes have an up to date summary.
+bool includesAreUpToDate(const QString &fileName, const QHash<QString, Summary> &summaries,
+                         const DocumentSummaryCache::SymbolsByFile &upToDateSymbols)
+{
+    QSet<QString> visited;
+    QStringList todo(fileName);
+    while (!todo.isEmpty()) {
+        const QString includedFile = todo.takeLast();
+        if (visited.contains(includedFile))
+            continue;
+        visited.insert(includedFile);
+
+        if (!upToDateSymbols.contains(includedFile))
+            return false;
+        todo << summaries.value(includedFile).includes;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+DocumentSummaryCache::DocumentSummaryCache(const QString &cacheFilePath)
+    : m_cacheFilePath(cacheFilePath)
+{
+}
+
+QString DocumentSummaryCache::cacheFilePathForProject(const QString &projectFilePath)
+{
+    const QByteArray hash = QCryptographicHash::hash(projectFilePath.toUtf8(),
+                                                     QCryptographicHash::Sha1).toHex();
+    return Core::ICore::cacheResourcePath() + "/cppsummaries/"
+            + QString::fromLatin1(hash) + ".bin";
+}
+
+bool DocumentSummaryCache::save(const QSet<QString> &sourceFiles,
+                                const Snapshot &snapshot,
+                                const SymbolsByFile &symbolsByFile,
+                                const QByteArray &definesFingerprint) const
+{
+    QList<Document::Ptr> documents;
+    QSet<QString> visited;
+    QStringList todo = Utils::toList(sourceFiles);
+    while (!todo.isEmpty()) {
+        const QString fileName = todo.takeLast();
+        if (visited.contains(fileName))
+            continue;
+        visited.insert(fileName);
+
+        const Document::Ptr document = snapshot.document(fileName);
+        if (!document)
+            continue;
+        todo << document->includedFiles();
+
+        // Documents from the working copy do not reflect the file on disk.
+        if (document->editorRevision() == 0 && document->lastModified().isValid()
+                && symbolsByFile.contains(fileName)) {
+            documents << document;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(m_cacheFilePath).absolutePath());
+    Utils::FileSaver saver(m_cacheFilePath);
+    if (!saver.hasError()) {
+        QDataStream stream(saver.file());
+        stream.setVersion(QDataStream::Qt_5_12);
+        stream << QByteArray(magic) << formatVersion << definesFingerprint
+               << qint32(documents.size());
+        for (const Document::Ptr &document : qAsConst(documents)) {
+            const QString fileName = document->fileName();
+            const QFileInfo info(fileName);
+            stream << fileName << document->lastModified().toMSecsSinceEpoch() << info.size()
+                   << document->includedFiles();
+            symbolsByFile.value(fileName)->serialize(stream);
+        }
+        saver.setResult(&stream);
+    }
+    if (!saver.finalize()) {
+        qCWarning(log) << "Could not write" << m_cacheFilePath << ":" << saver.errorString();
+        return false;
+    }
+
+    qCDebug(log) << "Wrote" << documents.size() << "summaries to" << m_cacheFilePath;
+    return true;
+}
+
+DocumentSummaryCache::SymbolsByFile DocumentSummaryCache::load(
+        const QSet<QString> &sourceFiles, const QByteArray &definesFingerprint,
+        QSet<QString> *upToDateSourceFiles) const
+{
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    QByteArray fileMagic;
+    qint32 fileFormatVersion;
+    QByteArray fileDefinesFingerprint;
+    qint32 count;
+    stream >> fileMagic >> fileFormatVersion >> fileDefinesFingerprint >> count;
+    if (stream.status() != QDataStream::Ok || fileMagic != magic
+            || fileFormatVersion != formatVersion || count < 0) {
+        qCDebug(log) << "Ignoring incompatible cache file" << m_cacheFilePath;
+        return {};
+    }
+    if (fileDefinesFingerprint != definesFingerprint) {
+        qCDebug(log) << "Ignoring" << m_cacheFilePath << "since the project defines changed.";
+        return {};
+    }
+
+    QHash<QString, Summary> summaries;
+    summaries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QString fileName;
+        Summary summary;
+        stream >> fileName >> summary.lastModified >> summary.size >> summary.includes;
+        summary.symbols = IndexItem::deserialize(stream);
+        if (stream.status() != QDataStream::Ok || !summary.symbols) {
+            qCWarning(log) << "Ignoring corrupt cache file" << m_cacheFilePath;
+            return {};
+        }
+        summaries.insert(fileName, summary);
+    }
+
+    // Only files reachable from the source files are stat'ed, files that changed on disk
+    // are dropped. Their includes might still be valid and are visited regardless.
+    SymbolsByFile result;
+    QSet<QString> visited;
+    QStringList todo = Utils::toList(sourceFiles);
+    while (!todo.isEmpty()) {
+        const QString fileName = todo.takeLast();
+        if (visited.contains(fileName))
+            continue;
+        visited.insert(fileName);
+
+        const auto it = summaries.constFind(fileName);
+        if (it == summaries.constEnd())
+            continue;
+        todo << it->includes;
+        if (isUpToDate(fileName, *it))
+            result.insert(fileName, it->symbols);
+    }
+
+    if (upToDateSourceFiles) {
+        for (const QString &sourceFile : sourceFiles) {
+            if (includesAreUpToDate(sourceFile, summaries, result))
+                upToDateSourceFiles->insert(sourceFile);
+        }
+    }
+
+    qCDebug(log) << "Loaded" << result.size() << "of" << summaries.size() << "summaries from"
+                 << m_cacheFilePath;
+    return result;
+}
+
+} // namespace Internal
+} // namespace CppTools
@@ -0,0 +1,72 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "indexitem.h"
+
+#include <cplusplus/CppDocument.h>
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+namespace CppTools {
+namespace Internal {
+
+// Persists the include graph and the locator symbols of the indexed documents of a project,
+// so that they are available right after opening the project again, before the indexer is done.
+// The indexer skips the files whose summary and whose includes' summaries are still valid,
+// their documents are only parsed once they are opened or change. The other documents are
+// parsed again as usual and their symbols replace the cached ones.
+class DocumentSummaryCache
+{
+public:
+    using SymbolsByFile = QHash<QString, IndexItem::Ptr>;
+
+    explicit DocumentSummaryCache(const QString &cacheFilePath);
+
+    static QString cacheFilePathForProject(const QString &projectFilePath);
+
+    // Writes all documents reachable from sourceFiles that were read from disk.
+    bool save(const QSet<QString> &sourceFiles,
+              const CPlusPlus::Snapshot &snapshot,
+              const SymbolsByFile &symbolsByFile,
+              const QByteArray &definesFingerprint) const;
+
+    // Returns the symbols of all files reachable from sourceFiles that did not change on
+    // disk since they were saved. Nothing is returned if the defines changed meanwhile.
+    // upToDateSourceFiles gets the source files for which this holds for all files they
+    // include, too.
+    SymbolsByFile load(const QSet<QString> &sourceFiles,
+                       const QByteArray &definesFingerprint,
+                       QSet<QString> *upToDateSourceFiles = nullptr) const;
+
+private:
+    QString m_cacheFilePath;
+};
+
+} // namespace Internal
+} // namespace CppTools
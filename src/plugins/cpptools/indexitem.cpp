@@ -24,14 +24,18 @@
 ****************************************************************************/
 
 #include "indexitem.h"
+#include "stringtable.h"
 
 #include <utils/fileutils.h>
 
+#include <QDataStream>
+
 using namespace CppTools;
 
 IndexItem::Ptr IndexItem::create(const QString &symbolName, const QString &symbolType,
                                  const QString &symbolScope, IndexItem::ItemType type,
-                                 const QString &fileName, int line, int column, const QIcon &icon)
+                                 const QString &fileName, int line, int column,
+                                 Utils::CodeModelIcon::Type iconType)
 {
     Ptr ptr(new IndexItem);
 
@@ -42,7 +46,7 @@ IndexItem::Ptr IndexItem::create(const QString &symbolName, const QString &symbo
     ptr->m_fileName = fileName;
     ptr->m_line = line;
     ptr->m_column = column;
-    ptr->m_icon = icon;
+    ptr->m_iconType = iconType;
 
     return ptr;
 }
@@ -60,6 +64,82 @@ IndexItem::Ptr IndexItem::create(const QString &fileName, int sizeHint)
     return ptr;
 }
 
+void IndexItem::serialize(QDataStream &stream) const
+{
+    stream << m_symbolName << m_symbolType << m_symbolScope << m_fileName
+           << qint32(m_iconType) << qint32(m_type) << qint32(m_line) << qint32(m_column)
+           << qint32(m_children.size());
+    for (const IndexItem::Ptr &child : m_children)
+        child->serialize(stream);
+}
+
+static bool isValidType(qint32 type)
+{
+    switch (type) {
+    case IndexItem::Enum:
+    case IndexItem::Class:
+    case IndexItem::Function:
+    case IndexItem::Declaration:
+    case IndexItem::All:
+        return true;
+    default:
+        return false;
+    }
+}
+
+IndexItem::Ptr IndexItem::deserialize(QDataStream &stream)
+{
+    QString symbolName;
+    QString symbolType;
+    QString symbolScope;
+    QString fileName;
+    qint32 iconType;
+    qint32 type;
+    qint32 line;
+    qint32 column;
+    qint32 childCount;
+    stream >> symbolName >> symbolType >> symbolScope >> fileName
+           >> iconType >> type >> line >> column >> childCount;
+    if (stream.status() != QDataStream::Ok || childCount < 0
+            || iconType < 0 || iconType > Utils::CodeModelIcon::Unknown
+            || !isValidType(type)) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return Ptr();
+    }
+
+    using Internal::StringTable;
+    Ptr ptr(new IndexItem);
+    ptr->m_symbolName = StringTable::insert(symbolName);
+    ptr->m_symbolType = StringTable::insert(symbolType);
+    ptr->m_symbolScope = StringTable::insert(symbolScope);
+    ptr->m_fileName = StringTable::insert(fileName);
+    ptr->m_iconType = Utils::CodeModelIcon::Type(iconType);
+    ptr->m_type = ItemType(type);
+    ptr->m_line = line;
+    ptr->m_column = column;
+    ptr->m_children.reserve(childCount);
+    for (int i = 0; i < childCount; ++i) {
+        const Ptr child = deserialize(stream);
+        if (!child)
+            return Ptr();
+        ptr->m_children.append(child);
+    }
+
+    return ptr;
+}
+
+QIcon IndexItem::icon() const
+{
+    // One shared icon per type instead of one per item.
+    static const QVector<QIcon> icons = [] {
+        QVector<QIcon> icons;
+        for (int type = 0; type <= Utils::CodeModelIcon::Unknown; ++type)
+            icons.append(Utils::CodeModelIcon::iconForType(Utils::CodeModelIcon::Type(type)));
+        return icons;
+    }();
+    return icons.at(m_iconType);
+}
+
 bool IndexItem::unqualifiedNameAndScope(const QString &defaultName, QString *name,
                                         QString *scope) const
 {
@@ -27,12 +27,18 @@
 
 #include "cpptools_global.h"
 
+#include <utils/utilsicons.h>
+
 #include <QIcon>
 #include <QSharedPointer>
 #include <QMetaType>
 
 #include <functional>
 
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
 namespace CppTools {
 
 class CPPTOOLS_EXPORT IndexItem
@@ -60,9 +66,13 @@ public:
                       const QString &fileName,
                       int line,
                       int column,
-                      const QIcon &icon);
+                      Utils::CodeModelIcon::Type iconType);
     static Ptr create(const QString &fileName, int sizeHint);
 
+    // Serialization of the item and all of its children, e.g. for persistent caches.
+    void serialize(QDataStream &stream) const;
+    static Ptr deserialize(QDataStream &stream);
+
     QString scopedSymbolName() const
     {
         return m_symbolScope.isEmpty()
@@ -80,7 +90,8 @@ public:
     QString symbolType() const { return m_symbolType; }
     QString symbolScope() const { return m_symbolScope; }
     QString fileName() const { return m_fileName; }
-    QIcon icon() const { return m_icon; }
+    QIcon icon() const;
+    Utils::CodeModelIcon::Type iconType() const { return m_iconType; }
     ItemType type() const { return m_type; }
     int line() const { return m_line; }
     int column() const { return m_column; }
@@ -122,7 +133,7 @@ private:
     QString m_symbolType;
     QString m_symbolScope;
     QString m_fileName;
-    QIcon m_icon;
+    Utils::CodeModelIcon::Type m_iconType = Utils::CodeModelIcon::Unknown;
     ItemType m_type = All;
     int m_line = 0;
     int m_column = 0;
@@ -295,7 +295,7 @@ IndexItem::Ptr SearchSymbols::addChildItem(const QString &symbolName, const QStr
         m_paths.insert(symbol->fileId(), path);
     }
 
-    const QIcon icon = Icons::iconForSymbol(symbol);
+    const Utils::CodeModelIcon::Type iconType = Icons::iconTypeForSymbol(symbol);
 
     IndexItem::Ptr newItem = IndexItem::create(Internal::StringTable::insert(symbolName),
                                                Internal::StringTable::insert(symbolType),
@@ -304,7 +304,7 @@ IndexItem::Ptr SearchSymbols::addChildItem(const QString &symbolName, const QStr
                                                Internal::StringTable::insert(path),
                                                symbol->line(),
                                                symbol->column() - 1, // 1-based vs 0-based column
-                                               icon);
+                                               iconType);
     _parent->addChild(newItem);
     return newItem;
 }
@@ -83,6 +83,18 @@ public:
     QString m_scope;
 };
 
+ResultDataList search(CppIndexingSupport *indexingSupport,
+                      const SymbolSearcher::Parameters &searchParameters,
+                      const QSet<QString> &fileNames)
+{
+    const QScopedPointer<SymbolSearcher> symbolSearcher(
+        indexingSupport->createSymbolSearcher(searchParameters, fileNames));
+    QFuture<Core::SearchResultItem> search
+        = Utils::runAsync(&SymbolSearcher::runSearch, symbolSearcher.data());
+    search.waitForFinished();
+    return ResultData::fromSearchResultList(search.results());
+}
+
 class SymbolSearcherTestCase : public Tests::TestCase
 {
 public:
@@ -100,13 +112,8 @@ public:
         m_indexingSupportToRestore = m_modelManager->indexingSupport();
         m_modelManager->setIndexingSupport(m_indexingSupportToUse);
 
-        CppIndexingSupport *indexingSupport = m_modelManager->indexingSupport();
-        const QScopedPointer<SymbolSearcher> symbolSearcher(
-            indexingSupport->createSymbolSearcher(searchParameters, QSet<QString>() << testFile));
-        QFuture<Core::SearchResultItem> search
-            = Utils::runAsync(&SymbolSearcher::runSearch, symbolSearcher.data());
-        search.waitForFinished();
-        ResultDataList results = ResultData::fromSearchResultList(search.results());
+        const ResultDataList results = search(m_modelManager->indexingSupport(),
+                                              searchParameters, {testFile});
         QCOMPARE(results, expectedResults);
     }
 
@@ -287,3 +294,48 @@ void CppToolsPlugin::test_builtinsymbolsearcher_data()
             << ResultData(_("int myVariable"), _("<anonymous namespace>"))
         );
 }
+
+// Searches documents in several chunks and repeats searches on the cached symbols.
+void CppToolsPlugin::test_builtinsymbolsearcher_manyDocuments()
+{
+    Tests::TestCase testCase;
+    QVERIFY(testCase.succeededSoFar());
+    Tests::TemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+
+    const int documentCount = 100;
+    QSet<QString> fileNames;
+    ResultDataList expectedFunctions;
+    for (int i = 0; i < documentCount; ++i) {
+        const QByteArray number = QByteArray::number(i);
+        fileNames << temporaryDir.createFile("file" + number + ".cpp",
+                                             "class Class" + number + " {};\n"
+                                             "void function" + number + "() {}\n");
+        expectedFunctions << ResultData("function" + _(number) + "()", _(""));
+    }
+    QVERIFY(testCase.parseFiles(fileNames));
+
+    BuiltinIndexingSupport indexingSupport;
+    SymbolSearcher::Parameters searchParameters;
+    searchParameters.text = _("function");
+    searchParameters.types = SearchSymbols::Functions;
+    searchParameters.scope = SymbolSearcher::SearchGlobal;
+
+    const ResultDataList functions = search(&indexingSupport, searchParameters, fileNames);
+    QCOMPARE(functions.size(), documentCount);
+    for (const ResultData &expected : qAsConst(expectedFunctions))
+        QVERIFY(functions.contains(expected));
+
+    // Cached symbols give the same results in the same order.
+    QCOMPARE(search(&indexingSupport, searchParameters, fileNames), functions);
+
+    // Cached symbols of other types are not reused.
+    searchParameters.text = _("Class");
+    searchParameters.types = SearchSymbols::Classes;
+    const ResultDataList classes = search(&indexingSupport, searchParameters, fileNames);
+    QCOMPARE(classes.size(), documentCount);
+    for (const ResultData &result : classes)
+        QVERIFY(result.m_symbolName.startsWith(_("Class")));
+
+    QVERIFY(testCase.garbageCollectGlobalSnapshot());
+}
@@ -452,7 +452,8 @@ void LanguageClientManager::editorOpened(Core::IEditor *editor)
 void LanguageClientManager::documentOpened(Core::IDocument *document)
 {
     auto textDocument = qobject_cast<TextEditor::TextDocument *>(document);
-    if (!textDocument)
+    // large files only contain a window of their lines
+    if (!textDocument || textDocument->isLargeFile())
         return;
 
     // check whether we have to start servers for this document
@@ -40,7 +40,9 @@
 #include <utils/fadingindicator.h>
 #include <utils/filesearch.h>
 #include <utils/qtcassert.h>
+#include <utils/runextensions.h>
 #include <utils/stylehelper.h>
+#include <utils/trigramindex.h>
 
 #include <QDebug>
 #include <QSettings>
@@ -49,7 +51,9 @@
 #include <QStringListModel>
 #include <QFutureWatcher>
 #include <QPointer>
+#include <QCheckBox>
 #include <QComboBox>
+#include <QHBoxLayout>
 #include <QLabel>
 
 using namespace Utils;
@@ -59,17 +63,58 @@ namespace TextEditor {
 namespace Internal {
 
 namespace {
+
+const char useSearchIndexKey[] = "UseSearchIndex";
+
+Utils::TrigramIndex *s_searchIndex = nullptr;
+QFuture<void> s_searchIndexLoad;
+
+QString searchIndexFilePath()
+{
+    return ICore::cacheResourcePath() + "/findinfiles.index";
+}
+
+// The index is loaded in the background on first use. Until it is loaded, files are searched
+// without it.
+Utils::TrigramIndex *searchIndex()
+{
+    if (!s_searchIndex) {
+        s_searchIndex = new Utils::TrigramIndex(ICore::instance());
+        Utils::TrigramIndex *index = s_searchIndex;
+        s_searchIndexLoad = Utils::runAsync([index, filePath = searchIndexFilePath()] {
+            index->load(filePath);
+        });
+    }
+
+    return s_searchIndexLoad.isFinished() ? s_searchIndex : nullptr;
+}
+
 class InternalEngine : public TextEditor::SearchEngine
 {
 public:
-    InternalEngine() : m_widget(new QWidget) {}
+    InternalEngine()
+        : m_widget(new QWidget)
+    {
+        auto layout = new QHBoxLayout(m_widget);
+        layout->setContentsMargins(0, 0, 0, 0);
+        // Opt-in, the index costs memory for every file that was searched once.
+        m_useSearchIndex = new QCheckBox(TextEditor::SearchEngine::tr(
+                                             "Remember searched files to speed up later searches"));
+        layout->addWidget(m_useSearchIndex);
+    }
     ~InternalEngine() override { delete m_widget;}
     QString title() const override { return TextEditor::SearchEngine::tr("Internal"); }
     QString toolTip() const override { return {}; }
     QWidget *widget() const override { return m_widget; }
-    QVariant parameters() const override { return {}; }
-    void readSettings(QSettings * /*settings*/) override {}
-    void writeSettings(QSettings * /*settings*/) const override {}
+    QVariant parameters() const override { return m_useSearchIndex->isChecked(); }
+    void readSettings(QSettings *settings) override
+    {
+        m_useSearchIndex->setChecked(settings->value(useSearchIndexKey, false).toBool());
+    }
+    void writeSettings(QSettings *settings) const override
+    {
+        settings->setValue(useSearchIndexKey, m_useSearchIndex->isChecked());
+    }
     QFuture<Utils::FileSearchResultList> executeSearch(
             const TextEditor::FileFindParameters &parameters,
             BaseFileFind *baseFileFind) override
@@ -81,7 +126,8 @@ public:
                     baseFileFind->files(parameters.nameFilters, parameters.exclusionFilters,
                                         parameters.additionalParameters),
                     textDocumentFlagsForFindFlags(parameters.flags),
-                    TextDocument::openedTextDocumentContents());
+                    TextDocument::openedTextDocumentContents(),
+                    parameters.searchEngineParameters.toBool() ? searchIndex() : nullptr);
 
     }
     Core::IEditor *openEditor(const Core::SearchResultItem &/*item*/,
@@ -92,6 +138,7 @@ public:
 
 private:
     QWidget *m_widget;
+    QCheckBox *m_useSearchIndex;
 };
 } // namespace
 
@@ -127,6 +174,23 @@ public:
     int m_currentSearchEngineIndex = -1;
 };
 
+// Writing a large index takes a while, so it is not done on the GUI thread.
+QFuture<void> saveSearchIndex()
+{
+    if (!s_searchIndex)
+        return {};
+
+    // The index must not be deleted while it is still loading, but it is unchanged then.
+    if (!s_searchIndexLoad.isFinished())
+        return s_searchIndexLoad;
+
+    if (!s_searchIndex->isModified())
+        return {};
+
+    Utils::TrigramIndex *index = s_searchIndex;
+    return Utils::runAsync([index, filePath = searchIndexFilePath()] { index->save(filePath); });
+}
+
 } // namespace Internal
 
 static void syncComboWithSettings(QComboBox *combo, const QString &setting)
@@ -45,6 +45,8 @@ namespace TextEditor {
 namespace Internal {
 class BaseFileFindPrivate;
 class SearchEnginePrivate;
+
+QFuture<void> saveSearchIndex();
 } // Internal
 
 class TEXTEDITOR_EXPORT FileFindParameters
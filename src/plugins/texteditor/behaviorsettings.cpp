@@ -38,6 +38,7 @@ static const char camelCaseNavigationKey[] = "CamelCaseNavigation";
 static const char keyboardTooltips[] = "KeyboardTooltips";
 static const char groupPostfix[] = "BehaviorSettings";
 static const char smartSelectionChanging[] = "SmartSelectionChanging";
+static const char largeFileThresholdKey[] = "LargeFileThresholdInMB";
 
 namespace TextEditor {
 
@@ -48,7 +49,8 @@ BehaviorSettings::BehaviorSettings() :
     m_constrainHoverTooltips(false),
     m_camelCaseNavigation(true),
     m_keyboardTooltips(false),
-    m_smartSelectionChanging(true)
+    m_smartSelectionChanging(true),
+    m_largeFileThresholdInMB(16)
 {
 }
 
@@ -72,6 +74,7 @@ void BehaviorSettings::toMap(const QString &prefix, QVariantMap *map) const
     map->insert(prefix + QLatin1String(camelCaseNavigationKey), m_camelCaseNavigation);
     map->insert(prefix + QLatin1String(keyboardTooltips), m_keyboardTooltips);
     map->insert(prefix + QLatin1String(smartSelectionChanging), m_smartSelectionChanging);
+    map->insert(prefix + QLatin1String(largeFileThresholdKey), m_largeFileThresholdInMB);
 }
 
 void BehaviorSettings::fromMap(const QString &prefix, const QVariantMap &map)
@@ -91,6 +94,9 @@ void BehaviorSettings::fromMap(const QString &prefix, const QVariantMap &map)
     m_smartSelectionChanging =
         map.value(prefix + QLatin1String(smartSelectionChanging), m_smartSelectionChanging)
            .toBool();
+    m_largeFileThresholdInMB =
+        map.value(prefix + QLatin1String(largeFileThresholdKey), m_largeFileThresholdInMB)
+           .toInt();
 }
 
 bool BehaviorSettings::equals(const BehaviorSettings &ds) const
@@ -102,6 +108,7 @@ bool BehaviorSettings::equals(const BehaviorSettings &ds) const
         && m_camelCaseNavigation == ds.m_camelCaseNavigation
         && m_keyboardTooltips == ds.m_keyboardTooltips
         && m_smartSelectionChanging == ds.m_smartSelectionChanging
+        && m_largeFileThresholdInMB == ds.m_largeFileThresholdInMB
         ;
 }
 
@@ -59,6 +59,7 @@ public:
     bool m_camelCaseNavigation;
     bool m_keyboardTooltips;
     bool m_smartSelectionChanging;
+    int m_largeFileThresholdInMB; // 0 disables the large file mode
 };
 
 inline bool operator==(const BehaviorSettings &t1, const BehaviorSettings &t2) { return t1.equals(t2); }
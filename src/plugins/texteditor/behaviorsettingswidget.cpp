@@ -29,6 +29,7 @@
 #include "tabsettingswidget.h"
 
 #include <coreplugin/coreconstants.h>
+#include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/icore.h>
 
 #include <texteditor/typingsettings.h>
@@ -38,6 +39,7 @@
 #include <utils/algorithm.h>
 
 #include <QList>
+#include <QSpinBox>
 #include <QString>
 #include <QByteArray>
 #include <QTextCodec>
@@ -86,6 +88,9 @@ BehaviorSettingsWidget::BehaviorSettingsWidget(QWidget *parent)
 
     d->m_ui.defaultLineEndings->addItems(ExtraEncodingSettings::lineTerminationModeNames());
 
+    // larger text files are opened in the binary editor
+    d->m_ui.largeFileThreshold->setMaximum(int(Core::EditorManager::maxTextFileSize() >> 20));
+
     auto currentIndexChanged = QOverload<int>::of(&QComboBox::currentIndexChanged);
     connect(d->m_ui.autoIndent, &QAbstractButton::toggled,
             this, &BehaviorSettingsWidget::slotTypingSettingsChanged);
@@ -121,6 +126,8 @@ BehaviorSettingsWidget::BehaviorSettingsWidget(QWidget *parent)
             this, &BehaviorSettingsWidget::slotBehaviorSettingsChanged);
     connect(d->m_ui.smartSelectionChanging, &QAbstractButton::clicked,
             this, &BehaviorSettingsWidget::slotBehaviorSettingsChanged);
+    connect(d->m_ui.largeFileThreshold, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &BehaviorSettingsWidget::slotBehaviorSettingsChanged);
 }
 
 BehaviorSettingsWidget::~BehaviorSettingsWidget()
@@ -231,6 +238,7 @@ void BehaviorSettingsWidget::setAssignedBehaviorSettings(const BehaviorSettings
     d->m_ui.camelCaseNavigation->setChecked(behaviorSettings.m_camelCaseNavigation);
     d->m_ui.keyboardTooltips->setChecked(behaviorSettings.m_keyboardTooltips);
     d->m_ui.smartSelectionChanging->setChecked(behaviorSettings.m_smartSelectionChanging);
+    d->m_ui.largeFileThreshold->setValue(behaviorSettings.m_largeFileThresholdInMB);
     updateConstrainTooltipsBoxTooltip();
 }
 
@@ -243,6 +251,7 @@ void BehaviorSettingsWidget::assignedBehaviorSettings(BehaviorSettings *behavior
     behaviorSettings->m_camelCaseNavigation = d->m_ui.camelCaseNavigation->isChecked();
     behaviorSettings->m_keyboardTooltips = d->m_ui.keyboardTooltips->isChecked();
     behaviorSettings->m_smartSelectionChanging = d->m_ui.smartSelectionChanging->isChecked();
+    behaviorSettings->m_largeFileThresholdInMB = d->m_ui.largeFileThreshold->value();
 }
 
 void BehaviorSettingsWidget::setAssignedExtraEncodingSettings(
@@ -0,0 +1,300 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include "largefileindex.h"
+
+#include <utils/qtcassert.h>
+#include <utils/runextensions.h>
+
+#include <QScopedPointer>
+#include <QTextCodec>
+
+#include <cstring>
+
+namespace TextEditor {
+namespace Internal {
+
+const int checkpointInterval = 256;
+const int checkpointsPerResult = 4096;
+const int maxLineLength = 16 * 1024;
+const int maxTextSize = 8 * 1024 * 1024;
+const int readChunkSize = 1024 * 1024;
+
+namespace {
+
+// Reads the lines of a file through a buffer. The file is read instead of being mapped,
+// so a file that is truncated meanwhile only ends early.
+class LineReader
+{
+public:
+    LineReader(QIODevice &device, qint64 offset)
+        : m_device(device)
+        , m_offset(offset)
+    {
+        m_atEnd = !m_device.seek(offset);
+    }
+
+    // Returns the line at offset() without its line break, or false if there is no more line.
+    // Only the first maxLineLength bytes of a longer line are returned. The data stays valid
+    // until the next call.
+    bool readLine(const char **data, int *length)
+    {
+        if (!m_hasLine)
+            return false;
+
+        fillBuffer();
+        const char *begin = m_buffer.constData() + m_position;
+        const int available = m_buffer.size() - m_position;
+        const auto newLine = static_cast<const char *>(
+                    std::memchr(begin, '\n', size_t(qMin(available, maxLineLength + 1))));
+        m_isTruncated = false;
+        if (newLine) {
+            *length = int(newLine - begin);
+            consume(*length + 1);
+            m_hasLine = true;
+            if (*length > 0 && begin[*length - 1] == '\r')
+                --*length;
+        } else if (available > maxLineLength) {
+            // do not split UTF-8 sequences
+            *length = maxLineLength;
+            while (*length > maxLineLength - 3 && (uchar(begin[*length]) & 0xc0) == 0x80)
+                --*length;
+            m_truncatedLine = QByteArray(begin, *length);
+            begin = m_truncatedLine.constData();
+            m_isTruncated = true;
+            skipRestOfLine();
+        } else {
+            *length = available;
+            consume(available);
+            m_hasLine = false;
+        }
+
+        *data = begin;
+        return true;
+    }
+
+    bool isTruncated() const { return m_isTruncated; } // of the last line that was read
+    bool hasLine() const { return m_hasLine; }
+    qint64 offset() const { return m_offset; } // start of the next line
+
+private:
+    void consume(int length)
+    {
+        m_position += length;
+        m_offset += length;
+    }
+
+    void skipRestOfLine()
+    {
+        while (true) {
+            const char *begin = m_buffer.constData() + m_position;
+            const int available = m_buffer.size() - m_position;
+            const auto newLine = static_cast<const char *>(
+                        std::memchr(begin, '\n', size_t(available)));
+            if (newLine) {
+                consume(int(newLine - begin) + 1);
+                m_hasLine = true;
+                return;
+            }
+            consume(available);
+            m_buffer.clear();
+            m_position = 0;
+            if (m_atEnd) {
+                m_hasLine = false;
+                return;
+            }
+            m_buffer = m_device.read(readChunkSize);
+            m_atEnd = m_buffer.isEmpty();
+        }
+    }
+
+    // Makes sure that a whole line and the byte behind it are buffered, if the file has them.
+    void fillBuffer()
+    {
+        while (!m_atEnd && m_buffer.size() - m_position <= maxLineLength) {
+            m_buffer.remove(0, m_position);
+            m_position = 0;
+            const QByteArray chunk = m_device.read(readChunkSize);
+            if (chunk.isEmpty())
+                m_atEnd = true;
+            else
+                m_buffer.append(chunk);
+        }
+    }
+
+    QIODevice &m_device;
+    QByteArray m_buffer;
+    QByteArray m_truncatedLine;
+    int m_position = 0;
+    qint64 m_offset = 0;
+    bool m_atEnd = false;
+    bool m_hasLine = true; // an empty file or the end behind a line break are an empty line
+    bool m_isTruncated = false;
+};
+
+} // anonymous namespace
+
+static void indexLines(QFutureInterface<LargeFileIndex::Checkpoints> &futureInterface,
+                       const QString &fileName, qint64 start)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    LineReader reader(file, start);
+    LargeFileIndex::Checkpoints checkpoints;
+    int lineCount = 0;
+    const char *data;
+    int length;
+    while (reader.readLine(&data, &length)) {
+        ++lineCount;
+        if (lineCount % checkpointInterval != 0 || !reader.hasLine())
+            continue;
+        if (futureInterface.isCanceled())
+            return;
+        checkpoints.offsets.append(reader.offset());
+        if (checkpoints.offsets.size() == checkpointsPerResult) {
+            futureInterface.reportResult(checkpoints);
+            checkpoints.offsets.clear();
+        }
+    }
+
+    checkpoints.lineCount = lineCount;
+    futureInterface.reportResult(checkpoints);
+}
+
+LargeFileIndex::LargeFileIndex(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_indexWatcher, &QFutureWatcherBase::resultsReadyAt,
+            this, &LargeFileIndex::addCheckpoints);
+}
+
+LargeFileIndex::~LargeFileIndex()
+{
+    m_indexWatcher.cancel();
+    m_indexWatcher.waitForFinished();
+}
+
+static bool isAsciiCompatible(const QTextCodec *codec)
+{
+    switch (codec->mibEnum()) {
+    case 1013: // UTF-16BE
+    case 1014: // UTF-16LE
+    case 1015: // UTF-16
+    case 1017: // UTF-32
+    case 1018: // UTF-32BE
+    case 1019: // UTF-32LE
+        return false;
+    default:
+        return true;
+    }
+}
+
+bool LargeFileIndex::open(const QString &fileName, const QTextCodec *defaultCodec,
+                          QString *errorString)
+{
+    QTC_ASSERT(!m_file.isOpen() && defaultCodec, return false);
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (errorString)
+            *errorString = tr("Cannot read file \"%1\": %2.").arg(fileName, m_file.errorString());
+        return false;
+    }
+
+    // the start of the file, as TextFileFormat::readFile() looks at it
+    m_format = Utils::TextFileFormat::detect(m_file.read(readChunkSize));
+    if (!m_format.codec)
+        m_format.codec = defaultCodec;
+    if (!isAsciiCompatible(m_format.codec)) {
+        m_file.close();
+        return false;
+    }
+
+    m_size = m_file.size();
+    const qint64 contentStart = m_format.hasUtf8Bom ? 3 : 0;
+    m_checkpoints.append(contentStart);
+    m_indexWatcher.setFuture(Utils::runAsync(&indexLines, fileName, contentStart));
+    return true;
+}
+
+void LargeFileIndex::addCheckpoints(int beginIndex, int endIndex)
+{
+    for (int index = beginIndex; index < endIndex; ++index) {
+        const Checkpoints checkpoints = m_indexWatcher.resultAt(index);
+        m_checkpoints += checkpoints.offsets;
+        if (checkpoints.lineCount >= 0) {
+            m_lineCount = checkpoints.lineCount;
+            m_isIndexed = true;
+            emit indexingFinished();
+        }
+    }
+}
+
+int LargeFileIndex::lineCount() const
+{
+    return m_isIndexed ? m_lineCount : -1;
+}
+
+// Only reads from the closest checkpoint in front of firstLine, which is at most
+// checkpointInterval lines away. Lines behind the checkpoints found so far are not read.
+bool LargeFileIndex::lines(int firstLine, int lineCount, QString *text)
+{
+    QTC_ASSERT(m_file.isOpen() && firstLine >= 0 && text, return false);
+
+    const int checkpoint = firstLine / checkpointInterval;
+    if (checkpoint >= m_checkpoints.size() || (m_isIndexed && firstLine >= m_lineCount))
+        return false;
+
+    LineReader reader(m_file, m_checkpoints.at(checkpoint));
+    const char *data;
+    int length;
+    for (int line = checkpoint * checkpointInterval; line < firstLine; ++line) {
+        if (!reader.readLine(&data, &length))
+            return false;
+    }
+    if (!reader.readLine(&data, &length))
+        return false;
+
+    text->clear();
+    // the codec might keep state between the lines
+    QScopedPointer<QTextDecoder> decoder(m_format.codec->makeDecoder());
+    qint64 size = 0;
+    for (int line = 0; line < lineCount; ++line) {
+        if (line > 0) {
+            if (!reader.readLine(&data, &length) || size + 1 + length > maxTextSize)
+                break;
+            text->append('\n');
+        }
+        text->append(decoder->toUnicode(data, length));
+        if (reader.isTruncated())
+            text->append(QChar(0x2026)); // horizontal ellipsis
+        size += 1 + length;
+    }
+    return true;
+}
+
+} // namespace Internal
+} // namespace TextEditor
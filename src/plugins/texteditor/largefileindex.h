@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#pragma once
+
+#include <utils/textfileformat.h>
+
+#include <QFile>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QVector>
+
+namespace TextEditor {
+namespace Internal {
+
+// Indexes the start of the lines of a huge text file in the background, so only the lines
+// that are shown in an editor need to be read and decoded. Lines longer than 16 KB are cut
+// off, so the line numbers are the ones of the file.
+class LargeFileIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Checkpoints
+    {
+        QVector<qint64> offsets; // start of every checkpointInterval-th line, in batches
+        int lineCount = -1; // only set in the last result
+    };
+
+    explicit LargeFileIndex(QObject *parent = nullptr);
+    ~LargeFileIndex() override;
+
+    // Returns false without an error string for files in UTF-16 or UTF-32, because their
+    // lines cannot be found by searching for newline bytes.
+    bool open(const QString &fileName, const QTextCodec *defaultCodec, QString *errorString);
+
+    const Utils::TextFileFormat &format() const { return m_format; }
+    qint64 size() const { return m_size; }
+    bool isIndexed() const { return m_isIndexed; }
+    int lineCount() const; // -1 until the file is indexed
+
+    // Decodes up to lineCount lines starting at the zero based firstLine, joined by '\n'.
+    // Lines that are cut off end with an ellipsis.
+    // Stops early in front of the line that would make the text larger than 8 MB.
+    // Returns false if firstLine is behind the end of the file, or behind the lines that
+    // are indexed so far.
+    bool lines(int firstLine, int lineCount, QString *text);
+
+signals:
+    void indexingFinished();
+
+private:
+    void addCheckpoints(int beginIndex, int endIndex);
+
+    QFile m_file;
+    Utils::TextFileFormat m_format;
+    qint64 m_size = 0;
+    QVector<qint64> m_checkpoints;
+    int m_lineCount = -1;
+    bool m_isIndexed = false;
+    QFutureWatcher<Checkpoints> m_indexWatcher;
+};
+
+} // namespace Internal
+} // namespace TextEditor
@@ -32,13 +32,18 @@
 #include <utils/algorithm.h>
 #include <utils/qtcassert.h>
 
+#include <QElapsedTimer>
 #include <QTextDocument>
 #include <QPointer>
+#include <QTimer>
 
 #include <cmath>
 
 namespace TextEditor {
 
+// Time a full rehighlight may block the event loop before it continues with the next chunk.
+const int backgroundHighlightingBudgetMs = 5;
+
 class SyntaxHighlighterPrivate
 {
     SyntaxHighlighter *q_ptr = nullptr;
@@ -52,7 +57,13 @@ public:
     QPointer<QTextDocument> doc;
 
     void reformatBlocks(int from, int charsRemoved, int charsAdded);
-    void reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded);
+    void reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded,
+                       TextDocumentLayout::FoldValidator *validator);
+
+    void startBackgroundHighlighting();
+    void stopBackgroundHighlighting();
+    void highlightPriorityBlocks();
+    int backgroundHighlightingPosition() const;
 
     inline void rehighlight(QTextCursor &cursor, QTextCursor::MoveOperation operation) {
         inReformatBlocks = true;
@@ -71,6 +82,15 @@ public:
     bool rehighlightPending = false;
     bool inReformatBlocks = false;
     TextDocumentLayout::FoldValidator foldValidator;
+
+    // Full rehighlights run in chunks, the cursor marks the first block that is not done yet.
+    QTextCursor backgroundHighlightingCursor;
+    QTimer backgroundHighlightingTimer;
+    TextDocumentLayout::FoldValidator backgroundFoldValidator;
+    int priorityFirstBlockNumber = -1;
+    int priorityLastBlockNumber = -1;
+    bool priorityBlocksPending = false;
+
     QVector<QTextCharFormat> formats;
     QVector<std::pair<int,TextStyle>> formatCategories;
     QTextCharFormat whitespaceFormat;
@@ -95,7 +115,7 @@ void SyntaxHighlighter::delayedRehighlight()
     if (!d->rehighlightPending)
         return;
     d->rehighlightPending = false;
-    rehighlight();
+    rehighlightInBackground();
 }
 
 void SyntaxHighlighterPrivate::applyFormatChanges(int from, int charsRemoved, int charsAdded)
@@ -174,6 +194,11 @@ void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int ch
     if (!block.isValid())
         return;
 
+    // Blocks behind the background highlighting are done when it gets there.
+    const int backgroundPosition = backgroundHighlightingPosition();
+    if (backgroundPosition >= 0 && block.position() > backgroundPosition)
+        return;
+
     int endPosition;
     QTextBlock lastBlock = doc->findBlock(from + charsAdded + (charsRemoved > 0 ? 1 : 0));
     if (lastBlock.isValid())
@@ -183,10 +208,13 @@ void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int ch
 
     bool forceHighlightOfNextBlock = false;
 
-    while (block.isValid() && (block.position() < endPosition || forceHighlightOfNextBlock)) {
+    while (block.isValid()
+           && (block.position() < endPosition
+               || (forceHighlightOfNextBlock
+                   && (backgroundPosition < 0 || block.position() <= backgroundPosition)))) {
         const int stateBeforeHighlight = block.userState();
 
-        reformatBlock(block, from, charsRemoved, charsAdded);
+        reformatBlock(block, from, charsRemoved, charsAdded, &foldValidator);
 
         forceHighlightOfNextBlock = (block.userState() != stateBeforeHighlight);
 
@@ -198,7 +226,8 @@ void SyntaxHighlighterPrivate::reformatBlocks(int from, int charsRemoved, int ch
     foldValidator.finalize();
 }
 
-void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded)
+void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from, int charsRemoved, int charsAdded,
+                                             TextDocumentLayout::FoldValidator *validator)
 {
     Q_Q(SyntaxHighlighter);
 
@@ -210,11 +239,81 @@ void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock &block, int from,
     q->highlightBlock(block.text());
     applyFormatChanges(from, charsRemoved, charsAdded);
 
-    foldValidator.process(currentBlock);
+    if (validator)
+        validator->process(currentBlock);
 
     currentBlock = QTextBlock();
 }
 
+int SyntaxHighlighterPrivate::backgroundHighlightingPosition() const
+{
+    if (backgroundHighlightingCursor.isNull())
+        return -1;
+    return backgroundHighlightingCursor.block().position();
+}
+
+void SyntaxHighlighterPrivate::startBackgroundHighlighting()
+{
+    backgroundHighlightingCursor = QTextCursor(doc->begin());
+    backgroundFoldValidator.reset();
+    priorityFirstBlockNumber = -1;
+    priorityLastBlockNumber = -1;
+    priorityBlocksPending = false;
+    rehighlightPending = false;
+}
+
+void SyntaxHighlighterPrivate::stopBackgroundHighlighting()
+{
+    backgroundHighlightingCursor = QTextCursor();
+    backgroundHighlightingTimer.stop();
+}
+
+// Highlights the visible blocks ahead of the background highlighting with whatever state the
+// previous block has. They are highlighted again with the right state once it gets there.
+void SyntaxHighlighterPrivate::highlightPriorityBlocks()
+{
+    const int backgroundPosition = backgroundHighlightingPosition();
+    QTextBlock block = doc->findBlockByNumber(priorityFirstBlockNumber);
+    while (block.isValid() && block.blockNumber() <= priorityLastBlockNumber) {
+        if (block.position() > backgroundPosition)
+            reformatBlock(block, -1, 0, 0, nullptr);
+        block = block.next();
+    }
+    priorityBlocksPending = false;
+}
+
+void SyntaxHighlighter::continueBackgroundHighlighting()
+{
+    Q_D(SyntaxHighlighter);
+    if (!d->doc || d->backgroundHighlightingCursor.isNull())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    d->inReformatBlocks = true;
+    if (d->priorityBlocksPending)
+        d->highlightPriorityBlocks();
+
+    QTextBlock block = d->backgroundHighlightingCursor.block();
+    while (block.isValid()) {
+        d->reformatBlock(block, -1, 0, 0, &d->backgroundFoldValidator);
+        block = block.next();
+        if (timer.elapsed() >= backgroundHighlightingBudgetMs)
+            break;
+    }
+    d->formatChanges.clear();
+    d->backgroundFoldValidator.finalize();
+    d->inReformatBlocks = false;
+
+    if (block.isValid()) {
+        d->backgroundHighlightingCursor.setPosition(block.position());
+        d->backgroundHighlightingTimer.start();
+    } else {
+        d->stopBackgroundHighlighting();
+    }
+}
+
 /*!
     \class SyntaxHighlighter
 
@@ -291,10 +390,14 @@ SyntaxHighlighter::~SyntaxHighlighter()
 /*!
     Installs the syntax highlighter on the given QTextDocument \a doc.
     A SyntaxHighlighter can only be used with one document at a time.
+
+    Unless automatic highlighting is disabled, the document is highlighted
+    with rehighlightInBackground() once the event loop is entered.
 */
 void SyntaxHighlighter::setDocument(QTextDocument *doc)
 {
     Q_D(SyntaxHighlighter);
+    d->stopBackgroundHighlighting();
     if (d->doc) {
         disconnect(d->doc, &QTextDocument::contentsChange, this, &SyntaxHighlighter::reformatBlocks);
 
@@ -313,6 +416,10 @@ void SyntaxHighlighter::setDocument(QTextDocument *doc)
                                       Qt::QueuedConnection);
         }
         d->foldValidator.setup(qobject_cast<TextDocumentLayout *>(doc->documentLayout()));
+        d->backgroundFoldValidator.setup(qobject_cast<TextDocumentLayout *>(doc->documentLayout()));
+        d->backgroundHighlightingTimer.setSingleShot(true);
+        connect(&d->backgroundHighlightingTimer, &QTimer::timeout,
+                this, &SyntaxHighlighter::continueBackgroundHighlighting, Qt::UniqueConnection);
     }
 }
 
@@ -329,9 +436,9 @@ QTextDocument *SyntaxHighlighter::document() const
 /*!
     \since 4.2
 
-    Reapplies the highlighting to the whole document.
+    Reapplies the highlighting to the whole document before returning.
 
-    \sa rehighlightBlock()
+    \sa rehighlightBlock(), rehighlightInBackground()
 */
 void SyntaxHighlighter::rehighlight()
 {
@@ -339,10 +446,52 @@ void SyntaxHighlighter::rehighlight()
     if (!d->doc)
         return;
 
+    d->stopBackgroundHighlighting();
     QTextCursor cursor(d->doc);
     d->rehighlight(cursor, QTextCursor::End);
 }
 
+/*!
+    Reapplies the highlighting to the whole document like rehighlight(),
+    but without blocking the event loop for long.
+
+    The first chunk of blocks is highlighted right away, the remaining
+    blocks are highlighted in time-sliced chunks from the event loop, with
+    the blocks passed to prioritizeBlocks() going first.
+
+    \sa rehighlight()
+*/
+void SyntaxHighlighter::rehighlightInBackground()
+{
+    Q_D(SyntaxHighlighter);
+    if (!d->doc)
+        return;
+
+    d->startBackgroundHighlighting();
+    continueBackgroundHighlighting();
+}
+
+/*!
+    Highlights the blocks from \a firstBlockNumber to \a lastBlockNumber
+    with the next chunk if a rehighlightInBackground() is still in progress.
+    Use this for the blocks that are visible in an editor.
+*/
+void SyntaxHighlighter::prioritizeBlocks(int firstBlockNumber, int lastBlockNumber)
+{
+    Q_D(SyntaxHighlighter);
+    if (d->backgroundHighlightingCursor.isNull() || firstBlockNumber < 0)
+        return;
+    // highlighting the blocks triggers another update of the same range
+    if (firstBlockNumber == d->priorityFirstBlockNumber
+            && lastBlockNumber == d->priorityLastBlockNumber) {
+        return;
+    }
+
+    d->priorityFirstBlockNumber = firstBlockNumber;
+    d->priorityLastBlockNumber = lastBlockNumber;
+    d->priorityBlocksPending = true;
+}
+
 /*!
     \since 4.6
 
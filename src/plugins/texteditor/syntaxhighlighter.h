@@ -75,8 +75,11 @@ public:
 
     void setNoAutomaticHighlighting(bool noAutomatic);
 
+    void prioritizeBlocks(int firstBlockNumber, int lastBlockNumber);
+
 public slots:
     void rehighlight();
+    void rehighlightInBackground();
     void rehighlightBlock(const QTextBlock &block);
 
 protected:
@@ -110,6 +113,7 @@ private:
     void setTextFormatCategories(const QVector<std::pair<int, TextStyle>> &categories);
     void reformatBlocks(int from, int charsRemoved, int charsAdded);
     void delayedRehighlight();
+    void continueBackgroundHighlighting();
 
     QScopedPointer<SyntaxHighlighterPrivate> d_ptr;
 };
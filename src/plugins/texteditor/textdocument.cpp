@@ -25,8 +25,10 @@
 
 #include "textdocument.h"
 
+#include "behaviorsettings.h"
 #include "extraencodingsettings.h"
 #include "fontsettings.h"
+#include "largefileindex.h"
 #include "textindenter.h"
 #include "storagesettings.h"
 #include "syntaxhighlighter.h"
@@ -34,6 +36,7 @@
 #include "textdocumentlayout.h"
 #include "texteditor.h"
 #include "texteditorconstants.h"
+#include "texteditorsettings.h"
 #include "typingsettings.h"
 #include <coreplugin/diffservice.h>
 #include <coreplugin/editormanager/editormanager.h>
@@ -49,6 +52,7 @@
 #include <QFileInfo>
 #include <QFutureInterface>
 #include <QScrollBar>
+#include <QSettings>
 #include <QStringList>
 #include <QTextCodec>
 
@@ -107,6 +111,9 @@ public:
 
     int m_autoSaveRevision = -1;
 
+    QScopedPointer<Internal::LargeFileIndex> m_largeFile;
+    int m_largeFileLineOffset = 0;
+
     TextMarks m_marksCache; // Marks not owned
     Utils::Guard m_modificationChangedGuard;
 };
@@ -321,7 +328,8 @@ QMap<QString, QString> TextDocument::openedTextDocumentContents()
     QMap<QString, QString> workingCopy;
     foreach (IDocument *document, DocumentModel::openedDocuments()) {
         auto textEditorDocument = qobject_cast<TextDocument *>(document);
-        if (!textEditorDocument)
+        // large files are never modified, and only contain some of their lines
+        if (!textEditorDocument || textEditorDocument->isLargeFile())
             continue;
         QString fileName = textEditorDocument->filePath().toString();
         workingCopy[fileName] = textEditorDocument->plainText();
@@ -467,7 +475,7 @@ void TextDocument::applyFontSettings()
     d->m_fontSettingsNeedsApply = false;
     if (d->m_highlighter) {
         d->m_highlighter->setFontSettings(d->m_fontSettings);
-        d->m_highlighter->rehighlight();
+        d->m_highlighter->rehighlightInBackground();
     }
 }
 
@@ -560,7 +568,7 @@ Indenter *TextDocument::indenter() const
 
 bool TextDocument::isSaveAsAllowed() const
 {
-    return true;
+    return !isLargeFile();
 }
 
 QString TextDocument::fallbackSaveAsPath() const
@@ -602,6 +610,12 @@ SyntaxHighlighter *TextDocument::syntaxHighlighter() const
  */
 bool TextDocument::save(QString *errorString, const QString &saveFileName, bool autoSave)
 {
+    if (isLargeFile()) {
+        if (errorString)
+            *errorString = tr("Files that are opened in large file mode cannot be saved.");
+        return false;
+    }
+
     QTextCursor cursor(&d->m_document);
 
     // When autosaving, we don't want to modify the document/location under the user's fingers.
@@ -734,6 +748,14 @@ Core::IDocument::OpenResult TextDocument::openImpl(QString *errorString, const Q
 
     ReadResult readResult = Utils::TextFileFormat::ReadIOError;
 
+    const int largeFileLineOffset = reload ? d->m_largeFileLineOffset : 0;
+    d->m_largeFile.reset();
+    d->m_largeFileLineOffset = 0;
+    if (!fileName.isEmpty() && openLargeFile(fileName, realFileName, errorString)) {
+        setLargeFileLineOffset(largeFileLineOffset);
+        return OpenResult::Success;
+    }
+
     if (!fileName.isEmpty()) {
         const QFileInfo fi(fileName);
         readResult = read(realFileName, &content, errorString);
@@ -791,6 +813,102 @@ Core::IDocument::OpenResult TextDocument::openImpl(QString *errorString, const Q
     return OpenResult::Success;
 }
 
+static qint64 largeFileThreshold()
+{
+    // 0 disables the large file mode
+    const int thresholdInMB = TextEditorSettings::behaviorSettings().m_largeFileThresholdInMB;
+    return thresholdInMB > 0 ? qint64(thresholdInMB) << 20 : -1;
+}
+
+bool TextDocument::openLargeFile(const QString &fileName, const QString &realFileName,
+                                 QString *errorString)
+{
+    const qint64 threshold = largeFileThreshold();
+    if (threshold < 0 || QFileInfo(realFileName).size() <= threshold || !codec())
+        return false;
+
+    QScopedPointer<Internal::LargeFileIndex> largeFile(new Internal::LargeFileIndex);
+    if (!largeFile->open(realFileName, codec(), errorString))
+        return false;
+
+    // as read() does, a byte order mark overrides the default codec
+    const Utils::TextFileFormat &fileFormat = largeFile->format();
+    setCodec(fileFormat.codec);
+    setLineTerminationMode(fileFormat.lineTerminationMode);
+    if (format().hasUtf8Bom != fileFormat.hasUtf8Bom)
+        switchUtf8Bom();
+
+    QString text;
+    largeFile->lines(0, largeFileWindowLineCount(), &text);
+    d->m_largeFile.reset(largeFile.take());
+    connect(d->m_largeFile.data(), &Internal::LargeFileIndex::indexingFinished,
+            this, &TextDocument::largeFileIndexed);
+    d->m_document.setUndoRedoEnabled(false);
+    d->m_document.setPlainText(text);
+    d->m_document.setUndoRedoEnabled(true);
+
+    auto documentLayout = qobject_cast<TextDocumentLayout*>(d->m_document.documentLayout());
+    QTC_ASSERT(documentLayout, return false);
+    documentLayout->lastSaveRevision = d->m_autoSaveRevision = d->m_document.revision();
+    d->updateRevisions();
+    d->m_document.setModified(false);
+    setFilePath(Utils::FilePath::fromUserInput(QFileInfo(fileName).absoluteFilePath()));
+    return true;
+}
+
+bool TextDocument::isLargeFile() const
+{
+    return !d->m_largeFile.isNull();
+}
+
+/*!
+    Returns the number of lines of a large file in front of the first block of the document.
+*/
+int TextDocument::largeFileLineOffset() const
+{
+    return d->m_largeFileLineOffset;
+}
+
+/*!
+    Returns the number of lines of a large file, or -1 while the file is still being indexed.
+*/
+int TextDocument::largeFileLineCount() const
+{
+    return d->m_largeFile ? d->m_largeFile->lineCount() : -1;
+}
+
+/*!
+    Replaces the content of the document with the lines of a large file starting at
+    the zero based \a line. The document gets largeFileWindowLineCount() lines, or fewer
+    if they would take more than 8 MB.
+*/
+void TextDocument::setLargeFileLineOffset(int line)
+{
+    QTC_ASSERT(isLargeFile(), return);
+
+    const int lineCount = d->m_largeFile->lineCount();
+    if (lineCount >= 0)
+        line = qMin(line, lineCount - 1);
+    line = qMax(0, line);
+    if (line == d->m_largeFileLineOffset)
+        return;
+
+    QString text;
+    if (!d->m_largeFile->lines(line, largeFileWindowLineCount(), &text))
+        return; // behind the lines of a file that are indexed so far
+
+    d->m_largeFileLineOffset = line;
+    d->m_document.setUndoRedoEnabled(false);
+    d->m_document.setPlainText(text);
+    d->m_document.setUndoRedoEnabled(true);
+    d->m_document.setModified(false);
+}
+
+int TextDocument::largeFileWindowLineCount()
+{
+    return 20000;
+}
+
 bool TextDocument::reload(QString *errorString, QTextCodec *codec)
 {
     QTC_ASSERT(codec, return false);
@@ -969,7 +1087,8 @@ TextMarks TextDocument::marks() const
 
 bool TextDocument::addMark(TextMark *mark)
 {
-    if (mark->baseTextDocument())
+    // the blocks of large files are replaced when other lines are shown
+    if (mark->baseTextDocument() || isLargeFile())
         return false;
     QTC_ASSERT(mark->lineNumber() >= 1, return false);
     int blockNumber = mark->lineNumber() - 1;
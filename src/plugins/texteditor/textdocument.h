@@ -134,6 +134,15 @@ public:
 
     bool setPlainText(const QString &text);
     QTextDocument *document() const;
+
+    // Files above the large file threshold are not loaded completely, the document only
+    // contains a window of their lines that is read from the file.
+    bool isLargeFile() const;
+    int largeFileLineOffset() const;
+    int largeFileLineCount() const;
+    void setLargeFileLineOffset(int line);
+    static int largeFileWindowLineCount();
+
     void setSyntaxHighlighter(SyntaxHighlighter *highlighter);
     SyntaxHighlighter *syntaxHighlighter() const;
 
@@ -162,6 +171,7 @@ signals:
     void tabSettingsChanged();
     void fontSettingsChanged();
     void markRemoved(TextMark *mark);
+    void largeFileIndexed();
 
 protected:
     virtual void applyFontSettings();
@@ -169,6 +179,7 @@ protected:
 private:
     OpenResult openImpl(QString *errorString, const QString &fileName, const QString &realFileName,
                         bool reload);
+    bool openLargeFile(const QString &fileName, const QString &realFileName, QString *errorString);
     void cleanWhitespace(QTextCursor &cursor, bool inEntireDocument, bool cleanIndentation);
     void ensureFinalNewLine(QTextCursor &cursor);
     void modificationChanged(bool modified);
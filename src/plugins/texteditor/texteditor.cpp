@@ -191,7 +191,7 @@ private:
     {
         const QTextCursor cursor = m_editor->textCursor();
         const QTextBlock block = cursor.block();
-        const int line = block.blockNumber() + 1;
+        const int line = block.blockNumber() + 1 + m_editor->textDocument()->largeFileLineOffset();
         const int column = cursor.position() - block.position();
         setText(
             TextEditorWidget::tr("Line: %1, Col: %2")
@@ -493,6 +493,9 @@ public:
     void duplicateSelection(bool comment);
     void duplicateBlockSelection(bool comment);
     void updateCannotDecodeInfo();
+    void updateLargeFileInfo();
+    void updateLargeFileWindow();
+    int materializeLargeFileLine(int line);
     void collectToCircularClipboard();
 
     void ctor(const QSharedPointer<TextDocument> &doc);
@@ -735,6 +738,7 @@ public:
     QBasicTimer m_cursorFlashTimer;
     bool m_cursorVisible = true;
     bool m_moveLineUndoHack = false;
+    bool m_inLargeFileWindowUpdate = false;
 
     QTextCursor m_findScopeStart;
     QTextCursor m_findScopeEnd;
@@ -1072,6 +1076,14 @@ void TextEditorWidgetPrivate::ctor(const QSharedPointer<TextDocument> &doc)
     m_moveLineUndoHack = false;
 
     updateCannotDecodeInfo();
+    updateLargeFileInfo();
+    QObject::connect(q->verticalScrollBar(), &QAbstractSlider::valueChanged,
+                     this, &TextEditorWidgetPrivate::updateLargeFileWindow);
+    QObject::connect(m_document.data(), &TextDocument::largeFileIndexed, this, [this] {
+        // the end of the file is known now
+        slotUpdateExtraAreaWidth();
+        updateLargeFileWindow();
+    });
 
     QObject::connect(m_document.data(), &TextDocument::aboutToOpen,
                      q, &TextEditorWidget::aboutToOpen);
@@ -1396,9 +1408,84 @@ QString TextEditorWidget::selectedText() const
         return textCursor().selectedText();
 }
 
+void TextEditorWidgetPrivate::updateLargeFileInfo()
+{
+    updateCodeFoldingVisible();
+
+    InfoBar *infoBar = m_document->infoBar();
+    const Id largeFileModeId(Constants::LARGE_FILE_MODE);
+    if (!m_document->isLargeFile()) {
+        infoBar->removeInfo(largeFileModeId);
+        return;
+    }
+
+    q->setReadOnly(true);
+    // scrolling to the ends of the shown lines loads the next lines of the file
+    q->setLineWrapMode(QPlainTextEdit::NoWrap);
+    if (!infoBar->canInfoBeAdded(largeFileModeId))
+        return;
+    infoBar->addInfo(InfoBarEntry(largeFileModeId,
+        TextEditorWidget::tr("<b>Note:</b> \"%1\" is too large to be loaded completely. "
+                             "It is shown read-only and without folding.")
+            .arg(m_document->displayName())));
+}
+
+void TextEditorWidgetPrivate::updateLargeFileWindow()
+{
+    if (!m_document->isLargeFile() || m_inLargeFileWindowUpdate)
+        return;
+
+    const QScrollBar *scrollBar = q->verticalScrollBar();
+    const int offset = m_document->largeFileLineOffset();
+    const int blockCount = q->document()->blockCount();
+    const int lineCount = m_document->largeFileLineCount();
+    int newOffset = offset;
+    if (scrollBar->value() == scrollBar->maximum() && scrollBar->maximum() > 0
+            && (lineCount < 0 || offset + blockCount < lineCount)) {
+        newOffset = offset + blockCount / 2;
+    } else if (scrollBar->value() == scrollBar->minimum() && offset > 0) {
+        newOffset = offset - blockCount / 2;
+    } else {
+        return;
+    }
+
+    const int topLine = offset + q->firstVisibleBlockNumber();
+    const int cursorLine = offset + q->textCursor().blockNumber();
+    m_inLargeFileWindowUpdate = true;
+    m_document->setLargeFileLineOffset(newOffset);
+    const int actualOffset = m_document->largeFileLineOffset();
+    const QTextBlock cursorBlock = q->document()->findBlockByNumber(
+                qBound(0, cursorLine - actualOffset, q->document()->blockCount() - 1));
+    q->setTextCursor(QTextCursor(cursorBlock));
+    q->verticalScrollBar()->setValue(topLine - actualOffset);
+    m_inLargeFileWindowUpdate = false;
+}
+
+// Makes sure the line of a large file is part of the document and returns its line
+// number in the document.
+int TextEditorWidgetPrivate::materializeLargeFileLine(int line)
+{
+    if (!m_document->isLargeFile())
+        return line;
+
+    const auto isInWindow = [this, line] {
+        const int offset = m_document->largeFileLineOffset();
+        return line > offset && line <= offset + q->document()->blockCount();
+    };
+    if (!isInWindow()) {
+        m_inLargeFileWindowUpdate = true;
+        m_document->setLargeFileLineOffset(line - 1 - TextDocument::largeFileWindowLineCount() / 2);
+        // the window ends early if its lines are long
+        if (!isInWindow())
+            m_document->setLargeFileLineOffset(line - 1);
+        m_inLargeFileWindowUpdate = false;
+    }
+    return line - m_document->largeFileLineOffset();
+}
+
 void TextEditorWidgetPrivate::updateCannotDecodeInfo()
 {
-    q->setReadOnly(m_document->hasDecodingError());
+    q->setReadOnly(m_document->hasDecodingError() || m_document->isLargeFile());
     InfoBar *infoBar = m_document->infoBar();
     Id selectEncodingId(Constants::SELECT_ENCODING);
     if (m_document->hasDecodingError()) {
@@ -1473,6 +1560,7 @@ void TextEditorWidget::openFinishedSuccessfully()
 {
     moveCursor(QTextCursor::Start);
     d->updateCannotDecodeInfo();
+    d->updateLargeFileInfo();
     updateTextCodecLabel();
     updateVisualWrapColumn();
 }
@@ -2783,6 +2871,7 @@ void TextEditorWidget::doSetTextCursor(const QTextCursor &cursor)
 void TextEditorWidget::gotoLine(int line, int column, bool centerLine, bool animate)
 {
     d->m_lastCursorChangeWasInteresting = false; // avoid adding the previous position to history
+    line = d->materializeLargeFileLine(line);
     const int blockNumber = qMin(line, document()->blockCount()) - 1;
     const QTextBlock &block = document()->findBlockByNumber(blockNumber);
     if (block.isValid()) {
@@ -2977,6 +3066,7 @@ void TextEditorWidgetPrivate::documentReloadFinished(bool success)
     // restore cursor position
     q->restoreState(m_tempState);
     updateCannotDecodeInfo();
+    updateLargeFileInfo();
 }
 
 QByteArray TextEditorWidget::saveState() const
@@ -2984,11 +3074,13 @@ QByteArray TextEditorWidget::saveState() const
     QByteArray state;
     QDataStream stream(&state, QIODevice::WriteOnly);
     stream << 2; // version number
-    stream << verticalScrollBar()->value();
+    // lines of large files are stored as lines of the file, not of the document
+    const int largeFileLineOffset = textDocument()->largeFileLineOffset();
+    stream << verticalScrollBar()->value() + largeFileLineOffset;
     stream << horizontalScrollBar()->value();
     int line, column;
     convertPosition(textCursor().position(), &line, &column);
-    stream << line;
+    stream << line + largeFileLineOffset;
     stream << column;
 
     // store code folding state
@@ -3003,8 +3095,8 @@ QByteArray TextEditorWidget::saveState() const
     }
     stream << foldedBlocks;
 
-    stream << firstVisibleBlockNumber();
-    stream << lastVisibleBlockNumber();
+    stream << firstVisibleBlockNumber() + largeFileLineOffset;
+    stream << lastVisibleBlockNumber() + largeFileLineOffset;
 
     return state;
 }
@@ -3054,7 +3146,8 @@ void TextEditorWidget::restoreState(const QByteArray &state)
     d->m_lastCursorChangeWasInteresting = false; // avoid adding last position to history
     // line is 1-based, column is 0-based
     gotoLine(lineVal, columnVal - 1);
-    verticalScrollBar()->setValue(vval);
+    const int largeFileLineOffset = textDocument()->largeFileLineOffset();
+    verticalScrollBar()->setValue(vval - largeFileLineOffset);
     horizontalScrollBar()->setValue(hval);
 
     if (version >= 2) {
@@ -3066,8 +3159,8 @@ void TextEditorWidget::restoreState(const QByteArray &state)
         const int lineBlock = lineVal - 1; // line is 1-based, blocks are 0-based
         const bool originalCursorVisible = (originalFirstBlock <= lineBlock
                                             && lineBlock <= originalLastBlock);
-        const int firstBlock = firstVisibleBlockNumber();
-        const int lastBlock = lastVisibleBlockNumber();
+        const int firstBlock = firstVisibleBlockNumber() + largeFileLineOffset;
+        const int lastBlock = lastVisibleBlockNumber() + largeFileLineOffset;
         const bool cursorVisible = (firstBlock <= lineBlock && lineBlock <= lastBlock);
         if (originalCursorVisible && !cursorVisible)
             centerCursor();
@@ -3151,7 +3244,8 @@ bool TextEditorWidget::lineSeparatorsAllowed() const
 
 void TextEditorWidgetPrivate::updateCodeFoldingVisible()
 {
-    const bool visible = m_codeFoldingSupported && m_displaySettings.m_displayFoldingMarkers;
+    const bool visible = m_codeFoldingSupported && m_displaySettings.m_displayFoldingMarkers
+                         && !(m_document && m_document->isLargeFile());
     if (m_codeFoldingVisible != visible) {
         m_codeFoldingVisible = visible;
         slotUpdateExtraAreaWidth();
@@ -5336,6 +5430,12 @@ void TextEditorWidgetPrivate::slotUpdateRequest(const QRect &r, int dy)
 
     if (r.contains(q->viewport()->rect()))
         slotUpdateExtraAreaWidth();
+
+    // let a running rehighlight do the visible blocks first
+    if (dy || r.contains(q->viewport()->rect())) {
+        if (SyntaxHighlighter *highlighter = m_document->syntaxHighlighter())
+            highlighter->prioritizeBlocks(q->firstVisibleBlockNumber(), q->lastVisibleBlockNumber());
+    }
 }
 
 void TextEditorWidgetPrivate::saveCurrentCursorPositionForNavigation()
@@ -7417,7 +7517,7 @@ void TextEditorWidget::setDisplaySettings(const DisplaySettings &ds)
 
     if (d->m_displaySettings.m_visualizeWhitespace != ds.m_visualizeWhitespace) {
         if (SyntaxHighlighter *highlighter = textDocument()->syntaxHighlighter())
-            highlighter->rehighlight();
+            highlighter->rehighlightInBackground();
         QTextOption option =  document()->defaultTextOption();
         if (ds.m_visualizeWhitespace)
             option.setFlags(option.flags() | QTextOption::ShowTabsAndSpaces);
@@ -7864,13 +7964,16 @@ QMimeData *TextEditorWidget::duplicateMimeData(const QMimeData *source)
 
 QString TextEditorWidget::lineNumber(int blockNumber) const
 {
-    return QString::number(blockNumber + 1);
+    return QString::number(blockNumber + 1 + d->m_document->largeFileLineOffset());
 }
 
 int TextEditorWidget::lineNumberDigits() const
 {
     int digits = 2;
-    int max = qMax(1, blockCount());
+    const int largeFileLineCount = d->m_document->largeFileLineCount();
+    int max = largeFileLineCount >= 0
+            ? largeFileLineCount
+            : qMax(1, blockCount() + d->m_document->largeFileLineOffset());
     while (max >= 100) {
         max /= 10;
         ++digits;
@@ -8011,7 +8114,8 @@ void TextEditorWidget::setAutoCompleteSkipPosition(const QTextCursor &cursor)
 
 int BaseTextEditor::currentLine() const
 {
-    return editorWidget()->textCursor().blockNumber() + 1;
+    return editorWidget()->textCursor().blockNumber() + 1
+           + editorWidget()->textDocument()->largeFileLineOffset();
 }
 
 int BaseTextEditor::currentColumn() const
@@ -29,6 +29,7 @@ SOURCES += texteditorplugin.cpp \
     displaysettings.cpp \
     displaysettingspage.cpp \
     fontsettings.cpp \
+    largefileindex.cpp \
     linenumberfilter.cpp \
     findinfiles.cpp \
     basefilefind.cpp \
@@ -114,6 +115,7 @@ HEADERS += texteditorplugin.h \
     displaysettings.h \
     displaysettingspage.h \
     fontsettings.h \
+    largefileindex.h \
     linenumberfilter.h \
     texteditor_global.h \
     findinfiles.h \
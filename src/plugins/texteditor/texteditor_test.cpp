@@ -32,7 +32,13 @@
 
 #include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/coreconstants.h>
+#include <utils/filesearch.h>
+#include <utils/temporarydirectory.h>
+#include <utils/trigramindex.h>
 
+#include <QTextCodec>
+
+#include "syntaxhighlighter.h"
 #include "texteditor.h"
 #include "texteditorplugin.h"
 #include "textdocument.h"
@@ -629,4 +635,395 @@ void Internal::TextEditorPlugin::testIndentationClean()
     QCOMPARE(settings.isIndentationClean(block, indentSize), clean);
 }
 
+namespace {
+
+Utils::FileSearchResultList searchFile(const QString &filePath, QTextCodec *codec,
+                                       const QString &term, QTextDocument::FindFlags flags,
+                                       const QMap<QString, QString> &openDocuments)
+{
+    QFuture<Utils::FileSearchResultList> future
+            = Utils::findInFiles(term, new Utils::FileListIterator({filePath}, {codec}), flags,
+                                 openDocuments);
+    future.waitForFinished();
+    Utils::FileSearchResultList results;
+    for (const Utils::FileSearchResultList &partialResults : future.results())
+        results << partialResults;
+    return results;
+}
+
+} // anonymous namespace
+
+// Files in UTF-8 and Latin-1 are searched without decoding them, while open documents are
+// searched in their decoded contents. Both must give the same results.
+void Internal::TextEditorPlugin::testFileSearch_data()
+{
+    QTest::addColumn<QByteArray>("codecName");
+    QTest::addColumn<QString>("content");
+    QTest::addColumn<QString>("term");
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<int>("expectedCount");
+
+    const QString text = QString::fromUtf8(
+                "int main()\n"
+                "{\n"
+                "    const char *s = \"Gr\xc3\xb6\xc3\x9f" "e \xe2\x82\xac Main mainly\";\n"
+                "    return MAIN + main_value;\r\n"
+                "}\n"
+                "// main at the end without newline: main");
+    const int caseSensitively = int(QTextDocument::FindCaseSensitively);
+    const int wholeWords = int(QTextDocument::FindWholeWords);
+
+    QTest::newRow("utf8") << QByteArray("UTF-8") << text << "main" << caseSensitively << 5;
+    QTest::newRow("utf8 ignoring case") << QByteArray("UTF-8") << text << "main" << 0 << 7;
+    QTest::newRow("utf8 whole words") << QByteArray("UTF-8") << text << "main" << wholeWords
+                                      << 5;
+    QTest::newRow("utf8 non-ascii") << QByteArray("UTF-8") << text
+                                    << QString::fromUtf8("\xe2\x82\xac Main") << 0 << 1;
+    QTest::newRow("utf8 non-ascii ignoring case")
+            << QByteArray("UTF-8") << text << QString::fromUtf8("GR\xc3\x96\xc3\x9f" "E") << 0
+            << 1;
+    QTest::newRow("utf8 no match") << QByteArray("UTF-8") << text << "mainframe" << 0 << 0;
+
+    const QString latin1Text = QString::fromUtf8(
+                "Gr\xc3\xb6\xc3\x9f" "e\n"
+                "gr\xc3\xb6\xc3\x9f" "e and GROESSE\r\n"
+                "\xc3\xa4\xc3\xb6\xc3\xbc Gr\xc3\xb6\xc3\x9f" "e");
+    QTest::newRow("latin1") << QByteArray("ISO-8859-1") << latin1Text
+                            << QString::fromUtf8("Gr\xc3\xb6\xc3\x9f" "e") << caseSensitively
+                            << 2;
+    QTest::newRow("latin1 ignoring case") << QByteArray("ISO-8859-1") << latin1Text
+                                          << "gr" << 0 << 4;
+}
+
+void Internal::TextEditorPlugin::testFileSearch()
+{
+    QFETCH(QByteArray, codecName);
+    QFETCH(QString, content);
+    QFETCH(QString, term);
+    QFETCH(int, flags);
+    QFETCH(int, expectedCount);
+
+    QTextCodec *codec = QTextCodec::codecForName(codecName);
+    QVERIFY(codec);
+
+    Utils::TemporaryDirectory directory("filesearch");
+    const QString filePath = directory.filePath("file.txt");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(codec->fromUnicode(content));
+    file.close();
+
+    const auto findFlags = QTextDocument::FindFlags(flags);
+    const Utils::FileSearchResultList fromFile = searchFile(filePath, codec, term, findFlags, {});
+    const Utils::FileSearchResultList fromDocument
+            = searchFile(filePath, codec, term, findFlags, {{filePath, content}});
+
+    QCOMPARE(fromFile.size(), expectedCount);
+    QCOMPARE(fromDocument.size(), expectedCount);
+    for (int i = 0; i < expectedCount; ++i) {
+        QCOMPARE(fromFile.at(i).lineNumber, fromDocument.at(i).lineNumber);
+        QCOMPARE(fromFile.at(i).matchingLine, fromDocument.at(i).matchingLine);
+        QCOMPARE(fromFile.at(i).matchStart, fromDocument.at(i).matchStart);
+        QCOMPARE(fromFile.at(i).matchLength, fromDocument.at(i).matchLength);
+    }
+}
+
+void Internal::TextEditorPlugin::testFileSearchBenchmark_data()
+{
+    QTest::addColumn<QByteArray>("codecName");
+
+    // Only UTF-8 and Latin-1 files are searched in their bytes. The files are plain ASCII, so
+    // they are the same in Latin-9, which goes through decoding the whole file.
+    QTest::newRow("bytes") << QByteArray("UTF-8");
+    QTest::newRow("decoded") << QByteArray("ISO-8859-15");
+}
+
+// Searches a synthetic corpus of 32 MB on disk.
+void Internal::TextEditorPlugin::testFileSearchBenchmark()
+{
+    QFETCH(QByteArray, codecName);
+
+    QTextCodec *codec = QTextCodec::codecForName(codecName);
+    QVERIFY(codec);
+
+    const int fileCount = 32;
+    const int fileSize = 1024 * 1024;
+    const QByteArray line = "    const int someValue = computeSomething(argument, otherArgument);\n";
+    QByteArray content;
+    content.reserve(fileSize);
+    for (int lineNumber = 0; content.size() < fileSize; ++lineNumber)
+        content += lineNumber % 1000 == 0 ? QByteArray("    return needleInTheHaystack;\n") : line;
+
+    Utils::TemporaryDirectory directory("filesearchbenchmark");
+    QStringList filePaths;
+    for (int i = 0; i < fileCount; ++i) {
+        const QString filePath = directory.filePath(QString("file%1.cpp").arg(i));
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        filePaths << filePath;
+    }
+    const QList<QTextCodec *> encodings = QVector<QTextCodec *>(fileCount, codec).toList();
+
+    QBENCHMARK {
+        QFuture<Utils::FileSearchResultList> future = Utils::findInFiles(
+                    "needleinthehaystack",
+                    new Utils::FileListIterator(filePaths, encodings), {}, {});
+        future.waitForFinished();
+    }
+}
+
+namespace {
+
+QStringList sortedTrigrams(const QVector<quint64> &trigrams)
+{
+    QStringList result;
+    for (quint64 trigram : trigrams) {
+        result << QString(QChar(ushort(trigram >> 32))) + QChar(ushort(trigram >> 16))
+                  + QChar(ushort(trigram));
+    }
+    result.sort();
+    return result;
+}
+
+bool writeFile(const QString &filePath, const QByteArray &content)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+} // anonymous namespace
+
+void Internal::TextEditorPlugin::testTrigramIndexRequiredTrigrams_data()
+{
+    QTest::addColumn<QString>("term");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("word") << "main" << QStringList({"ain", "mai"});
+    QTest::newRow("too short") << "ab" << QStringList();
+    QTest::newRow("case folded") << "MaIn" << QStringList({"ain", "mai"});
+    QTest::newRow("duplicates") << "aaaaa" << QStringList({"aaa"});
+    QTest::newRow("punctuation") << "a->b" << QStringList({"->b", "a->"});
+    QTest::newRow("non-ascii") << QString::fromUtf8("abc\xc3\xb6" "def")
+                               << QStringList({"abc", "def"});
+    QTest::newRow("newline") << "ab\ncd" << QStringList();
+}
+
+void Internal::TextEditorPlugin::testTrigramIndexRequiredTrigrams()
+{
+    QFETCH(QString, term);
+    QFETCH(QStringList, expected);
+
+    QCOMPARE(sortedTrigrams(Utils::TrigramIndex::requiredTrigrams(term, false)), expected);
+}
+
+// Only the trigrams every match must contain are required, so anything which could match
+// arbitrary characters ends a literal run or gives no trigrams at all.
+void Internal::TextEditorPlugin::testTrigramIndexRegExpTrigrams_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("literal") << "main" << QStringList({"ain", "mai"});
+    QTest::newRow("alternation") << "main|exit" << QStringList();
+    QTest::newRow("optional") << "abcd?" << QStringList({"abc"});
+    QTest::newRow("star") << "abc*def" << QStringList({"def"});
+    QTest::newRow("plus") << "abc+def" << QStringList({"abc", "def"});
+    QTest::newRow("repetition") << "abcd{2}ef" << QStringList({"abc"});
+    QTest::newRow("any character") << "abc.def" << QStringList({"abc", "def"});
+    QTest::newRow("anchors") << "^abc$" << QStringList({"abc"});
+    QTest::newRow("character class") << "abc[x-z]def" << QStringList({"abc", "def"});
+    QTest::newRow("negated class with bracket") << "abc[^]x]def" << QStringList({"abc", "def"});
+    QTest::newRow("class escape") << "abc\\sdef" << QStringList({"abc", "def"});
+    QTest::newRow("other letter escape") << "abc\\x41def" << QStringList();
+    QTest::newRow("escaped punctuation") << "a\\.bc" << QStringList({".bc", "a.b"});
+    QTest::newRow("trailing backslash") << "abc\\" << QStringList();
+    QTest::newRow("group") << "(abc)def" << QStringList({"def"});
+    QTest::newRow("non-capturing group") << "(?:abc)def" << QStringList({"def"});
+    QTest::newRow("inline option") << "(?i)abcdef" << QStringList();
+}
+
+void Internal::TextEditorPlugin::testTrigramIndexRegExpTrigrams()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QStringList, expected);
+
+    QCOMPARE(sortedTrigrams(Utils::TrigramIndex::requiredTrigrams(pattern, true)), expected);
+}
+
+void Internal::TextEditorPlugin::testTrigramIndexCandidateFilter()
+{
+    Utils::TemporaryDirectory directory("trigramindex");
+    const QString withNeedle = directory.filePath("withneedle.cpp");
+    const QString withoutNeedle = directory.filePath("withoutneedle.cpp");
+    const QString notIndexed = directory.filePath("notindexed.cpp");
+    QVERIFY(writeFile(withNeedle, "int needleValue = 0;\n"));
+    QVERIFY(writeFile(withoutNeedle, "int otherValue = 0;\n"));
+    QVERIFY(writeFile(notIndexed, "int otherValue = 0;\n"));
+
+    Utils::TrigramIndex index;
+    QVERIFY(!index.isModified());
+    for (const QString &filePath : {withNeedle, withoutNeedle}) {
+        const Utils::TrigramIndex::FileStamp stamp = Utils::TrigramIndex::FileStamp::fromFile(
+                    filePath);
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        index.addFile(filePath, QString::fromUtf8(file.readAll()), stamp);
+    }
+    QCOMPARE(index.fileCount(), 2);
+    QVERIFY(index.isModified());
+
+    // Without a required trigram, there is nothing to filter with.
+    QVERIFY(!index.candidateFilter("ne", false));
+    QVERIFY(!index.candidateFilter("needle|other", true));
+
+    Utils::TrigramIndex::FileFilter filter = index.candidateFilter("NEEDLE", false);
+    QVERIFY(filter);
+    QVERIFY(filter(withNeedle));
+    QVERIFY(!filter(withoutNeedle));
+    QVERIFY(filter(notIndexed));
+
+    filter = index.candidateFilter("need.e\\w+", true);
+    QVERIFY(filter);
+    QVERIFY(filter(withNeedle));
+    QVERIFY(!filter(withoutNeedle));
+
+    // A saved and loaded index filters the same and is unmodified.
+    const QString indexFilePath = directory.filePath("findinfiles.index");
+    QVERIFY(index.save(indexFilePath));
+    QVERIFY(!index.isModified());
+    Utils::TrigramIndex loadedIndex;
+    QVERIFY(loadedIndex.load(indexFilePath));
+    QVERIFY(!loadedIndex.isModified());
+    filter = loadedIndex.candidateFilter("needle", false);
+    QVERIFY(filter);
+    QVERIFY(filter(withNeedle));
+    QVERIFY(!filter(withoutNeedle));
+
+    // A file which changed since it was indexed is searched.
+    filter = index.candidateFilter("needle", false);
+    QVERIFY(writeFile(withoutNeedle, "int needleValue = 1; // now with a needle\n"));
+    QVERIFY(filter(withoutNeedle));
+
+    index.removeFile(withNeedle);
+    QVERIFY(index.isModified());
+    QVERIFY(!index.isIndexed(withNeedle));
+    QVERIFY(filter(withNeedle));
+}
+
+namespace {
+
+// Highlights C comments, so the highlighting of a block depends on the state of the ones
+// in front of it.
+class CommentHighlighter : public SyntaxHighlighter
+{
+public:
+    CommentHighlighter()
+    {
+        m_commentFormat.setForeground(Qt::darkGreen);
+        m_keywordFormat.setFontWeight(QFont::Bold);
+    }
+
+protected:
+    void highlightBlock(const QString &text) override
+    {
+        bool inComment = previousBlockState() == 1;
+        int start = 0;
+        for (int i = 0; i < text.size(); ++i) {
+            if (!inComment && text.midRef(i, 2) == "/*") {
+                highlightKeywords(text, start, i);
+                start = i;
+                inComment = true;
+                ++i;
+            } else if (inComment && text.midRef(i, 2) == "*/") {
+                setFormat(start, i + 2 - start, m_commentFormat);
+                start = i + 2;
+                inComment = false;
+                ++i;
+            }
+        }
+        if (inComment)
+            setFormat(start, text.size() - start, m_commentFormat);
+        else
+            highlightKeywords(text, start, text.size());
+        setCurrentBlockState(inComment ? 1 : 0);
+    }
+
+private:
+    void highlightKeywords(const QString &text, int from, int to)
+    {
+        for (int i = text.indexOf("int", from); i >= 0 && i + 3 <= to; i = text.indexOf("int", i + 3))
+            setFormat(i, 3, m_keywordFormat);
+    }
+
+    QTextCharFormat m_commentFormat;
+    QTextCharFormat m_keywordFormat;
+};
+
+struct BlockHighlighting
+{
+    int state;
+    QVector<QTextLayout::FormatRange> formats;
+
+    bool operator==(const BlockHighlighting &other) const
+    {
+        return state == other.state && formats == other.formats;
+    }
+};
+
+QVector<BlockHighlighting> blockHighlightings(const QTextDocument &document)
+{
+    QVector<BlockHighlighting> highlightings;
+    for (QTextBlock block = document.begin(); block.isValid(); block = block.next())
+        highlightings.append({block.userState(), block.layout()->formats()});
+    return highlightings;
+}
+
+} // anonymous namespace
+
+void Internal::TextEditorPlugin::testBackgroundHighlighting_data()
+{
+    QTest::addColumn<int>("firstPriorityBlock");
+    QTest::addColumn<int>("lastPriorityBlock");
+
+    QTest::newRow("in order") << -1 << -1;
+    // the first visible blocks are inside a comment, so highlighting them early gets them wrong
+    QTest::newRow("visible blocks in the middle") << 49960 << 50010;
+    QTest::newRow("visible blocks at the end") << 99915 << 100000;
+}
+
+// Highlighting a document in time-sliced chunks must give the same formats and states as
+// highlighting it in one go, also if visible blocks are highlighted ahead of the others.
+void Internal::TextEditorPlugin::testBackgroundHighlighting()
+{
+    QFETCH(int, firstPriorityBlock);
+    QFETCH(int, lastPriorityBlock);
+
+    QString text;
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 97 == 0)
+            text += "int value; /* a comment\n";
+        else if (i % 97 == 13)
+            text += "   ends here */ int other; /* short */ int last;\n";
+        else
+            text += "    int someValue = computeSomething(argument);\n";
+    }
+
+    QTextDocument expectedDocument(text);
+    CommentHighlighter expectedHighlighter;
+    expectedHighlighter.setNoAutomaticHighlighting(true);
+    expectedHighlighter.setDocument(&expectedDocument);
+    expectedHighlighter.rehighlight();
+    const QVector<BlockHighlighting> expected = blockHighlightings(expectedDocument);
+
+    QTextDocument document(text);
+    CommentHighlighter highlighter;
+    highlighter.setNoAutomaticHighlighting(true);
+    highlighter.setDocument(&document);
+    highlighter.rehighlightInBackground();
+    highlighter.prioritizeBlocks(firstPriorityBlock, lastPriorityBlock);
+
+    QTRY_VERIFY_WITH_TIMEOUT(blockHighlightings(document) == expected, 60000);
+}
+
 #endif // ifdef WITH_TESTS
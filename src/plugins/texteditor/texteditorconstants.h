@@ -176,6 +176,7 @@ const char DELETE_START_OF_WORD[]  = "TextEditor.DeleteStartOfWord";
 const char DELETE_START_OF_LINE[]  = "TextEditor.DeleteStartOfLine";
 const char DELETE_START_OF_WORD_CAMEL_CASE[] = "TextEditor.DeleteStartOfWordCamelCase";
 const char SELECT_ENCODING[]       = "TextEditor.SelectEncoding";
+const char LARGE_FILE_MODE[]       = "TextEditor.LargeFileMode";
 const char REWRAP_PARAGRAPH[]      =  "TextEditor.RewrapParagraph";
 const char GOTO_DOCUMENT_START[]   = "TextEditor.GotoDocumentStart";
 const char GOTO_DOCUMENT_END[]     = "TextEditor.GotoDocumentEnd";
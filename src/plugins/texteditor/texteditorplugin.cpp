@@ -25,6 +25,7 @@
 
 #include "texteditorplugin.h"
 
+#include "basefilefind.h"
 #include "findincurrentfile.h"
 #include "findinfiles.h"
 #include "findinopenfiles.h"
@@ -54,6 +55,7 @@
 
 #include <QAction>
 #include <QDir>
+#include <QFutureWatcher>
 
 using namespace Core;
 using namespace Utils;
@@ -254,7 +256,16 @@ LineNumberFilter *TextEditorPlugin::lineNumberFilter()
 ExtensionSystem::IPlugin::ShutdownFlag TextEditorPlugin::aboutToShutdown()
 {
     Highlighter::handleShutdown();
-    return SynchronousShutdown;
+
+    const QFuture<void> saveFuture = saveSearchIndex();
+    if (saveFuture.isFinished())
+        return SynchronousShutdown;
+
+    auto watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished,
+            this, &ExtensionSystem::IPlugin::asynchronousShutdownFinished);
+    watcher->setFuture(saveFuture);
+    return AsynchronousShutdown;
 }
 
 void TextEditorPluginPrivate::updateSearchResultsFont(const FontSettings &settings)
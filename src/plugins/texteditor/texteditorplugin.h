@@ -68,6 +68,20 @@ private slots:
 
     void testIndentationClean_data();
     void testIndentationClean();
+
+    void testFileSearch_data();
+    void testFileSearch();
+    void testFileSearchBenchmark_data();
+    void testFileSearchBenchmark();
+
+    void testTrigramIndexRequiredTrigrams_data();
+    void testTrigramIndexRequiredTrigrams();
+    void testTrigramIndexRegExpTrigrams_data();
+    void testTrigramIndexRegExpTrigrams();
+    void testTrigramIndexCandidateFilter();
+
+    void testBackgroundHighlighting_data();
+    void testBackgroundHighlighting();
 #endif
 };
 
@@ -3,6 +3,7 @@ INCLUDEPATH += $$PWD
 HEADERS += \
     $$PWD/clangasyncjob.h \
     $$PWD/clangbackend_global.h \
+    $$PWD/clangbuildsharedpreamblejob.h \
     $$PWD/clangclock.h \
     $$PWD/clangcodecompleteresults.h \
     $$PWD/clangcodemodelserver.h \
@@ -23,12 +24,14 @@ HEADERS += \
     $$PWD/clangjobqueue.h \
     $$PWD/clangjobrequest.h \
     $$PWD/clangjobs.h \
+    $$PWD/clangjobscheduler.h \
     $$PWD/clangparsesupportivetranslationunitjob.h \
     $$PWD/clangreferencescollector.h \
     $$PWD/clangrequestannotationsjob.h \
     $$PWD/clangrequestreferencesjob.h \
     $$PWD/clangrequesttooltipjob.h \
     $$PWD/clangresumedocumentjob.h \
+    $$PWD/clangsharedpreambles.h \
     $$PWD/clangstring.h \
     $$PWD/clangsupportivetranslationunitinitializer.h \
     $$PWD/clangsuspenddocumentjob.h \
@@ -62,6 +65,7 @@ HEADERS += \
     $$PWD/utf8positionfromlinecolumn.h
 
 SOURCES += \
+    $$PWD/clangbuildsharedpreamblejob.cpp \
     $$PWD/clangcodecompleteresults.cpp \
     $$PWD/clangcodemodelserver.cpp \
     $$PWD/clangcompletecodejob.cpp \
@@ -80,6 +84,7 @@ SOURCES += \
     $$PWD/clangjobqueue.cpp \
     $$PWD/clangjobrequest.cpp \
     $$PWD/clangjobs.cpp \
+    $$PWD/clangjobscheduler.cpp \
     $$PWD/clangparsesupportivetranslationunitjob.cpp \
     $$PWD/clangresumedocumentjob.cpp \
     $$PWD/clangreferencescollector.cpp \
@@ -87,6 +92,7 @@ SOURCES += \
     $$PWD/clangrequestreferencesjob.cpp \
     $$PWD/clangrequesttooltipjob.cpp \
     $$PWD/clangsuspenddocumentjob.cpp  \
+    $$PWD/clangsharedpreambles.cpp \
     $$PWD/clangsupportivetranslationunitinitializer.cpp \
     $$PWD/clangtooltipinfocollector.cpp \
     $$PWD/clangtranslationunit.cpp \
@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "clangbuildsharedpreamblejob.h"
+
+#include "clangsharedpreambles.h"
+
+#include <clangsupport/clangsupportdebugutils.h>
+
+#include <utils/qtcassert.h>
+
+namespace ClangBackEnd {
+
+IAsyncJob::AsyncPrepareResult BuildSharedPreambleJob::prepareAsyncRun()
+{
+    const JobRequest jobRequest = context().jobRequest;
+    QTC_ASSERT(jobRequest.type == JobRequest::Type::BuildSharedPreamble,
+               return AsyncPrepareResult());
+    QTC_ASSERT(acquireDocument(), return AsyncPrepareResult());
+
+    const TranslationUnitUpdateInput updateInput = m_pinnedDocument.createUpdateInput();
+    setRunner([updateInput]() {
+        TIME_SCOPE_DURATION("BuildSharedPreambleJob");
+
+        return SharedPreambles::instance().build(updateInput.filePath,
+                                                 updateInput.compilationArguments,
+                                                 updateInput.unsavedFiles);
+    });
+
+    // The job does not touch the document's translation units, so do not block them while
+    // the PCH is built.
+    return AsyncPrepareResult{Utf8StringLiteral("SharedPreamble:") + updateInput.filePath};
+}
+
+void BuildSharedPreambleJob::finalizeAsyncRun()
+{
+    // Translation units created from now on pick up the PCH.
+}
+
+} // namespace ClangBackEnd
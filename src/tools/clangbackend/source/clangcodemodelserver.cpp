@@ -28,6 +28,7 @@
 #include "clangdocuments.h"
 #include "clangdocumentsuspenderresumer.h"
 #include "clangfilesystemwatcher.h"
+#include "clangjobscheduler.h"
 #include "clangupdateannotationsjob.h"
 #include "codecompleter.h"
 #include "diagnosticset.h"
@@ -37,6 +38,7 @@
 #include "unsavedfile.h"
 
 #include <clangsupport/clangsupportdebugutils.h>
+#include <clangsupport/clangcodemodelclientmessages.h>
 #include <clangsupport/clangcodemodelservermessages.h>
 
 #include <utils/algorithm.h>
@@ -48,6 +50,9 @@
 #include <QLoggingCategory>
 #include <QDir>
 
+#include <algorithm>
+#include <cstring>
+
 static Q_LOGGING_CATEGORY(serverLog, "qtc.clangbackend.server", QtWarningMsg);
 
 static bool useSupportiveTranslationUnit()
@@ -75,6 +80,24 @@ ClangCodeModelServer::ClangCodeModelServer()
         addAndRunUpdateJobs(documents.dirtyAndVisibleButNotCurrentDocuments());
     });
 
+    processDeferredJobsTimer.setSingleShot(true);
+    QObject::connect(&processDeferredJobsTimer,
+                     &QTimer::timeout,
+                     [this]() {
+        processDeferredJobs();
+    });
+
+    memoryBudgetTimer.setSingleShot(true);
+    QObject::connect(&memoryBudgetTimer,
+                     &QTimer::timeout,
+                     [this]() {
+        processSuspendResumeJobs(documents.documents());
+    });
+
+    JobScheduler::instance().setDeferredJobsHandler([this]() {
+        processDeferredJobsTimer.start(0);
+    });
+
     QObject::connect(documents.clangFileSystemWatcher(),
                      &ClangFileSystemWatcher::fileChanged,
                      [this](const Utf8String &filePath) {
@@ -83,6 +106,11 @@ ClangCodeModelServer::ClangCodeModelServer()
     });
 }
 
+ClangCodeModelServer::~ClangCodeModelServer()
+{
+    JobScheduler::instance().setDeferredJobsHandler(JobScheduler::DeferredJobsHandler());
+}
+
 void ClangCodeModelServer::end()
 {
     QCoreApplication::exit();
@@ -125,23 +153,105 @@ void ClangCodeModelServer::documentsChanged(const DocumentsChangedMessage &messa
     TIME_SCOPE_DURATION("ClangCodeModelServer::documentsChanged");
 
     try {
-        const auto newerFileContainers = documents.newerFileContainers(message.fileContainers);
-        if (newerFileContainers.size() > 0) {
-            std::vector<Document> updateDocuments = documents.update(newerFileContainers);
-            unsavedFiles.createOrUpdate(newerFileContainers);
-
-            for (Document &document : updateDocuments) {
-                if (!document.isResponsivenessIncreased())
-                    document.setResponsivenessIncreaseNeeded(true);
-            }
+        updateDocuments(message.fileContainers);
+    } catch (const std::exception &exception) {
+        qWarning() << "Error in ClangCodeModelServer::documentsChanged:" << exception.what();
+    }
+}
 
-            // Start the jobs on the next event loop iteration since otherwise
-            // we might block the translation unit for a completion request
-            // that comes right after this message.
-            updateAnnotationsTimer.start(0);
+// Lines and columns are 1-based, columns count UTF-8 bytes. The column right after
+// the last character of a line is valid, too.
+static bool toUtf8Offset(const Utf8String &text, quint32 line, quint32 column, int &offset)
+{
+    if (line == 0 || column == 0)
+        return false;
+
+    const char *data = text.constData();
+    const int size = text.byteSize();
+
+    int lineStart = 0;
+    for (quint32 currentLine = 1; currentLine < line; ++currentLine) {
+        const void *newLine = std::memchr(data + lineStart, '\n', size_t(size - lineStart));
+        if (!newLine)
+            return false;
+        lineStart = int(static_cast<const char *>(newLine) - data) + 1;
+    }
+
+    const void *newLine = std::memchr(data + lineStart, '\n', size_t(size - lineStart));
+    const int lineEnd = newLine ? int(static_cast<const char *>(newLine) - data) : size;
+    if (column - 1 > quint32(lineEnd - lineStart))
+        return false;
+
+    offset = lineStart + int(column - 1);
+    return true;
+}
+
+static bool applyTextChanges(Utf8String &text, const QVector<TextChangeContainer> &textChanges)
+{
+    for (const TextChangeContainer &textChange : textChanges) {
+        int start = 0;
+        int end = 0;
+        if (!toUtf8Offset(text, textChange.startLine, textChange.startColumn, start)
+                || !toUtf8Offset(text, textChange.endLine, textChange.endColumn, end)
+                || end < start) {
+            return false;
         }
+
+        text.replace(start, end - start, textChange.text);
+    }
+
+    return true;
+}
+
+void ClangCodeModelServer::documentTextChanged(const DocumentTextChangedMessage &message)
+{
+    qCDebug(serverLog) << "########## documentTextChanged";
+    TIME_SCOPE_DURATION("ClangCodeModelServer::documentTextChanged");
+
+    try {
+        FileContainer fileContainer = message.fileContainer;
+        const Utf8String &filePath = fileContainer.filePath;
+
+        // The changes are relative to the unsaved content of the base revision, so
+        // anything else would silently corrupt the content. Ask for the full content.
+        const UnsavedFile &unsavedFile = unsavedFiles.unsavedFile(filePath);
+        Utf8String content = unsavedFile.fileContent();
+        const bool isInSync = documents.hasDocument(filePath)
+                && documents.document(filePath).documentRevision() == message.baseDocumentRevision
+                && unsavedFile.filePath() == filePath
+                && applyTextChanges(content, message.textChanges);
+
+        if (!isInSync) {
+            qCDebug(serverLog) << "Document out of sync:" << filePath;
+            if (client())
+                client()->documentOutOfSync({filePath, fileContainer.documentRevision});
+            return;
+        }
+
+        fileContainer.unsavedFileContent = content;
+        fileContainer.hasUnsavedFileContent = true;
+        updateDocuments({fileContainer});
     } catch (const std::exception &exception) {
-        qWarning() << "Error in ClangCodeModelServer::documentsChanged:" << exception.what();
+        qWarning() << "Error in ClangCodeModelServer::documentTextChanged:" << exception.what();
+    }
+}
+
+void ClangCodeModelServer::updateDocuments(const QVector<FileContainer> &fileContainers)
+{
+    const auto newerFileContainers = documents.newerFileContainers(fileContainers);
+    if (newerFileContainers.size() > 0) {
+        std::vector<Document> updateDocuments = documents.update(newerFileContainers);
+        unsavedFiles.createOrUpdate(newerFileContainers);
+
+        for (Document &document : updateDocuments) {
+            if (!document.isResponsivenessIncreased())
+                document.setResponsivenessIncreaseNeeded(true);
+        }
+
+        // Start the jobs on the next event loop iteration since otherwise
+        // we might block the translation unit for a completion request
+        // that comes right after this message.
+        updateAnnotationsTimer.start(0);
     }
 }
 
@@ -401,10 +511,34 @@ void ClangCodeModelServer::processSuspendResumeJobs(const std::vector<Document>
     }
 }
 
+void ClangCodeModelServer::processDeferredJobs()
+{
+    // Give the current editor the first chance for the freed workers.
+    QList<DocumentProcessor> processors = documentProcessors().processors();
+    std::stable_partition(processors.begin(), processors.end(),
+                          [](const DocumentProcessor &processor) {
+        return processor.document().isUsedByCurrentEditor();
+    });
+
+    for (DocumentProcessor &processor : processors)
+        processor.process();
+}
+
 bool ClangCodeModelServer::onJobFinished(const Jobs::RunningJob &jobRecord, IAsyncJob *job)
 {
     if (jobRecord.jobRequest.type == JobRequest::Type::UpdateAnnotations) {
+        // A (re)parse changes the memory usage, so check whether documents need to be
+        // suspended to stay within the budget.
+        if (memoryBudgetInBytes() > 0 && !memoryBudgetTimer.isActive())
+            memoryBudgetTimer.start(memoryBudgetTimeOutInMs);
+
         const auto updateJob = static_cast<UpdateAnnotationsJob *>(job);
+        if (!updateJob->context().isOutdated()
+                && updateJob->asyncResult().updateResult.isSharedPreambleBuildNeeded) {
+            documentProcessors().processor(updateJob->pinnedDocument())
+                    .addJob(JobRequest::Type::BuildSharedPreamble);
+        }
+
         return resetDocumentsWithUnresolvedIncludes({updateJob->pinnedDocument()});
     }
 
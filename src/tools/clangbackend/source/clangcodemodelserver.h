@@ -51,11 +51,13 @@ class ClangCodeModelServer : public ClangCodeModelServerInterface,
 {
 public:
     ClangCodeModelServer();
+    ~ClangCodeModelServer() override;
 
     void end() override;
 
     void documentsOpened(const DocumentsOpenedMessage &message) override;
     void documentsChanged(const DocumentsChangedMessage &message) override;
+    void documentTextChanged(const DocumentTextChangedMessage &message) override;
     void documentsClosed(const DocumentsClosedMessage &message) override;
     void documentVisibilityChanged(const DocumentVisibilityChangedMessage &message) override;
 
@@ -78,10 +80,12 @@ public: // for tests
     DocumentProcessors &documentProcessors();
 
 private:
+    void updateDocuments(const QVector<FileContainer> &fileContainers);
     void processJobsForVisibleDocuments();
     void processJobsForCurrentDocument();
     void processTimerForVisibleButNotCurrentDocuments();
     void processSuspendResumeJobs(const std::vector<Document> &documents);
+    void processDeferredJobs();
 
     bool onJobFinished(const Jobs::RunningJob &jobRecord, IAsyncJob *job);
 
@@ -104,6 +108,11 @@ private:
 
     QTimer updateVisibleButNotCurrentDocumentsTimer;
     int updateVisibleButNotCurrentDocumentsTimeOutInMs = 2000;
+
+    QTimer processDeferredJobsTimer;
+
+    QTimer memoryBudgetTimer;
+    int memoryBudgetTimeOutInMs = 500;
 };
 
 } // namespace ClangBackEnd
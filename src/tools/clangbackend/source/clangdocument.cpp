@@ -40,6 +40,7 @@
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QHash>
 #include <QLoggingCategory>
 
 #include <ostream>
@@ -66,6 +67,8 @@ public:
 
     QSet<Utf8String> dependedFilePaths;
     QSet<Utf8String> unresolvedFilePaths;
+    Utf8String sharedPreamblePath;
+    QHash<Utf8String, qint64> resourceUsages; // by translation unit id
 
     uint documentRevision = 0;
 
@@ -233,6 +236,19 @@ void Document::setIsSuspended(bool isSuspended)
     checkIfNull();
 
     d->isSuspended = isSuspended;
+    if (isSuspended)
+        d->resourceUsages.clear();
+}
+
+qint64 Document::resourceUsage() const
+{
+    checkIfNull();
+
+    qint64 usage = 0;
+    for (qint64 translationUnitUsage : d->resourceUsages)
+        usage += translationUnitUsage;
+
+    return usage;
 }
 
 bool Document::isUsedByCurrentEditor() const
@@ -299,6 +315,7 @@ TranslationUnitUpdateInput Document::createUpdateInput() const
     updateInput.needsToBeReparsedChangeTimePoint = d->isDirtyChangeTimePoint;
     updateInput.filePath = d->filePath;
     updateInput.compilationArguments = d->compilationArguments;
+    updateInput.sharedPreamblePath = d->sharedPreamblePath;
     updateInput.unsavedFiles = d->documents.unsavedFiles();
 
     return updateInput;
@@ -332,6 +349,8 @@ void Document::incorporateUpdaterResult(const TranslationUnitUpdateResult &resul
 
     if (result.hasParsed() || result.hasReparsed()) {
         d->dependedFilePaths = result.dependedOnFilePaths;
+        d->sharedPreamblePath = result.sharedPreamblePath;
+        d->resourceUsages.insert(result.translationUnitId, result.resourceUsageInBytes);
 
         const TimePoint timePoint = qMax(result.parseTimePoint, result.reparseTimePoint);
         d->translationUnits.updateParseTimePoint(result.translationUnitId, timePoint);
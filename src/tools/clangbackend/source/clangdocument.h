@@ -94,6 +94,9 @@ public:
     bool isSuspended() const;
     void setIsSuspended(bool isSuspended);
 
+    // Heap memory of the translation units as of their last (re)parse.
+    qint64 resourceUsage() const;
+
     bool isUsedByCurrentEditor() const;
     void setIsUsedByCurrentEditor(bool isUsedByCurrentEditor);
 
@@ -25,6 +25,7 @@
 
 #include "clangdocuments.h"
 
+#include <clangsharedpreambles.h>
 #include <diagnosticset.h>
 #include <tokenprocessor.h>
 #include <clangexceptions.h>
@@ -163,6 +164,8 @@ void Documents::addWatchedFiles(QSet<Utf8String> &filePaths)
 
 void Documents::updateDocumentsWithChangedDependency(const Utf8String &filePath)
 {
+    SharedPreambles::instance().invalidate(filePath);
+
     for (auto &document : documents_)
         document.setDirtyIfDependencyIsMet(filePath);
 }
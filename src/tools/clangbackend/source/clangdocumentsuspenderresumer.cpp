@@ -31,8 +31,14 @@
 
 #include <utils/algorithm.h>
 
+#include <QFile>
+
 #include <algorithm>
 
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
 namespace ClangBackEnd {
 
 constexpr int DefaultHotDocumentsSize = 7;
@@ -64,6 +70,75 @@ void categorizeHotColdDocuments(int hotDocumentsSize,
     }
 }
 
+// Documents are walked from the least recently used one and suspended until the memory
+// they free brings the usage below the budget. Visible documents are always hot.
+void categorizeHotColdDocumentsByMemory(qint64 memoryBudgetInBytes,
+                                        qint64 memoryUsageInBytes,
+                                        const std::vector<Document> &inDocuments,
+                                        std::vector<Document> &hotDocuments,
+                                        std::vector<Document> &coldDocuments)
+{
+    std::vector<Document> documents = inDocuments;
+    std::stable_sort(documents.begin(), documents.end(), [](const Document &a, const Document &b) {
+        return a.visibleTimePoint() > b.visibleTimePoint();
+    });
+
+    if (memoryUsageInBytes < 0) {
+        memoryUsageInBytes = 0;
+        for (const Document &document : documents)
+            memoryUsageInBytes += document.resourceUsage();
+    }
+
+    qint64 excessInBytes = memoryUsageInBytes - memoryBudgetInBytes;
+
+    hotDocuments.clear();
+    coldDocuments.clear();
+    for (auto it = documents.rbegin(); it != documents.rend(); ++it) {
+        const Document &document = *it;
+        if (document.isVisibleInEditor()) {
+            hotDocuments.push_back(document);
+        } else if (document.isSuspended()) {
+            coldDocuments.push_back(document);
+        } else if (excessInBytes > 0 && document.resourceUsage() > 0) {
+            excessInBytes -= document.resourceUsage();
+            coldDocuments.push_back(document);
+        } else {
+            hotDocuments.push_back(document);
+        }
+    }
+
+    std::reverse(hotDocuments.begin(), hotDocuments.end());
+    std::reverse(coldDocuments.begin(), coldDocuments.end());
+}
+
+qint64 memoryBudgetInBytes()
+{
+    static const qint64 budget = []() {
+        bool ok = false;
+        const int fromEnvironment = qEnvironmentVariableIntValue("QTC_CLANG_MEMORY_BUDGET_MB",
+                                                                 &ok);
+        return ok && fromEnvironment >= 1 ? qint64(fromEnvironment) * 1024 * 1024 : qint64(0);
+    }();
+
+    return budget;
+}
+
+// Returns -1 if the resident set size cannot be determined on this platform.
+static qint64 residentSetSize()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        bool ok = false;
+        const qint64 residentPages = fields.value(1).toLongLong(&ok);
+        if (ok)
+            return residentPages * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return -1;
+}
+
 static int hotDocumentsSize()
 {
     static int hotDocuments = -1;
@@ -115,8 +190,14 @@ SuspendResumeJobs createSuspendResumeJobs(const std::vector<Document> &documents
     std::vector<Document> hotDocuments;
     std::vector<Document> coldDocuments;
 
-    const int size = (customHotDocumentSize == -1) ? hotDocumentsSize() : customHotDocumentSize;
-    categorizeHotColdDocuments(size, documents, hotDocuments, coldDocuments);
+    if (customHotDocumentSize == -1 && memoryBudgetInBytes() > 0) {
+        categorizeHotColdDocumentsByMemory(memoryBudgetInBytes(), residentSetSize(),
+                                           documents, hotDocuments, coldDocuments);
+    } else {
+        const int size = (customHotDocumentSize == -1) ? hotDocumentsSize()
+                                                       : customHotDocumentSize;
+        categorizeHotColdDocuments(size, documents, hotDocuments, coldDocuments);
+    }
 
     // Cold documents should be suspended...
     const std::vector<Document> toSuspend = Utils::filtered(coldDocuments, &isSuspendable);
@@ -53,10 +53,19 @@ using SuspendResumeJobs = QVector<SuspendResumeJobsEntry>;
 SuspendResumeJobs createSuspendResumeJobs(const std::vector<Document> &documents,
                                           int customHotDocumentCounts = -1);
 
+// Set by QTC_CLANG_MEMORY_BUDGET_MB. If set, documents are suspended to keep the resident
+// memory of the backend below the budget instead of keeping a fixed number of them hot.
+qint64 memoryBudgetInBytes();
+
 // for tests
 void categorizeHotColdDocuments(int hotDocumentsSize,
                                 const std::vector<Document> &inDocuments,
                                 std::vector<Document> &hotDocuments,
                                 std::vector<Document> &coldDocuments);
+void categorizeHotColdDocumentsByMemory(qint64 memoryBudgetInBytes,
+                                        qint64 memoryUsageInBytes,
+                                        const std::vector<Document> &inDocuments,
+                                        std::vector<Document> &hotDocuments,
+                                        std::vector<Document> &coldDocuments);
 
 } // namespace ClangBackEnd
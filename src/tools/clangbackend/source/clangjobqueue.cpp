@@ -27,6 +27,7 @@
 #include "clangjobqueue.h"
 #include "clangdocument.h"
 #include "clangdocuments.h"
+#include "clangjobscheduler.h"
 #include "clangtranslationunits.h"
 #include "unsavedfiles.h"
 
@@ -46,6 +47,7 @@ bool JobQueue::add(const JobRequest &job)
     if (isJobRequestAddable(job, notAddableReason)) {
         qCDebugJobs() << "Adding" << job;
         m_queue.append(job);
+        m_queue.last().queuedTimePoint = Clock::now();
         return true;
     } else {
         qCDebugJobs() << "Not adding" << job << notAddableReason;
@@ -118,6 +120,12 @@ bool JobQueue::isJobRequestAddable(const JobRequest &jobRequest, QString &notAdd
 
 bool JobQueue::isJobRequestExpired(const JobRequest &jobRequest, QString &expirationReason)
 {
+    if (jobRequest.type == JobRequest::Type::RequestAnnotations
+            && isUpdateAnnotationsQueued(jobRequest.filePath)) {
+        expirationReason = "superseded by queued UpdateAnnotations";
+        return true;
+    }
+
     const JobRequest::ExpirationConditions conditions = jobRequest.expirationConditions;
     const UnsavedFiles unsavedFiles = m_documents.unsavedFiles();
     using Condition = JobRequest::ExpirationCondition;
@@ -153,6 +161,14 @@ bool JobQueue::isJobRequestExpired(const JobRequest &jobRequest, QString &expira
     return false;
 }
 
+bool JobQueue::isUpdateAnnotationsQueued(const Utf8String &filePath) const
+{
+    return Utils::anyOf(m_queue, [&filePath](const JobRequest &request) {
+        return request.type == JobRequest::Type::UpdateAnnotations
+            && request.filePath == filePath;
+    });
+}
+
 static int priority(const Document &document)
 {
     int thePriority = 0;
@@ -166,14 +182,48 @@ static int priority(const Document &document)
     return thePriority;
 }
 
+static JobRequest::LatencyClass latencyClass(const JobRequest &request, const Document &document)
+{
+    using Type = JobRequest::Type;
+    using LatencyClass = JobRequest::LatencyClass;
+
+    switch (request.type) {
+    case Type::RequestCompletions:
+    case Type::RequestToolTip:
+    case Type::RequestFollowSymbol:
+    case Type::RequestReferences:
+        return LatencyClass::Interactive;
+    case Type::UpdateAnnotations:
+    case Type::UpdateExtraAnnotations:
+    case Type::RequestAnnotations:
+        return document.isUsedByCurrentEditor() ? LatencyClass::Visible
+                                                : LatencyClass::Background;
+    case Type::ParseSupportiveTranslationUnit:
+    case Type::BuildSharedPreamble:
+    case Type::SuspendDocument:
+    case Type::ResumeDocument:
+    case Type::Invalid:
+        break;
+    }
+
+    return LatencyClass::Background;
+}
+
 void JobQueue::prioritizeRequests()
 {
-    const auto lessThan = [this] (const JobRequest &r1, const JobRequest &r2) {
-        // TODO: Getting the TU is O(n) currently, so this might become expensive for large n.
-        const Document &t1 = m_documents.document(r1.filePath);
-        const Document &t2 = m_documents.document(r2.filePath);
+    // TODO: Getting the TU is O(n) currently, so this might become expensive for large n.
+    QHash<Utf8String, int> priorities;
+    for (JobRequest &request : m_queue) {
+        const Document &document = m_documents.document(request.filePath);
+        request.latencyClass = latencyClass(request, document);
+        priorities.insert(request.filePath, priority(document));
+    }
 
-        return priority(t1) > priority(t2);
+    const auto lessThan = [&priorities] (const JobRequest &r1, const JobRequest &r2) {
+        if (r1.latencyClass != r2.latencyClass)
+            return r1.latencyClass < r2.latencyClass;
+
+        return priorities.value(r1.filePath) > priorities.value(r2.filePath);
     };
 
     std::stable_sort(m_queue.begin(), m_queue.end(), lessThan);
@@ -255,6 +305,11 @@ JobRequests JobQueue::takeJobRequestsToRunNow()
             if (isJobRunningForTranslationUnit(id))
                 continue;
 
+            if (!JobScheduler::instance().canStart(request.latencyClass, jobsToRun.size())) {
+                qCDebugJobs() << "Not choosing due to busy workers:" << request;
+                continue;
+            }
+
             translationUnitsScheduledForThisRun.insert(id);
             jobsToRun += request;
             m_queue.removeAt(pos--);
@@ -68,6 +68,7 @@ private:
     void removeExpiredRequests();
     bool isJobRequestAddable(const JobRequest &jobRequest, QString &notAddableReason);
     bool isJobRequestExpired(const JobRequest &jobRequest, QString &expirationReason);
+    bool isUpdateAnnotationsQueued(const Utf8String &filePath) const;
 
 private:
     Documents &m_documents;
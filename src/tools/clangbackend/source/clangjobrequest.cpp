@@ -25,6 +25,7 @@
 
 #include "clangjobrequest.h"
 
+#include "clangbuildsharedpreamblejob.h"
 #include "clangcompletecodejob.h"
 #include "clangfollowsymboljob.h"
 #include "clangparsesupportivetranslationunitjob.h"
@@ -58,6 +59,7 @@ static const char *JobRequestTypeToText(JobRequest::Type type)
         RETURN_TEXT_FOR_CASE(UpdateAnnotations);
         RETURN_TEXT_FOR_CASE(UpdateExtraAnnotations);
         RETURN_TEXT_FOR_CASE(ParseSupportiveTranslationUnit);
+        RETURN_TEXT_FOR_CASE(BuildSharedPreamble);
         RETURN_TEXT_FOR_CASE(RequestCompletions);
         RETURN_TEXT_FOR_CASE(RequestAnnotations);
         RETURN_TEXT_FOR_CASE(RequestReferences);
@@ -196,6 +198,9 @@ bool JobRequest::isTakeOverable() const
     // Discard these as they only make sense in a row. Avoid splitting them up.
     case Type::ParseSupportiveTranslationUnit:
 
+    // Discard this one as it is requested again by the next parse.
+    case Type::BuildSharedPreamble:
+
     case Type::Invalid:
         return false;
     }
@@ -225,6 +230,8 @@ IAsyncJob *JobRequest::createJob() const
         return new UpdateExtraAnnotationsJob();
     case JobRequest::Type::ParseSupportiveTranslationUnit:
         return new ParseSupportiveTranslationUnitJob();
+    case JobRequest::Type::BuildSharedPreamble:
+        return new BuildSharedPreambleJob();
     case JobRequest::Type::RequestCompletions:
         return new CompleteCodeJob();
     case JobRequest::Type::RequestAnnotations:
@@ -254,6 +261,7 @@ void JobRequest::cancelJob(ClangCodeModelClientInterface &client) const
     case JobRequest::Type::UpdateAnnotations:
     case JobRequest::Type::UpdateExtraAnnotations:
     case JobRequest::Type::ParseSupportiveTranslationUnit:
+    case JobRequest::Type::BuildSharedPreamble:
     case JobRequest::Type::RequestAnnotations:
     case JobRequest::Type::SuspendDocument:
     case JobRequest::Type::ResumeDocument:
@@ -53,6 +53,7 @@ public:
         UpdateExtraAnnotations,
 
         ParseSupportiveTranslationUnit,
+        BuildSharedPreamble,
 
         RequestCompletions,
         RequestAnnotations,
@@ -88,6 +89,13 @@ public:
     };
     Q_DECLARE_FLAGS(ExpirationConditions, ExpirationCondition)
 
+    // Order in which the queue runs requests, see JobScheduler.
+    enum class LatencyClass {
+        Interactive, // The user waits for the result, e.g. completions and tool tips
+        Visible,     // Annotations for the current editor
+        Background,  // Annotations for other visible documents, supportive parses, ...
+    };
+
 public:
     JobRequest(Type type = Type::Invalid);
 
@@ -102,6 +110,8 @@ public:
     Type type;
     ExpirationConditions expirationConditions;
     RunConditions runConditions;
+    LatencyClass latencyClass = LatencyClass::Background; // Updated by the queue
+    TimePoint queuedTimePoint;
 
     // General
     Utf8String filePath;
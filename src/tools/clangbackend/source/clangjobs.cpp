@@ -27,6 +27,7 @@
 
 #include "clangdocument.h"
 #include "clangiasyncjob.h"
+#include "clangjobscheduler.h"
 
 #include <QDebug>
 #include <QFutureSynchronizer>
@@ -67,8 +68,10 @@ Jobs::~Jobs()
     foreach (const RunningJob &runningJob, m_running.values())
         waitForFinishedJobs.addFuture(runningJob.future);
 
-    foreach (IAsyncJob *asyncJob, m_running.keys())
+    foreach (IAsyncJob *asyncJob, m_running.keys()) {
+        JobScheduler::instance().jobFinished(m_running.value(asyncJob).jobRequest);
         delete asyncJob;
+    }
 }
 
 JobRequest Jobs::createJobRequest(const Document &document,
@@ -155,6 +158,7 @@ bool Jobs::runJob(const JobRequest &jobRequest)
 
         const RunningJob runningJob{jobRequest, prepareResult.translationUnitId, future};
         m_running.insert(asyncJob, runningJob);
+        JobScheduler::instance().jobStarted(jobRequest);
         return true;
     } else {
         qCDebugJobs() << "Preparation failed for " << jobRequest;
@@ -174,9 +178,10 @@ void Jobs::onJobFinished(IAsyncJob *asyncJob)
             return;
     }
 
-    m_running.remove(asyncJob);
+    const JobRequest jobRequest = m_running.take(asyncJob).jobRequest;
     delete asyncJob;
 
+    JobScheduler::instance().jobFinished(jobRequest);
     process();
 }
 
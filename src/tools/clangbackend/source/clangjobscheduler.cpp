@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "clangjobscheduler.h"
+
+#include <utils/qtcassert.h>
+
+#include <QLoggingCategory>
+#include <QThread>
+
+#include <algorithm>
+
+static Q_LOGGING_CATEGORY(schedulerLog, "qtc.clangbackend.jobscheduler", QtWarningMsg);
+
+namespace ClangBackEnd {
+
+enum { QueueWaitLogInterval = 100 };
+
+static const int bucketUpperBoundsInMs[] = {10, 50, 100, 250, 500, 1000};
+
+static const char *latencyClassToText(JobRequest::LatencyClass latencyClass)
+{
+    switch (latencyClass) {
+    case JobRequest::LatencyClass::Interactive: return "Interactive";
+    case JobRequest::LatencyClass::Visible: return "Visible";
+    case JobRequest::LatencyClass::Background: return "Background";
+    }
+
+    return "UnhandledLatencyClass";
+}
+
+JobScheduler &JobScheduler::instance()
+{
+    static JobScheduler scheduler;
+    return scheduler;
+}
+
+JobScheduler::JobScheduler()
+    : m_workerCount(std::max(2, QThread::idealThreadCount()))
+{
+}
+
+int JobScheduler::workerCount() const
+{
+    return m_workerCount;
+}
+
+bool JobScheduler::canStart(LatencyClass latencyClass, int jobsAboutToStart)
+{
+    const int running = m_running + jobsAboutToStart;
+
+    bool startable = false;
+    switch (latencyClass) {
+    case LatencyClass::Interactive:
+        startable = true;
+        break;
+    case LatencyClass::Visible:
+        startable = running < m_workerCount;
+        break;
+    case LatencyClass::Background:
+        startable = running < m_workerCount - 1;
+        break;
+    }
+
+    if (!startable)
+        m_hasDeferredJobs = true;
+
+    return startable;
+}
+
+void JobScheduler::jobStarted(const JobRequest &jobRequest)
+{
+    ++m_running;
+
+    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - jobRequest.queuedTimePoint);
+    recordQueueWait(jobRequest.latencyClass, wait.count());
+}
+
+void JobScheduler::jobFinished(const JobRequest &)
+{
+    QTC_ASSERT(m_running > 0, return);
+    --m_running;
+
+    if (m_hasDeferredJobs && m_deferredJobsHandler) {
+        m_hasDeferredJobs = false;
+        m_deferredJobsHandler();
+    }
+}
+
+void JobScheduler::setDeferredJobsHandler(const DeferredJobsHandler &handler)
+{
+    m_deferredJobsHandler = handler;
+}
+
+void JobScheduler::recordQueueWait(LatencyClass latencyClass, qint64 waitInMs)
+{
+    const auto bucketEnd = std::end(bucketUpperBoundsInMs);
+    const auto bucket = std::upper_bound(std::begin(bucketUpperBoundsInMs), bucketEnd, waitInMs);
+    Histogram &histogram = m_queueWaitHistograms[static_cast<size_t>(latencyClass)];
+    ++histogram[static_cast<size_t>(bucket - std::begin(bucketUpperBoundsInMs))];
+
+    if (++m_startedSinceLastLog >= QueueWaitLogInterval) {
+        m_startedSinceLastLog = 0;
+        logQueueWaitHistograms();
+    }
+}
+
+void JobScheduler::logQueueWaitHistograms() const
+{
+    if (!schedulerLog().isInfoEnabled())
+        return;
+
+    for (size_t classIndex = 0; classIndex < m_queueWaitHistograms.size(); ++classIndex) {
+        const Histogram &histogram = m_queueWaitHistograms[classIndex];
+
+        QString text;
+        int lowerBound = 0;
+        for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+            if (bucket < histogram.size() - 1) {
+                const int upperBound = bucketUpperBoundsInMs[bucket];
+                text += QString("[%1,%2)ms:%3 ").arg(lowerBound).arg(upperBound)
+                                                 .arg(histogram[bucket]);
+                lowerBound = upperBound;
+            } else {
+                text += QString(">=%1ms:%2").arg(lowerBound).arg(histogram[bucket]);
+            }
+        }
+
+        qCInfo(schedulerLog).noquote()
+            << "Queue wait"
+            << latencyClassToText(static_cast<JobRequest::LatencyClass>(classIndex))
+            << text;
+    }
+}
+
+} // namespace ClangBackEnd
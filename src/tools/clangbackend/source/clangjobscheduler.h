@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "clangjobrequest.h"
+
+#include <array>
+#include <functional>
+
+namespace ClangBackEnd {
+
+// Every job runs on its own thread with a large stack, so without a limit the number of
+// concurrently parsing translation units grows with the number of visible documents.
+// The scheduler is shared by the job queues of all documents and decides whether a job of
+// a given latency class may start now. Interactive requests always start, the others only
+// while workers are free, with one worker kept free of background work.
+class JobScheduler
+{
+public:
+    using LatencyClass = JobRequest::LatencyClass;
+    using DeferredJobsHandler = std::function<void()>;
+
+    static JobScheduler &instance();
+
+    int workerCount() const;
+    bool canStart(LatencyClass latencyClass, int jobsAboutToStart = 0);
+
+    void jobStarted(const JobRequest &jobRequest);
+    void jobFinished(const JobRequest &jobRequest);
+
+    // Called on job completion if a request was deferred in the meantime, so that the
+    // queues of other documents get a chance to run it.
+    void setDeferredJobsHandler(const DeferredJobsHandler &handler);
+
+private:
+    enum { LatencyClassCount = 3, BucketCount = 7 };
+    using Histogram = std::array<int, BucketCount>;
+
+    JobScheduler();
+
+    void recordQueueWait(LatencyClass latencyClass, qint64 waitInMs);
+    void logQueueWaitHistograms() const;
+
+private:
+    int m_workerCount = 0;
+    int m_running = 0;
+    bool m_hasDeferredJobs = false;
+    DeferredJobsHandler m_deferredJobsHandler;
+
+    std::array<Histogram, LatencyClassCount> m_queueWaitHistograms{};
+    int m_startedSinceLastLog = 0;
+};
+
+} // namespace ClangBackEnd
@@ -0,0 +1,528 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "clangsharedpreambles.h"
+
+#include "clangfilepath.h"
+#include "clangstring.h"
+#include "clangunsavedfilesshallowarguments.h"
+#include "commandlinearguments.h"
+#include "unsavedfile.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <clang-c/Index.h>
+
+#include <algorithm>
+
+static Q_LOGGING_CATEGORY(preamblesLog, "qtc.clangbackend.sharedpreambles", QtWarningMsg);
+
+namespace ClangBackEnd {
+
+enum { MinimumIncludeCount = 3 };
+
+static bool isEnabled()
+{
+    static bool enabled = !qEnvironmentVariableIntValue("QTC_CLANG_NO_SHARED_PREAMBLES");
+    return enabled;
+}
+
+static bool isUnsaved(const UnsavedFile &unsavedFile, const Utf8String &filePath)
+{
+    return unsavedFile.filePath() == filePath;
+}
+
+static QByteArray fileContent(const Utf8String &filePath, UnsavedFiles &unsavedFiles)
+{
+    const UnsavedFile &unsavedFile = unsavedFiles.unsavedFile(filePath);
+    if (isUnsaved(unsavedFile, filePath))
+        return unsavedFile.fileContent().toByteArray();
+
+    QFile file(filePath.toString());
+    if (file.open(QIODevice::ReadOnly))
+        return file.readAll();
+
+    return QByteArray();
+}
+
+static QByteArray contentHash(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+}
+
+// The leading #include lines, skipping blank lines, comments and "#pragma once".
+static QByteArray includePrefix(const QByteArray &content, int &includeCount)
+{
+    QByteArray prefix;
+    bool isInBlockComment = false;
+
+    for (int position = 0; position < content.size();) {
+        int lineEnd = content.indexOf('\n', position);
+        if (lineEnd == -1)
+            lineEnd = content.size();
+        const QByteArray line = content.mid(position, lineEnd - position).trimmed();
+        position = lineEnd + 1;
+
+        if (isInBlockComment) {
+            isInBlockComment = !line.contains("*/");
+            continue;
+        }
+
+        if (line.isEmpty() || line.startsWith("//"))
+            continue;
+
+        if (line.startsWith("/*")) {
+            isInBlockComment = line.indexOf("*/", 2) == -1;
+            continue;
+        }
+
+        if (!line.startsWith('#'))
+            break;
+
+        const QByteArray directive = line.mid(1).trimmed();
+        if (directive.startsWith("pragma") && directive.mid(6).trimmed() == "once")
+            continue;
+
+        if (!directive.startsWith("include"))
+            break;
+
+        const QByteArray includedFile = directive.mid(7).trimmed();
+        const bool hasOpenComment = includedFile.lastIndexOf("/*") > includedFile.lastIndexOf("*/");
+        if (!(includedFile.startsWith('<') || includedFile.startsWith('"')) || hasOpenComment)
+            break;
+
+        prefix += "#include " + includedFile + '\n';
+        ++includeCount;
+    }
+
+    return prefix;
+}
+
+static QByteArray preambleKey(const Utf8String &filePath,
+                              const Utf8StringVector &compilationArguments,
+                              const QByteArray &prefix)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // Quoted includes are looked up relative to the including file.
+    hash.addData(QFileInfo(filePath.toString()).absolutePath().toUtf8());
+    hash.addData("\0", 1);
+    for (const Utf8String &argument : compilationArguments) {
+        hash.addData(argument.toByteArray());
+        hash.addData("\0", 1);
+    }
+    hash.addData(prefix);
+
+    return hash.result();
+}
+
+namespace {
+struct Inclusions
+{
+    CXTranslationUnit cxTranslationUnit = nullptr;
+    QSet<Utf8String> filePaths;
+    QVector<Utf8String> unguardedFilePaths;
+};
+} // anonymous namespace
+
+static void collectInclusion(CXFile includedFile,
+                             CXSourceLocation *,
+                             unsigned includeStackSize,
+                             CXClientData data)
+{
+    ClangString includedFilePath(clang_getFileName(includedFile));
+    const Utf8String filePath = FilePath::fromNativeSeparators(includedFilePath);
+
+    auto inclusions = static_cast<Inclusions *>(data);
+    inclusions->filePaths.insert(filePath);
+
+    // The document still contains the #include lines of the prefix, so the headers they
+    // name are included a second time. Headers included by those are not entered again
+    // once the header including them is guarded.
+    if (includeStackSize == 1
+            && !clang_isFileMultipleIncludeGuarded(inclusions->cxTranslationUnit, includedFile)) {
+        inclusions->unguardedFilePaths.append(filePath);
+    }
+}
+
+SharedPreambles &SharedPreambles::instance()
+{
+    static SharedPreambles sharedPreambles;
+
+    return sharedPreambles;
+}
+
+Utf8String SharedPreambles::preambleFor(const Utf8String &filePath,
+                                        const Utf8StringVector &compilationArguments,
+                                        UnsavedFiles unsavedFiles,
+                                        bool &buildNeeded)
+{
+    buildNeeded = false;
+
+    if (!isEnabled() || !m_directory.isValid()
+            || compilationArguments.contains(Utf8StringLiteral("-include-pch"))) {
+        return Utf8String();
+    }
+
+    int includeCount = 0;
+    const QByteArray prefix = includePrefix(fileContent(filePath, unsavedFiles), includeCount);
+    if (includeCount < MinimumIncludeCount)
+        return Utf8String();
+
+    const QByteArray key = preambleKey(filePath, compilationArguments, prefix);
+
+    QMutexLocker locker(&m_mutex);
+
+    Entry &entry = m_entries[key];
+    switch (entry.state) {
+    case Entry::State::None:
+        entry.state = Entry::State::Requested;
+        return Utf8String();
+    case Entry::State::Requested:
+        buildNeeded = true;
+        return Utf8String();
+    case Entry::State::Building:
+    case Entry::State::Failed:
+        return Utf8String();
+    case Entry::State::Built:
+        break;
+    }
+
+    const Utf8String preamblePath = entry.preamblePath;
+    locker.unlock();
+
+    if (isUpToDate(preamblePath, unsavedFiles))
+        return preamblePath;
+
+    // Outdated, isUpToDate() requested a new one.
+    buildNeeded = true;
+    return Utf8String();
+}
+
+bool SharedPreambles::build(const Utf8String &filePath,
+                            const Utf8StringVector &compilationArguments,
+                            UnsavedFiles unsavedFiles)
+{
+    int includeCount = 0;
+    const QByteArray prefix = includePrefix(fileContent(filePath, unsavedFiles), includeCount);
+    const QByteArray key = preambleKey(filePath, compilationArguments, prefix);
+
+    QMutexLocker locker(&m_mutex);
+
+    Entry entry = m_entries.value(key);
+    if (entry.state != Entry::State::Requested)
+        return false; // Built by another job or the include prefix changed meanwhile
+    m_entries[key].state = Entry::State::Building;
+
+    locker.unlock();
+
+    const Utf8String previousPreamblePath = entry.preamblePath;
+    ++entry.generation;
+    entry.upToDateForUnsavedFiles = unsavedFiles.lastChangeTimePoint();
+    const bool isBuilt = build(key, prefix, filePath, compilationArguments, unsavedFiles, entry);
+    entry.state = isBuilt ? Entry::State::Built : Entry::State::Failed;
+
+    locker.relock();
+
+    m_entries[key] = entry;
+    if (isBuilt)
+        m_keysByPreamblePath.insert(entry.preamblePath, key);
+    if (!previousPreamblePath.isEmpty())
+        removeIfUnused(previousPreamblePath);
+
+    return isBuilt;
+}
+
+Utf8StringVector SharedPreambles::argumentsWithPreamble(
+        const Utf8StringVector &compilationArguments,
+        const Utf8String &preamblePath)
+{
+    Utf8StringVector arguments;
+    arguments.reserve(compilationArguments.size() + 2);
+
+    for (int index = 0; index < compilationArguments.size(); ++index) {
+        const Utf8String &argument = compilationArguments.at(index);
+        if (argument == Utf8StringLiteral("-include")) {
+            ++index; // Skip the file name, too.
+            continue;
+        }
+        if (argument.startsWith("-include") && !argument.startsWith("-include-"))
+            continue;
+        arguments.append(argument);
+    }
+
+    arguments.append(Utf8StringLiteral("-include-pch"));
+    arguments.append(preamblePath);
+
+    return arguments;
+}
+
+bool SharedPreambles::build(const QByteArray &key,
+                            const QByteArray &prefix,
+                            const Utf8String &filePath,
+                            const Utf8StringVector &compilationArguments,
+                            UnsavedFiles &unsavedFiles,
+                            Entry &entry) const
+{
+    Utf8StringVector arguments = compilationArguments;
+    const int languageIndex = arguments.indexOf(Utf8StringLiteral("-x"));
+    if (languageIndex == -1 || languageIndex + 1 >= arguments.size())
+        return false;
+    Utf8String &language = arguments[languageIndex + 1];
+    if (!language.endsWith(Utf8StringLiteral("-header")))
+        language.append(Utf8StringLiteral("-header"));
+    arguments.append(Utf8StringLiteral("-iquote"));
+    arguments.append(Utf8String::fromString(QFileInfo(filePath.toString()).absolutePath()));
+
+    const QString basePath = m_directory.filePath(QString::fromLatin1(key.toHex()));
+    const Utf8String prefixHeaderPath = Utf8String::fromString(basePath + ".h");
+    QFile prefixHeader(prefixHeaderPath.toString());
+    if (!prefixHeader.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            || prefixHeader.write(prefix) != prefix.size()) {
+        return false;
+    }
+    prefixHeader.close();
+
+    // Translation units keep using their PCH on reparse, so never overwrite one.
+    const Utf8String preamblePath
+            = Utf8String::fromString(basePath + QString("-%1.pch").arg(entry.generation));
+
+    const CommandLineArguments commandLine(prefixHeaderPath.constData(), arguments, false);
+    UnsavedFilesShallowArguments unsaved = unsavedFiles.shallowArguments();
+
+    CXIndex cxIndex = clang_createIndex(0, 0);
+    CXTranslationUnit cxTranslationUnit = nullptr;
+    const CXErrorCode errorCode = clang_parseTranslationUnit2(
+                cxIndex,
+                nullptr,
+                commandLine.data(),
+                commandLine.count(),
+                unsaved.data(),
+                unsaved.count(),
+                CXTranslationUnit_Incomplete | CXTranslationUnit_ForSerialization,
+                &cxTranslationUnit);
+
+    Inclusions inclusions;
+    inclusions.cxTranslationUnit = cxTranslationUnit;
+    bool isSaved = false;
+    if (errorCode == CXError_Success) {
+        clang_getInclusions(cxTranslationUnit, collectInclusion, &inclusions);
+        isSaved = inclusions.unguardedFilePaths.isEmpty()
+                && clang_saveTranslationUnit(cxTranslationUnit,
+                                             preamblePath.constData(),
+                                             clang_defaultSaveOptions(cxTranslationUnit))
+                   == CXSaveError_None;
+        clang_disposeTranslationUnit(cxTranslationUnit);
+    }
+    clang_disposeIndex(cxIndex);
+
+    inclusions.filePaths.remove(FilePath::fromNativeSeparators(prefixHeaderPath));
+
+    // Also kept for a failed build, so invalidate() lets it be tried again.
+    entry.dependencies.clear();
+    entry.unsavedDependencies.clear();
+    for (const Utf8String &includedFilePath : inclusions.filePaths) {
+        Dependency dependency;
+        const UnsavedFile &unsavedFile = unsavedFiles.unsavedFile(includedFilePath);
+        if (isUnsaved(unsavedFile, includedFilePath)) {
+            dependency.wasUnsaved = true;
+            dependency.contentHash = contentHash(unsavedFile.fileContent().toByteArray());
+            entry.unsavedDependencies.append(includedFilePath);
+        } else {
+            dependency.contentHash = contentHash(fileContent(includedFilePath, unsavedFiles));
+        }
+
+        entry.dependencies.insert(includedFilePath, dependency);
+    }
+
+    if (!inclusions.unguardedFilePaths.isEmpty()) {
+        qCDebug(preamblesLog) << "Not sharing a preamble for" << filePath
+                              << "because of headers without include guard"
+                              << inclusions.unguardedFilePaths;
+        return false;
+    }
+
+    if (!isSaved) {
+        qCDebug(preamblesLog) << "Failed to build shared preamble for" << filePath;
+        return false;
+    }
+
+    entry.preamblePath = preamblePath;
+
+    qCDebug(preamblesLog) << "Built shared preamble" << preamblePath << "for" << filePath
+                          << "with" << entry.dependencies.size() << "files";
+
+    return true;
+}
+
+SharedPreambles::Entry *SharedPreambles::entryForPreamble(const Utf8String &preamblePath)
+{
+    const auto found = m_entries.find(m_keysByPreamblePath.value(preamblePath));
+    if (found == m_entries.end() || found->preamblePath != preamblePath)
+        return nullptr; // Replaced by a newer one
+
+    return &found.value();
+}
+
+const SharedPreambles::Entry *SharedPreambles::entryForPreamble(const Utf8String &preamblePath) const
+{
+    const auto found = m_entries.constFind(m_keysByPreamblePath.value(preamblePath));
+    if (found == m_entries.cend() || found->preamblePath != preamblePath)
+        return nullptr; // Replaced by a newer one
+
+    return &found.value();
+}
+
+// Must be called with the mutex locked.
+void SharedPreambles::removeIfUnused(const Utf8String &preamblePath)
+{
+    if (m_userCounts.contains(preamblePath))
+        return;
+
+    const Entry *entry = entryForPreamble(preamblePath);
+    if (entry && entry->state == Entry::State::Built)
+        return; // Still handed out to new translation units
+
+    QFile::remove(preamblePath.toString());
+    m_keysByPreamblePath.remove(preamblePath);
+
+    qCDebug(preamblesLog) << "Removed shared preamble" << preamblePath;
+}
+
+// Clang does not validate files overridden by unsaved content, so compare the content.
+bool SharedPreambles::isUpToDate(const Entry &entry, UnsavedFiles &unsavedFiles)
+{
+    for (uint index = 0; index < unsavedFiles.count(); ++index) {
+        const UnsavedFile &unsavedFile = unsavedFiles.at(int(index));
+        const auto found = entry.dependencies.constFind(unsavedFile.filePath());
+        if (found != entry.dependencies.cend()
+                && contentHash(unsavedFile.fileContent().toByteArray()) != found->contentHash) {
+            return false;
+        }
+    }
+
+    // Reverted to the content on disk
+    return std::all_of(entry.unsavedDependencies.cbegin(),
+                       entry.unsavedDependencies.cend(),
+                       [&](const Utf8String &filePath) {
+        return isUnsaved(unsavedFiles.unsavedFile(filePath), filePath);
+    });
+}
+
+bool SharedPreambles::isUpToDate(const Utf8String &preamblePath, UnsavedFiles unsavedFiles)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const Entry *entry = entryForPreamble(preamblePath);
+    if (!entry || entry->state != Entry::State::Built)
+        return false;
+
+    // Changes on disk are reported through invalidate(), so the dependencies only need to be
+    // checked again if the unsaved files changed.
+    const TimePoint unsavedFilesTimePoint = unsavedFiles.lastChangeTimePoint();
+    if (entry->upToDateForUnsavedFiles == unsavedFilesTimePoint)
+        return true;
+
+    const Entry entryCopy = *entry;
+
+    locker.unlock();
+
+    const bool isUpToDate = SharedPreambles::isUpToDate(entryCopy, unsavedFiles);
+
+    locker.relock();
+
+    if (Entry *currentEntry = entryForPreamble(preamblePath)) {
+        if (isUpToDate)
+            currentEntry->upToDateForUnsavedFiles = unsavedFilesTimePoint;
+        else if (currentEntry->state == Entry::State::Built)
+            currentEntry->state = Entry::State::Requested;
+    }
+
+    return isUpToDate;
+}
+
+void SharedPreambles::invalidate(const Utf8String &changedFilePath)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (Entry &entry : m_entries) {
+        if (entry.state != Entry::State::Built && entry.state != Entry::State::Failed)
+            continue;
+
+        // A build that failed before finding its includes might depend on any file.
+        const bool isFailedWithoutDependencies = entry.state == Entry::State::Failed
+                && entry.dependencies.isEmpty();
+        if (isFailedWithoutDependencies || entry.dependencies.contains(changedFilePath)) {
+            const bool wasBuilt = entry.state == Entry::State::Built;
+            entry.state = Entry::State::Requested;
+            if (wasBuilt)
+                removeIfUnused(entry.preamblePath);
+        }
+    }
+}
+
+QSet<Utf8String> SharedPreambles::dependencies(const Utf8String &preamblePath) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSet<Utf8String> filePaths;
+    if (const Entry *entry = entryForPreamble(preamblePath)) {
+        for (auto it = entry->dependencies.cbegin(); it != entry->dependencies.cend(); ++it)
+            filePaths.insert(it.key());
+    }
+
+    return filePaths;
+}
+
+void SharedPreambles::addUser(CXTranslationUnit cxTranslationUnit,
+                              const Utf8String &preamblePath)
+{
+    if (!cxTranslationUnit || preamblePath.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    m_preamblesByUser.insert(cxTranslationUnit, preamblePath);
+    ++m_userCounts[preamblePath];
+}
+
+void SharedPreambles::removeUser(CXTranslationUnit cxTranslationUnit)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const Utf8String preamblePath = m_preamblesByUser.take(cxTranslationUnit);
+    if (preamblePath.isEmpty())
+        return;
+
+    if (--m_userCounts[preamblePath] == 0) {
+        m_userCounts.remove(preamblePath);
+        removeIfUnused(preamblePath);
+    }
+}
+
+} // namespace ClangBackEnd
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "clangclock.h"
+#include "unsavedfiles.h"
+
+#include <utf8string.h>
+#include <utf8stringvector.h>
+
+#include <clang-c/Index.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QVector>
+
+namespace ClangBackEnd {
+
+// Documents of the same project part usually start with the same includes. Instead of
+// letting every translation unit build its own preamble for them, the include prefix is
+// precompiled once into a PCH that is shared by all documents with the same prefix and
+// compilation arguments. The first document with a given prefix is parsed as usual, the
+// second one requests a BuildSharedPreamble job and documents parsed after that job
+// finished use the PCH.
+class SharedPreambles
+{
+public:
+    static SharedPreambles &instance();
+
+    // Returns the PCH to pass with -include-pch or an empty string. Sets buildNeeded if a
+    // BuildSharedPreamble job should be run for the document.
+    Utf8String preambleFor(const Utf8String &filePath,
+                           const Utf8StringVector &compilationArguments,
+                           UnsavedFiles unsavedFiles,
+                           bool &buildNeeded);
+
+    // Run by the BuildSharedPreamble job.
+    bool build(const Utf8String &filePath,
+               const Utf8StringVector &compilationArguments,
+               UnsavedFiles unsavedFiles);
+
+    // The -include options of the document are part of the PCH already.
+    static Utf8StringVector argumentsWithPreamble(const Utf8StringVector &compilationArguments,
+                                                  const Utf8String &preamblePath);
+
+    // False if a file the PCH was built from has changed since, so translation units using
+    // it must be recreated instead of reparsed. Only files that are or were unsaved are
+    // checked, changes on disk are reported through invalidate().
+    bool isUpToDate(const Utf8String &preamblePath, UnsavedFiles unsavedFiles);
+    // Also lets a preamble that could not be built be tried again.
+    void invalidate(const Utf8String &changedFilePath);
+
+    QSet<Utf8String> dependencies(const Utf8String &preamblePath) const;
+
+    // A superseded PCH file is removed once no translation unit uses it any more.
+    void addUser(CXTranslationUnit cxTranslationUnit, const Utf8String &preamblePath);
+    void removeUser(CXTranslationUnit cxTranslationUnit);
+
+private:
+    struct Dependency {
+        QByteArray contentHash;
+        bool wasUnsaved = false;
+    };
+
+    struct Entry {
+        enum class State { None, Requested, Building, Built, Failed };
+
+        State state = State::None;
+        Utf8String preamblePath;
+        QHash<Utf8String, Dependency> dependencies;
+        QVector<Utf8String> unsavedDependencies;
+        int generation = 0;
+
+        // The dependencies were found unchanged for these unsaved files, so the translation
+        // units sharing this generation do not check them again.
+        TimePoint upToDateForUnsavedFiles;
+    };
+
+    SharedPreambles() = default;
+
+    bool build(const QByteArray &key,
+               const QByteArray &prefix,
+               const Utf8String &filePath,
+               const Utf8StringVector &compilationArguments,
+               UnsavedFiles &unsavedFiles,
+               Entry &entry) const;
+    Entry *entryForPreamble(const Utf8String &preamblePath);
+    const Entry *entryForPreamble(const Utf8String &preamblePath) const;
+    void removeIfUnused(const Utf8String &preamblePath);
+    static bool isUpToDate(const Entry &entry, UnsavedFiles &unsavedFiles);
+
+private:
+    mutable QMutex m_mutex;
+    QTemporaryDir m_directory;
+    QHash<QByteArray, Entry> m_entries;
+    QHash<Utf8String, QByteArray> m_keysByPreamblePath;
+    QHash<CXTranslationUnit, Utf8String> m_preamblesByUser;
+    QHash<Utf8String, int> m_userCounts;
+};
+
+} // namespace ClangBackEnd
@@ -25,10 +25,16 @@
 
 #include "clangsuspenddocumentjob.h"
 
+#include "clangdocumentsuspenderresumer.h"
+
 #include <clangsupport/clangsupportdebugutils.h>
 
 #include <utils/qtcassert.h>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 namespace ClangBackEnd {
 
 IAsyncJob::AsyncPrepareResult SuspendDocumentJob::prepareAsyncRun()
@@ -40,7 +46,14 @@ IAsyncJob::AsyncPrepareResult SuspendDocumentJob::prepareAsyncRun()
     TranslationUnit translationUnit = *m_translationUnit;
     setRunner([translationUnit]() {
         TIME_SCOPE_DURATION("SuspendDocumentJobRunner");
-        return translationUnit.suspend();
+        const bool suspended = translationUnit.suspend();
+#if defined(__GLIBC__)
+        // Hand the freed memory back to the system, otherwise the resident set size that
+        // the memory budget is checked against would not go down.
+        if (memoryBudgetInBytes() > 0)
+            malloc_trim(0);
+#endif
+        return suspended;
     });
 
     return AsyncPrepareResult{translationUnit.id()};
@@ -26,6 +26,7 @@
 #include "clangtranslationunits.h"
 
 #include "clangexceptions.h"
+#include "clangsharedpreambles.h"
 #include "clangtranslationunit.h"
 
 #include <utils/algorithm.h>
@@ -46,6 +47,7 @@ TranslationUnits::TranslationUnitData::TranslationUnitData(const Utf8String &id)
 TranslationUnits::TranslationUnitData::~TranslationUnitData()
 {
     qCDebug(tuLog) << "Destroying TranslationUnit" << id;
+    SharedPreambles::instance().removeUser(cxTranslationUnit);
     clang_disposeTranslationUnit(cxTranslationUnit);
     clang_disposeIndex(cxIndex);
 }
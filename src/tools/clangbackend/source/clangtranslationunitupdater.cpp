@@ -27,6 +27,7 @@
 
 #include "clangbackend_global.h"
 #include "clangfilepath.h"
+#include "clangsharedpreambles.h"
 #include "clangstring.h"
 #include "clangunsavedfilesshallowarguments.h"
 
@@ -50,11 +51,13 @@ TranslationUnitUpdater::TranslationUnitUpdater(const Utf8String translationUnitI
     , m_in(updateData)
 {
     m_out.translationUnitId = translationUnitId;
+    m_out.sharedPreamblePath = m_in.sharedPreamblePath;
 }
 
 TranslationUnitUpdateResult TranslationUnitUpdater::update(UpdateMode mode)
 {
     createIndexIfNeeded();
+    removeTranslationUnitIfSharedPreambleIsOutdated();
 
     switch (mode) {
     case UpdateMode::AsNeeded:
@@ -65,7 +68,10 @@ TranslationUnitUpdateResult TranslationUnitUpdater::update(UpdateMode mode)
         recreateAndParseIfNeeded();
         break;
     case UpdateMode::ForceReparse:
-        reparse();
+        if (m_cxTranslationUnit)
+            reparse();
+        else
+            createTranslationUnitIfNeeded();
         break;
     }
 
@@ -80,9 +86,26 @@ void TranslationUnitUpdater::recreateAndParseIfNeeded()
 
 void TranslationUnitUpdater::removeTranslationUnitIfProjectPartWasChanged()
 {
-    if (m_in.parseNeeded) {
-        clang_disposeTranslationUnit(m_cxTranslationUnit);
-        m_cxTranslationUnit = nullptr;
+    if (m_in.parseNeeded)
+        disposeTranslationUnit();
+}
+
+void TranslationUnitUpdater::disposeTranslationUnit()
+{
+    SharedPreambles::instance().removeUser(m_cxTranslationUnit);
+    clang_disposeTranslationUnit(m_cxTranslationUnit);
+    m_cxTranslationUnit = nullptr;
+}
+
+// A translation unit keeps using the shared PCH it was created with, so if one of the files
+// in the PCH changed, reparsing is not enough.
+void TranslationUnitUpdater::removeTranslationUnitIfSharedPreambleIsOutdated()
+{
+    if (m_cxTranslationUnit
+            && !m_in.sharedPreamblePath.isEmpty()
+            && !SharedPreambles::instance().isUpToDate(m_in.sharedPreamblePath,
+                                                       m_in.unsavedFiles)) {
+        disposeTranslationUnit();
     }
 }
 
@@ -106,7 +129,16 @@ void TranslationUnitUpdater::createTranslationUnitIfNeeded()
     if (!m_cxTranslationUnit) {
         m_cxTranslationUnit = CXTranslationUnit();
 
-        const auto args = commandLineArguments();
+        SharedPreambles &sharedPreambles = SharedPreambles::instance();
+        m_out.sharedPreamblePath = sharedPreambles.preambleFor(
+                    m_in.filePath, m_in.compilationArguments, m_in.unsavedFiles,
+                    m_out.isSharedPreambleBuildNeeded);
+
+        const auto args = m_out.sharedPreamblePath.isEmpty()
+                ? commandLineArguments()
+                : commandLineArguments(SharedPreambles::argumentsWithPreamble(
+                                           m_in.compilationArguments,
+                                           m_out.sharedPreamblePath));
         if (isVerboseModeEnabled())
             args.print();
 
@@ -121,10 +153,10 @@ void TranslationUnitUpdater::createTranslationUnitIfNeeded()
                                                      defaultParseOptions(),
                                                      &m_cxTranslationUnit);
 
-
-
         if (parseWasSuccessful()) {
+            sharedPreambles.addUser(m_cxTranslationUnit, m_out.sharedPreamblePath);
             updateIncludeFilePaths();
+            updateResourceUsage();
             m_out.parseTimePoint = Clock::now();
         } else {
             qWarning() << "Parsing" << m_in.filePath << "failed:"
@@ -153,6 +185,7 @@ void TranslationUnitUpdater::reparse()
 
     if (reparseWasSuccessful()) {
         updateIncludeFilePaths();
+        updateResourceUsage();
 
         m_out.reparseTimePoint = Clock::now();
         m_out.needsToBeReparsedChangeTimePoint = m_in.needsToBeReparsedChangeTimePoint;
@@ -162,6 +195,24 @@ void TranslationUnitUpdater::reparse()
     }
 }
 
+// Memory-mapped buffers are backed by files (e.g. PCHs), so they are dropped from memory
+// rather than swapped out. Count only what is allocated on the heap.
+void TranslationUnitUpdater::updateResourceUsage()
+{
+    m_out.resourceUsageInBytes = 0;
+
+    CXTUResourceUsage usage = clang_getCXTUResourceUsage(m_cxTranslationUnit);
+    for (unsigned i = 0; i < usage.numEntries; ++i) {
+        const CXTUResourceUsageEntry &entry = usage.entries[i];
+        if (entry.kind == CXTUResourceUsage_SourceManager_Membuffer_MMap
+                || entry.kind == CXTUResourceUsage_ExternalASTSource_Membuffer_MMap) {
+            continue;
+        }
+        m_out.resourceUsageInBytes += qint64(entry.amount);
+    }
+    clang_disposeCXTUResourceUsage(usage);
+}
+
 void TranslationUnitUpdater::updateIncludeFilePaths()
 {
     m_out.dependedOnFilePaths.clear();
@@ -170,6 +221,12 @@ void TranslationUnitUpdater::updateIncludeFilePaths()
     clang_getInclusions(m_cxTranslationUnit,
                         includeCallback,
                         const_cast<TranslationUnitUpdater *>(this));
+
+    // The files in the shared PCH must make the document dirty, too.
+    if (!m_out.sharedPreamblePath.isEmpty()) {
+        m_out.dependedOnFilePaths.unite(
+                    SharedPreambles::instance().dependencies(m_out.sharedPreamblePath));
+    }
 }
 
 uint TranslationUnitUpdater::defaultParseOptions()
@@ -218,9 +275,15 @@ bool TranslationUnitUpdater::reparseWasSuccessful() const
 }
 
 CommandLineArguments TranslationUnitUpdater::commandLineArguments() const
+{
+    return commandLineArguments(m_in.compilationArguments);
+}
+
+CommandLineArguments TranslationUnitUpdater::commandLineArguments(
+        const Utf8StringVector &compilationArguments) const
 {
     return CommandLineArguments(m_in.filePath.constData(),
-                                m_in.compilationArguments,
+                                compilationArguments,
                                 isVerboseModeEnabled());
 }
 
@@ -46,6 +46,7 @@ public:
 
     Utf8String filePath;
     Utf8StringVector compilationArguments;
+    Utf8String sharedPreamblePath;
 
     UnsavedFiles unsavedFiles;
 };
@@ -67,6 +68,10 @@ public:
     TimePoint needsToBeReparsedChangeTimePoint;
 
     QSet<Utf8String> dependedOnFilePaths;
+    Utf8String sharedPreamblePath;
+    bool isSharedPreambleBuildNeeded = false;
+
+    qint64 resourceUsageInBytes = 0;
 };
 
 class TranslationUnitUpdater {
@@ -86,17 +91,21 @@ public:
     TranslationUnitUpdateResult update(UpdateMode mode);
 
     CommandLineArguments commandLineArguments() const;
+    CommandLineArguments commandLineArguments(const Utf8StringVector &compilationArguments) const;
     static uint defaultParseOptions();
 
 private:
     void createIndexIfNeeded();
     void createTranslationUnitIfNeeded();
     void removeTranslationUnitIfProjectPartWasChanged();
+    void removeTranslationUnitIfSharedPreambleIsOutdated();
+    void disposeTranslationUnit();
     void reparseIfNeeded();
     void recreateAndParseIfNeeded();
     void reparse();
 
     void updateIncludeFilePaths();
+    void updateResourceUsage();
     static void includeCallback(CXFile included_file,
                                 CXSourceLocation *,
                                 unsigned,
@@ -0,0 +1,14 @@
+QT        -= gui
+QT        += network
+
+QTC_LIB_DEPENDS += \
+    sqlite \
+    clangsupport
+
+include(../../qtcreatortool.pri)
+
+TARGET    = clangipcbenchmark
+
+CONFIG    += warn_on
+
+SOURCES   += main.cpp
@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <codecompletion.h>
+#include <completionsmessage.h>
+#include <messageenvelop.h>
+#include <readmessageblock.h>
+#include <requestcompletionsmessage.h>
+#include <writemessageblock.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QTextStream>
+
+#include <algorithm>
+#include <vector>
+
+// Compares completion round trips through the local socket only with round trips through the
+// shared memory transport. Like Qt Creator and the clang backend, the requesting side runs in
+// this process and the answering side in a child process. The latency is measured from
+// sending the request until the completions are deserialized. The copied bytes of the answer
+// count the copies into and out of the kernel for the socket and into and out of the ring
+// buffer for the shared memory. The serialization itself is the same for both and not counted.
+
+namespace {
+
+const char backendArgument[] = "--backend";
+const char sharedMemoryVariable[] = "QTC_CLANG_SHARED_MEMORY_IPC";
+const int warmUpRoundTrips = 2;
+
+ClangBackEnd::CodeCompletions createCodeCompletions(int completionCount)
+{
+    ClangBackEnd::CodeCompletions codeCompletions;
+    codeCompletions.reserve(completionCount);
+    for (int i = 0; i < completionCount; ++i) {
+        ClangBackEnd::CodeCompletion codeCompletion(
+                    Utf8String::fromByteArray("completionCandidate" + QByteArray::number(i)),
+                    quint32(i),
+                    ClangBackEnd::CodeCompletion::FunctionCompletionKind);
+        codeCompletion.briefComment = Utf8StringLiteral("Does something useful.");
+        codeCompletion.chunks.append(ClangBackEnd::CodeCompletionChunk(
+                    ClangBackEnd::CodeCompletionChunk::ResultType, Utf8StringLiteral("int")));
+        codeCompletion.chunks.append(ClangBackEnd::CodeCompletionChunk(
+                    ClangBackEnd::CodeCompletionChunk::TypedText, codeCompletion.text));
+        codeCompletion.chunks.append(ClangBackEnd::CodeCompletionChunk(
+                    ClangBackEnd::CodeCompletionChunk::LeftParen, Utf8StringLiteral("(")));
+        codeCompletion.chunks.append(ClangBackEnd::CodeCompletionChunk(
+                    ClangBackEnd::CodeCompletionChunk::RightParen, Utf8StringLiteral(")")));
+        codeCompletions.append(codeCompletion);
+    }
+
+    return codeCompletions;
+}
+
+qint64 payloadSize(const ClangBackEnd::CompletionsMessage &message)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << message;
+
+    return data.size();
+}
+
+int runBackend(const QString &serverName, int completionCount)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if (!socket.waitForConnected())
+        return 1;
+
+    const ClangBackEnd::CodeCompletions codeCompletions = createCodeCompletions(completionCount);
+
+    ClangBackEnd::ReadMessageBlock readMessageBlock(&socket);
+    ClangBackEnd::WriteMessageBlock writeMessageBlock(&socket);
+    while (socket.waitForReadyRead(-1)) {
+        for (const ClangBackEnd::MessageEnvelop &envelop : readMessageBlock.readAll()) {
+            const auto request = envelop.message<ClangBackEnd::RequestCompletionsMessage>();
+            writeMessageBlock.write(ClangBackEnd::CompletionsMessage(codeCompletions,
+                                                                     request.ticketNumber));
+            while (socket.bytesToWrite() > 0) {
+                if (!socket.waitForBytesWritten())
+                    return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+struct Result
+{
+    bool isValid = false;
+    qint64 medianLatencyInUs = 0;
+    qint64 copiedBytesPerRoundTrip = 0;
+};
+
+Result runRoundTrips(const QString &program, bool useSharedMemory, int roundTripCount,
+                     int completionCount)
+{
+    Result result;
+
+    QLocalServer server;
+    if (!server.listen(QStringLiteral("qtc-clangipcbenchmark-%1")
+                       .arg(QCoreApplication::applicationPid()))) {
+        return result;
+    }
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (useSharedMemory)
+        environment.insert(QString::fromLatin1(sharedMemoryVariable), "1");
+    else
+        environment.remove(QString::fromLatin1(sharedMemoryVariable));
+    QProcess backend;
+    backend.setProcessEnvironment(environment);
+    backend.setProcessChannelMode(QProcess::ForwardedChannels);
+    backend.start(program, {QString::fromLatin1(backendArgument), server.fullServerName(),
+                            QString::number(completionCount)});
+
+    if (!server.waitForNewConnection(30000))
+        return result;
+    QLocalSocket *socket = server.nextPendingConnection();
+
+    const qint64 completionsPayloadSize = payloadSize(
+                ClangBackEnd::CompletionsMessage(createCodeCompletions(completionCount), 0));
+
+    ClangBackEnd::ReadMessageBlock readMessageBlock(socket);
+    ClangBackEnd::WriteMessageBlock writeMessageBlock(socket);
+    std::vector<qint64> latencies;
+    qint64 copiedBytes = 0;
+
+    for (int i = 0; i < warmUpRoundTrips + roundTripCount; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+
+        const ClangBackEnd::RequestCompletionsMessage request(Utf8StringLiteral("file.cpp"), 1, 1);
+        writeMessageBlock.write(request);
+
+        qint64 socketBytes = 0;
+        bool answered = false;
+        while (!answered && socket->waitForReadyRead(30000)) {
+            socketBytes += socket->bytesAvailable();
+            for (const ClangBackEnd::MessageEnvelop &envelop : readMessageBlock.readAll()) {
+                const auto message = envelop.message<ClangBackEnd::CompletionsMessage>();
+                if (message.ticketNumber != request.ticketNumber
+                        || message.codeCompletions.size() != completionCount) {
+                    return result;
+                }
+                answered = true;
+            }
+            socketBytes -= socket->bytesAvailable();
+        }
+        if (!answered)
+            return result;
+
+        if (i < warmUpRoundTrips)
+            continue;
+
+        latencies.push_back(timer.nsecsElapsed() / 1000);
+
+        // Without the payload the socket only carried a descriptor.
+        const bool payloadWasInSharedMemory = socketBytes < completionsPayloadSize;
+        copiedBytes += 2 * socketBytes + (payloadWasInSharedMemory ? 2 * completionsPayloadSize
+                                                                   : 0);
+    }
+
+    socket->disconnectFromServer();
+    backend.waitForFinished();
+
+    std::sort(latencies.begin(), latencies.end());
+    result.isValid = true;
+    result.medianLatencyInUs = latencies[latencies.size() / 2];
+    result.copiedBytesPerRoundTrip = copiedBytes / roundTripCount;
+
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const QStringList arguments = app.arguments();
+    if (arguments.value(1) == QLatin1String(backendArgument) && arguments.size() == 4)
+        return runBackend(arguments.at(2), arguments.at(3).toInt());
+
+    const int roundTripCount = arguments.size() > 1 ? arguments.at(1).toInt() : 100;
+    const int completionCount = arguments.size() > 2 ? arguments.at(2).toInt() : 10000;
+    if (roundTripCount <= 0 || completionCount <= 0) {
+        out << "Usage: " << arguments.first() << " [round trip count] [completion count]"
+            << endl;
+        return 1;
+    }
+
+    const auto report = [&](const char *name, const Result &result) {
+        if (!result.isValid) {
+            out << name << ": failed" << endl;
+            return;
+        }
+        out << name << ": " << result.medianLatencyInUs << " us median round trip, "
+            << result.copiedBytesPerRoundTrip << " bytes copied per round trip" << endl;
+    };
+    const QString program = app.applicationFilePath();
+    report("Local socket", runRoundTrips(program, false, roundTripCount, completionCount));
+    report("Shared memory", runRoundTrips(program, true, roundTripCount, completionCount));
+
+    return 0;
+}
@@ -42,7 +42,9 @@
 #include <QCryptographicHash>
 #include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QProcess>
+#include <QSaveFile>
 #include <QTemporaryFile>
 
 #include <iostream>
@@ -59,6 +61,53 @@ std::size_t contentSize(const FilePaths &includes)
 
     return std::accumulate(includes.begin(), includes.end(), std::size_t(0), countIncludeSize);
 }
+
+void addToHash(QCryptographicHash &hash, Utils::SmallStringView text)
+{
+    hash.addData(text.data(), int(text.size()));
+    hash.addData("\n", 1);
+}
+
+FilePathIds inputFilePathIds(const PchTask &pchTask)
+{
+    FilePathIds filePathIds;
+    filePathIds.reserve(pchTask.includes.size() + pchTask.watchedSystemIncludes.size()
+                        + pchTask.watchedProjectIncludes.size()
+                        + pchTask.watchedUserIncludes.size());
+
+    filePathIds.insert(filePathIds.end(), pchTask.includes.begin(), pchTask.includes.end());
+    filePathIds.insert(filePathIds.end(),
+                       pchTask.watchedSystemIncludes.begin(),
+                       pchTask.watchedSystemIncludes.end());
+    filePathIds.insert(filePathIds.end(),
+                       pchTask.watchedProjectIncludes.begin(),
+                       pchTask.watchedProjectIncludes.end());
+    filePathIds.insert(filePathIds.end(),
+                       pchTask.watchedUserIncludes.begin(),
+                       pchTask.watchedUserIncludes.end());
+
+    std::sort(filePathIds.begin(), filePathIds.end());
+    filePathIds.erase(std::unique(filePathIds.begin(), filePathIds.end()), filePathIds.end());
+
+    return filePathIds;
+}
+
+QString pchKeyFilePath(const FilePath &pchPath)
+{
+    return QString(pchPath) + ".key";
+}
+
+bool recordPchKey(const FilePath &pchPath, Utils::SmallStringView pchKey)
+{
+    QSaveFile keyFile{pchKeyFilePath(pchPath)};
+
+    if (!keyFile.open(QIODevice::WriteOnly))
+        return false;
+
+    keyFile.write(pchKey.data(), qint64(pchKey.size()));
+
+    return keyFile.commit();
+}
 }
 
 Utils::SmallString PchCreator::generatePchIncludeFileContent(const FilePathIds &includeIds) const
@@ -98,6 +147,80 @@ FilePath PchCreator::generatePchFilePath() const
                                           ".pch"}};
 }
 
+Utils::SmallString PchCreator::generatePchKey(const PchTask &pchTask,
+                                              Utils::SmallStringView content) const
+{
+    QCryptographicHash hash{QCryptographicHash::Sha1};
+
+    for (Utils::SmallStringView argument : generateClangCompilerArguments(pchTask, {}))
+        addToHash(hash, argument);
+
+    addToHash(hash, content);
+
+    for (const FilePath &filePath : m_filePathCache.filePaths(inputFilePathIds(pchTask))) {
+        QFileInfo fileInfo{QString(filePath)};
+        addToHash(hash, filePath);
+        addToHash(hash, Utils::SmallString::number(fileInfo.size()));
+        addToHash(hash, Utils::SmallString::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    }
+
+    return Utils::SmallString{hash.result().toHex().toStdString()};
+}
+
+FilePath PchCreator::generatePchFilePath(Utils::SmallStringView pchKey) const
+{
+    return FilePathView{Utils::PathString{Utils::SmallString(m_environment.pchBuildDirectory()),
+                                          "/",
+                                          pchKey,
+                                          ".pch"}};
+}
+
+// A PCH is only used if it is not empty and the key recorded next to it matches. A file
+// left over by a crash or written with another key is rebuilt.
+bool PchCreator::isValidPch(const FilePath &pchPath, Utils::SmallStringView pchKey)
+{
+    if (QFileInfo{QString(pchPath)}.size() <= 0)
+        return false;
+
+    QFile keyFile{pchKeyFilePath(pchPath)};
+    if (!keyFile.open(QIODevice::ReadOnly))
+        return false;
+
+    return keyFile.readAll() == QByteArray::fromRawData(pchKey.data(), int(pchKey.size()));
+}
+
+// The key is recorded before the PCH is moved into place, so a PCH at the final path always
+// has a key.
+bool PchCreator::moveToPchFilePath(const FilePath &temporaryPchPath,
+                                   const FilePath &pchPath,
+                                   Utils::SmallStringView pchKey)
+{
+    const QString temporaryPath{temporaryPchPath};
+    const QString path{pchPath};
+
+    if (!recordPchKey(pchPath, pchKey)) {
+        QFile::remove(temporaryPath);
+        return false;
+    }
+
+    if (QFile::rename(temporaryPath, path))
+        return true;
+
+    // Another creator stored a PCH with the same key in the meantime.
+    if (isValidPch(pchPath, pchKey)) {
+        QFile::remove(temporaryPath);
+        return true;
+    }
+
+    // The existing file is broken, replace it with the new one.
+    if (QFile::remove(path) && QFile::rename(temporaryPath, path))
+        return true;
+
+    QFile::remove(temporaryPath);
+
+    return false;
+}
+
 Utils::SmallStringVector PchCreator::generateClangCompilerArguments(const PchTask &pchTask,
                                                                     FilePathView pchOutputPath)
 {
@@ -129,26 +252,43 @@ void PchCreator::generatePch(PchTask &&pchTask)
 {
     m_projectPartPch.projectPartId = pchTask.projectPartId();
     m_projectPartPch.lastModified = QDateTime::currentSecsSinceEpoch();
-    m_watchedSystemIncludes = std::move(pchTask.watchedSystemIncludes);
-    m_watchedProjectIncludes = std::move(pchTask.watchedProjectIncludes);
-    m_watchedUserIncludes = std::move(pchTask.watchedUserIncludes);
-    m_watchedSources = std::move(pchTask.watchedUserSources);
 
-    if (pchTask.includes.empty())
+    if (pchTask.includes.empty()) {
+        takeWatchedFilePaths(std::move(pchTask));
         return;
+    }
 
     auto content = generatePchIncludeFileContent(pchTask.includes);
+    auto pchKey = generatePchKey(pchTask, content);
+    auto pchPath = generatePchFilePath(pchKey);
+
+    if (isValidPch(pchPath, pchKey)) {
+        m_projectPartPch.lastModified = QFileInfo{QString(pchPath)}.lastModified().toSecsSinceEpoch();
+        m_projectPartPch.pchPath = std::move(pchPath);
+        takeWatchedFilePaths(std::move(pchTask));
+        return;
+    }
+
     auto pchOutputPath = generatePchFilePath();
 
     FilePath headerFilePath{m_environment.pchBuildDirectory(), "dummy.h"};
     Utils::SmallStringVector commandLine = generateClangCompilerArguments(pchTask, pchOutputPath);
 
+    takeWatchedFilePaths(std::move(pchTask));
+
     m_clangTool.addFile(std::move(headerFilePath), content.clone(), std::move(commandLine));
     bool success = generatePch(NativeFilePath{headerFilePath}, content);
 
+    if (success && moveToPchFilePath(pchOutputPath, pchPath, pchKey))
+        m_projectPartPch.pchPath = std::move(pchPath);
+}
 
-    if (success)
-        m_projectPartPch.pchPath = std::move(pchOutputPath);   
+void PchCreator::takeWatchedFilePaths(PchTask &&pchTask)
+{
+    m_watchedSystemIncludes = std::move(pchTask.watchedSystemIncludes);
+    m_watchedProjectIncludes = std::move(pchTask.watchedProjectIncludes);
+    m_watchedUserIncludes = std::move(pchTask.watchedUserIncludes);
+    m_watchedSources = std::move(pchTask.watchedUserSources);
 }
 
 const ProjectPartPch &PchCreator::projectPartPch()
@@ -79,6 +79,12 @@ public:
     bool generatePch(NativeFilePathView path, Utils::SmallStringView content);
 
     FilePath generatePchFilePath() const;
+    FilePath generatePchFilePath(Utils::SmallStringView pchKey) const;
+    Utils::SmallString generatePchKey(const PchTask &pchTask, Utils::SmallStringView content) const;
+    static bool isValidPch(const FilePath &pchPath, Utils::SmallStringView pchKey);
+    static bool moveToPchFilePath(const FilePath &temporaryPchPath,
+                                  const FilePath &pchPath,
+                                  Utils::SmallStringView pchKey);
     static Utils::SmallStringVector generateClangCompilerArguments(const PchTask &pchTask,
                                                                    FilePathView pchPath);
 
@@ -91,6 +97,9 @@ public:
     const FilePathIds &watchedUserIncludes() const { return m_watchedUserIncludes; }
     const FilePathIds &watchedSources() const { return m_watchedSources; }
 
+private:
+    void takeWatchedFilePaths(PchTask &&pchTask);
+
 private:
     mutable std::mt19937_64 randomNumberGenator{std::random_device{}()};
     ClangTool m_clangTool;
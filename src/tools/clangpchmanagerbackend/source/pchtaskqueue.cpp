@@ -146,8 +146,14 @@ void PchTaskQueue::deleteUnusedPchs()
     FilePathIds notAnymoreUsedPchFilePathIds;
     notAnymoreUsedPchFilePathIds.reserve(existingPchFilePathIds.size());
 
-    FilePathIds usedPchFilePathIds = m_filePathCache.filePathIds(
-        m_precompiledHeaderStorage.fetchAllPchPaths());
+    FilePaths usedPchFilePaths = m_precompiledHeaderStorage.fetchAllPchPaths();
+    const std::size_t usedPchCount = usedPchFilePaths.size();
+    usedPchFilePaths.reserve(usedPchCount * 2);
+    // Keep the key recorded next to each PCH, see PchCreator::isValidPch().
+    for (std::size_t index = 0; index < usedPchCount; ++index)
+        usedPchFilePaths.emplace_back(Utils::PathString{usedPchFilePaths[index].path(), ".key"});
+
+    FilePathIds usedPchFilePathIds = m_filePathCache.filePathIds(std::move(usedPchFilePaths));
     std::sort(usedPchFilePathIds.begin(), usedPchFilePathIds.end());
 
     std::set_difference(existingPchFilePathIds.begin(),
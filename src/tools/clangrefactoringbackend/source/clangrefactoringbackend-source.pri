@@ -9,6 +9,7 @@ HEADERS += \
     $$PWD/symbolscollectorinterface.h \
     $$PWD/symbolstorageinterface.h \
     $$PWD/symbolstorage.h \
+    $$PWD/symbolstoragewriter.h \
     $$PWD/symbolindexing.h \
     $$PWD/symbolindexinginterface.h \
     $$PWD/collectmacrospreprocessorcallbacks.h \
@@ -55,4 +56,5 @@ HEADERS += \
 
 SOURCES += \
     $$PWD/sourcerangefilter.cpp \
-    $$PWD/symbolindexer.cpp
+    $$PWD/symbolindexer.cpp \
+    $$PWD/symbolstoragewriter.cpp
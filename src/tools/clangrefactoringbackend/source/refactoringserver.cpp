@@ -143,8 +143,19 @@ void RefactoringServer::setGathererProcessingSlotCount(uint count)
 
 void RefactoringServer::setProgress(int progress, int total)
 {
+    // The progress counter serializes the calls, so the start time point needs no lock.
+    const auto now = std::chrono::steady_clock::now();
+    if (progress == 0)
+        m_indexingStartTimePoint = now;
+
+    int itemsPerSecond = 0;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - m_indexingStartTimePoint);
+    if (progress > 0 && elapsed.count() > 0)
+        itemsPerSecond = int(progress * 1000LL / elapsed.count());
+
     if (client())
-        client()->progress({ProgressType::Indexing, progress, total});
+        client()->progress({ProgressType::Indexing, progress, total, itemsPerSecond});
 }
 
 void RefactoringServer::gatherSourceRangesForQueryMessages(
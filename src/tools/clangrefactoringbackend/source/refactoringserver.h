@@ -37,6 +37,7 @@
 
 #include <QTimer>
 
+#include <chrono>
 #include <future>
 #include <mutex>
 #include <vector>
@@ -91,6 +92,7 @@ private:
     SymbolIndexingInterface &m_symbolIndexing;
     FilePathCachingInterface &m_filePathCache;
     GeneratedFiles &m_generatedFiles;
+    std::chrono::steady_clock::time_point m_indexingStartTimePoint = std::chrono::steady_clock::now();
 };
 
 } // namespace ClangBackEnd
@@ -81,6 +81,7 @@ SymbolIndexer::SymbolIndexer(SymbolIndexerTaskQueueInterface &symbolIndexerTaskQ
     , m_projectPartsStorage(projectPartsStorage)
     , m_modifiedTimeChecker(modifiedTimeChecker)
     , m_environment(environment)
+    , m_symbolStorageWriter(symbolStorage, buildDependenciesStorage, transactionInterface)
 {
     pathWatcher.setNotifier(this);
 }
@@ -93,31 +94,18 @@ void SymbolIndexer::updateProjectParts(ProjectPartContainers &&projectParts)
 
 namespace {
 
-void store(SymbolStorageInterface &symbolStorage,
-           BuildDependenciesStorageInterface &buildDependencyStorage,
-           Sqlite::TransactionInterface &transactionInterface,
+void store(SymbolStorageWriter &symbolStorageWriter,
            SymbolsCollectorInterface &symbolsCollector,
            const FilePathIds &dependentSources)
 {
-    try {
-        long long now = std::chrono::duration_cast<std::chrono::seconds>(
-                            std::chrono::system_clock::now().time_since_epoch())
-                            .count();
-
-        Sqlite::ImmediateTransaction transaction{transactionInterface};
-        buildDependencyStorage.insertOrUpdateIndexingTimeStampsWithoutTransaction(dependentSources,
-                                                                                  now);
-
-        symbolStorage.addSymbolsAndSourceLocations(symbolsCollector.symbols(),
-                                                   symbolsCollector.sourceLocations());
-        transaction.commit();
-    } catch (const Sqlite::StatementIsBusy &) {
-        store(symbolStorage,
-              buildDependencyStorage,
-              transactionInterface,
-              symbolsCollector,
-              dependentSources);
-    }
+    long long now = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+
+    symbolStorageWriter.push({symbolsCollector.takeSymbols(),
+                              symbolsCollector.takeSourceLocations(),
+                              dependentSources,
+                              now});
 }
 
 FilePathIds toFilePathIds(const SourceTimeStamps &sourceTimeStamps)
@@ -164,23 +152,11 @@ void SymbolIndexer::updateProjectPart(ProjectPartContainer &&projectPart)
                     projectPart.projectPartId);
 
                 if (pchPaths.projectPchPath.size() && collect(pchPaths.projectPchPath)) {
-                    store(m_symbolStorage,
-                          m_buildDependencyStorage,
-                          m_transactionInterface,
-                          symbolsCollector,
-                          dependentSources);
+                    store(m_symbolStorageWriter, symbolsCollector, dependentSources);
                 } else if (pchPaths.systemPchPath.size() && collect(pchPaths.systemPchPath)) {
-                    store(m_symbolStorage,
-                          m_buildDependencyStorage,
-                          m_transactionInterface,
-                          symbolsCollector,
-                          dependentSources);
+                    store(m_symbolStorageWriter, symbolsCollector, dependentSources);
                 } else if (collect({})) {
-                    store(m_symbolStorage,
-                          m_buildDependencyStorage,
-                          m_transactionInterface,
-                          symbolsCollector,
-                          dependentSources);
+                    store(m_symbolStorageWriter, symbolsCollector, dependentSources);
                 }
             };
 
@@ -242,23 +218,11 @@ void SymbolIndexer::updateChangedPath(FilePathId filePathId,
             optionalArtefact->projectPartId);
 
         if (pchPaths.projectPchPath.size() && collect(pchPaths.projectPchPath)) {
-            store(m_symbolStorage,
-                  m_buildDependencyStorage,
-                  m_transactionInterface,
-                  symbolsCollector,
-                  dependentSources);
+            store(m_symbolStorageWriter, symbolsCollector, dependentSources);
         } else if (pchPaths.systemPchPath.size() && collect(pchPaths.systemPchPath)) {
-            store(m_symbolStorage,
-                  m_buildDependencyStorage,
-                  m_transactionInterface,
-                  symbolsCollector,
-                  dependentSources);
+            store(m_symbolStorageWriter, symbolsCollector, dependentSources);
         } else if (collect({})) {
-            store(m_symbolStorage,
-                  m_buildDependencyStorage,
-                  m_transactionInterface,
-                  symbolsCollector,
-                  dependentSources);
+            store(m_symbolStorageWriter, symbolsCollector, dependentSources);
         }
     };
 
@@ -303,4 +267,9 @@ FilePathIds SymbolIndexer::updatableFilePathIds(const ProjectPartContainer &proj
     return filterChangedFiles(projectPart);
 }
 
+bool SymbolIndexer::flushSymbolStorage()
+{
+    return m_symbolStorageWriter.flush();
+}
+
 } // namespace ClangBackEnd
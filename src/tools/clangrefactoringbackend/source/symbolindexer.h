@@ -28,6 +28,7 @@
 #include "filestatuscache.h"
 #include "symbolindexertaskqueueinterface.h"
 #include "symbolstorageinterface.h"
+#include "symbolstoragewriter.h"
 #include "builddependenciesstorageinterface.h"
 
 #include <clangpathwatcher.h>
@@ -75,6 +76,8 @@ public:
     FilePathIds updatableFilePathIds(const ProjectPartContainer &projectPart,
                                      const Utils::optional<ProjectPartArtefact> &optionalArtefact) const;
 
+    bool flushSymbolStorage();
+
 private:
     FilePathIds filterProjectPartSources(const FilePathIds &filePathIds) const;
 
@@ -90,6 +93,7 @@ private:
     ProjectPartsStorageInterface &m_projectPartsStorage;
     ModifiedTimeCheckerInterface<SourceTimeStamps> &m_modifiedTimeChecker;
     const Environment &m_environment;
+    SymbolStorageWriter m_symbolStorageWriter;
 };
 
 } // namespace ClangBackEnd
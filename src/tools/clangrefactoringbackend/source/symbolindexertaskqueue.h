@@ -49,12 +49,16 @@ class SymbolIndexerTaskQueue final : public SymbolIndexerTaskQueueInterface
 public:
     using Task = SymbolIndexerTask::Callable;
 
+    using IndexingFinishedCallback = std::function<void()>;
+
     SymbolIndexerTaskQueue(TaskSchedulerInterface<Task> &symbolIndexerTaskScheduler,
                            ProgressCounter &progressCounter,
-                           Sqlite::DatabaseInterface &database)
+                           Sqlite::DatabaseInterface &database,
+                           IndexingFinishedCallback &&indexingFinishedCallback = {})
         : m_symbolIndexerScheduler(symbolIndexerTaskScheduler)
         , m_progressCounter(progressCounter)
         , m_database(database)
+        , m_indexingFinishedCallback(std::move(indexingFinishedCallback))
     {}
 
     void addOrUpdateTasks(std::vector<SymbolIndexerTask> &&tasks) override
@@ -102,6 +106,9 @@ public:
         m_tasks.erase(newEnd, m_tasks.end());
 
         if (m_tasks.empty() && slotUsage.used == 0) {
+            if (m_indexingFinishedCallback)
+                m_indexingFinishedCallback();
+
             try {
                 m_database.walCheckpointFull();
             } catch (Sqlite::Exception &exception) {
@@ -117,6 +124,7 @@ private:
     TaskSchedulerInterface<Task> &m_symbolIndexerScheduler;
     ProgressCounter &m_progressCounter;
     Sqlite::DatabaseInterface &m_database;
+    IndexingFinishedCallback m_indexingFinishedCallback;
 };
 
 } // namespace ClangBackEnd
@@ -106,7 +106,10 @@ public:
                     m_projectPartsStorage,
                     m_modifiedTimeChecker,
                     environment)
-        , m_indexerQueue(m_indexerScheduler, m_progressCounter, database)
+        , m_indexerQueue(m_indexerScheduler,
+                         m_progressCounter,
+                         database,
+                         [this] { m_indexer.flushSymbolStorage(); })
         , m_indexerScheduler(m_collectorManger,
                              m_indexerQueue,
                              m_progressCounter,
@@ -118,6 +121,7 @@ public:
     ~SymbolIndexing()
     {
         syncTasks();
+        m_indexer.flushSymbolStorage();
     }
 
     SymbolIndexer &indexer()
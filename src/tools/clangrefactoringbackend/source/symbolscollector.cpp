@@ -148,6 +148,16 @@ const SourceLocationEntries &SymbolsCollector::sourceLocations() const
     return m_sourceLocationEntries;
 }
 
+SymbolEntries SymbolsCollector::takeSymbols()
+{
+    return std::move(m_symbolEntries);
+}
+
+SourceLocationEntries SymbolsCollector::takeSourceLocations()
+{
+    return std::move(m_sourceLocationEntries);
+}
+
 bool SymbolsCollector::isUsed() const
 {
     return m_isUsed;
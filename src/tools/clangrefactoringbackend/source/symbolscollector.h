@@ -59,6 +59,9 @@ public:
     const SymbolEntries &symbols() const override;
     const SourceLocationEntries &sourceLocations() const override;
 
+    SymbolEntries takeSymbols() override;
+    SourceLocationEntries takeSourceLocations() override;
+
     bool isUsed() const override;
     void setIsUsed(bool isUsed) override;
 
@@ -48,6 +48,9 @@ public:
 
     virtual const SymbolEntries &symbols() const = 0;
     virtual const SourceLocationEntries &sourceLocations() const = 0;
+
+    virtual SymbolEntries takeSymbols() = 0;
+    virtual SourceLocationEntries takeSourceLocations() = 0;
 };
 
 } // namespace ClangBackEnd
@@ -28,6 +28,7 @@
 #include "symbolstorageinterface.h"
 
 #include <filepathcachingfwd.h>
+#include <sqlitebatchwritestatement.h>
 #include <sqliteexception.h>
 #include <sqlitetransaction.h>
 #include <sqlitetable.h>
@@ -48,6 +49,7 @@ class SymbolStorage final : public SymbolStorageInterface
     template<int ResultCount>
     using ReadStatement = typename Database::template ReadStatement<ResultCount>;
     using WriteStatement = typename Database::WriteStatement;
+    using BatchWriteStatement = typename Database::BatchWriteStatement;
 
 public:
     SymbolStorage(Database &database)
@@ -74,27 +76,25 @@ public:
 
     void fillTemporarySymbolsTable(const SymbolEntries &symbolEntries)
     {
-        WriteStatement &statement = insertSymbolsToNewSymbolsStatement;
-
-        for (const auto &symbolEntry : symbolEntries) {
-            statement.write(symbolEntry.first,
-                            symbolEntry.second.usr,
-                            symbolEntry.second.symbolName,
-                            static_cast<uint>(symbolEntry.second.symbolKind));
-        }
+        insertSymbolsToNewSymbolsStatement.write(symbolEntries, [](const auto &symbolEntry) {
+            return std::make_tuple(symbolEntry.first,
+                                   Utils::SmallStringView{symbolEntry.second.usr},
+                                   Utils::SmallStringView{symbolEntry.second.symbolName},
+                                   static_cast<uint>(symbolEntry.second.symbolKind));
+        });
     }
 
     void fillTemporaryLocationsTable(const SourceLocationEntries &sourceLocations)
     {
-        WriteStatement &statement = insertLocationsToNewLocationsStatement;
-
-        for (const auto &locationEntry : sourceLocations) {
-            statement.write(locationEntry.symbolId,
-                            locationEntry.lineColumn.line,
-                            locationEntry.lineColumn.column,
-                            locationEntry.filePathId.filePathId,
-                            int(locationEntry.kind));
-        }
+        const auto toValues = [](const auto &locationEntry) {
+            return std::make_tuple(locationEntry.symbolId,
+                                   locationEntry.lineColumn.line,
+                                   locationEntry.lineColumn.column,
+                                   locationEntry.filePathId.filePathId,
+                                   int(locationEntry.kind));
+        };
+
+        insertLocationsToNewLocationsStatement.write(sourceLocations, toValues);
     }
 
     void addNewSymbolsToSymbols() { addNewSymbolsToSymbolsStatement.execute(); }
@@ -160,10 +160,10 @@ public:
     Database &database;
     Sqlite::Table newSymbolsTablet{createNewSymbolsTable()};
     Sqlite::Table newLocationsTable{createNewLocationsTable()};
-    WriteStatement insertSymbolsToNewSymbolsStatement{
+    BatchWriteStatement insertSymbolsToNewSymbolsStatement{
         "INSERT INTO newSymbols(temporarySymbolId, usr, symbolName, symbolKind) VALUES(?,?,?,?)",
         database};
-    WriteStatement insertLocationsToNewLocationsStatement{
+    BatchWriteStatement insertLocationsToNewLocationsStatement{
         "INSERT OR IGNORE INTO newLocations(temporarySymbolId, line, column, sourceId, "
         "locationKind) VALUES(?,?,?,?,?)",
         database};
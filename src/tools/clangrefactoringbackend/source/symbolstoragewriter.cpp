@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include "symbolstoragewriter.h"
+
+#include <sqliteexception.h>
+#include <sqlitetransaction.h>
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+namespace ClangBackEnd {
+
+SymbolStorageWriter::SymbolStorageWriter(SymbolStorageInterface &symbolStorage,
+                                         BuildDependenciesStorageInterface &buildDependenciesStorage,
+                                         Sqlite::TransactionInterface &transactionInterface,
+                                         std::size_t maximumQueuedBatches,
+                                         std::chrono::milliseconds commitInterval)
+    : m_symbolStorage(symbolStorage)
+    , m_buildDependenciesStorage(buildDependenciesStorage)
+    , m_transactionInterface(transactionInterface)
+    , m_maximumQueuedBatches(std::max<std::size_t>(1, maximumQueuedBatches))
+    , m_commitInterval(commitInterval)
+    , m_thread([this] { run(); })
+{}
+
+SymbolStorageWriter::~SymbolStorageWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_isStopping = true;
+    }
+
+    m_batchPushed.notify_one();
+    m_thread.join();
+}
+
+void SymbolStorageWriter::push(Batch &&batch)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_batchTaken.wait(lock, [&] { return m_queue.size() < m_maximumQueuedBatches; });
+
+    m_queue.push_back(std::move(batch));
+    lock.unlock();
+
+    m_batchPushed.notify_one();
+}
+
+bool SymbolStorageWriter::flush()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    ++m_flushRequestCount;
+    m_batchPushed.notify_one();
+
+    m_batchesStored.wait(lock, [&] { return m_queue.empty() && m_storingBatchCount == 0; });
+    --m_flushRequestCount;
+
+    const bool noBatchDropped = m_droppedBatchCount == 0;
+    m_droppedBatchCount = 0;
+
+    return noBatchDropped;
+}
+
+void SymbolStorageWriter::run()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_batchPushed.wait(lock, [&] { return !m_queue.empty() || m_isStopping; });
+
+            if (m_queue.empty() && m_isStopping)
+                return;
+        }
+
+        const std::vector<Batch> batches = takeBatches(Clock::now() + m_commitInterval);
+
+        store(batches);
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_storingBatchCount = 0;
+        }
+        m_batchesStored.notify_all();
+    }
+}
+
+// Collects batches until the deadline, so that one commit covers all of them. On shutdown
+// or flush the remaining batches are stored right away.
+std::vector<SymbolStorageWriter::Batch> SymbolStorageWriter::takeBatches(Clock::time_point deadline)
+{
+    std::vector<Batch> batches;
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+    do {
+        std::move(m_queue.begin(), m_queue.end(), std::back_inserter(batches));
+        m_storingBatchCount += m_queue.size();
+        m_queue.clear();
+        m_batchTaken.notify_all();
+    } while (!m_isStopping && m_flushRequestCount == 0
+             && m_batchPushed.wait_until(lock, deadline, [&] {
+                    return !m_queue.empty() || m_isStopping || m_flushRequestCount > 0;
+                }));
+
+    std::move(m_queue.begin(), m_queue.end(), std::back_inserter(batches));
+    m_storingBatchCount += m_queue.size();
+    m_queue.clear();
+    m_batchTaken.notify_all();
+
+    return batches;
+}
+
+// If the combined transaction fails for another reason than a busy database, every batch is
+// retried in its own transaction, so one broken batch does not take the others with it.
+void SymbolStorageWriter::store(const std::vector<Batch> &batches)
+{
+    std::size_t droppedBatchCount = 0;
+
+    if (!tryStore(batches.begin(), batches.end())) {
+        if (batches.size() == 1) {
+            droppedBatchCount = 1;
+        } else {
+            for (auto current = batches.begin(); current != batches.end(); ++current) {
+                if (!tryStore(current, std::next(current)))
+                    ++droppedBatchCount;
+            }
+        }
+    }
+
+    if (droppedBatchCount > 0) {
+        std::cerr << "Dropped " << droppedBatchCount << " of " << batches.size()
+                  << " symbol batches.\n";
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_droppedBatchCount += droppedBatchCount;
+    }
+}
+
+bool SymbolStorageWriter::tryStore(std::vector<Batch>::const_iterator begin,
+                                   std::vector<Batch>::const_iterator end)
+{
+    std::chrono::milliseconds busyTimeout{1};
+    const std::chrono::milliseconds maximumBusyTimeout{128};
+
+    while (true) {
+        try {
+            Sqlite::ImmediateTransaction transaction{m_transactionInterface};
+
+            for (auto current = begin; current != end; ++current) {
+                m_buildDependenciesStorage.insertOrUpdateIndexingTimeStampsWithoutTransaction(
+                    current->dependentSources, current->indexingTimeStamp);
+                m_symbolStorage.addSymbolsAndSourceLocations(current->symbols,
+                                                             current->sourceLocations);
+            }
+
+            transaction.commit();
+            return true;
+        } catch (const Sqlite::StatementIsBusy &) {
+            // Another connection holds the write lock, back off and try again.
+            std::this_thread::sleep_for(busyTimeout);
+            busyTimeout = std::min(busyTimeout * 2, maximumBusyTimeout);
+        } catch (const Sqlite::Exception &exception) {
+            exception.printWarning();
+            return false;
+        }
+    }
+}
+
+} // namespace ClangBackEnd
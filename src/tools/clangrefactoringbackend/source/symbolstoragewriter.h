@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#pragma once
+
+#include "builddependenciesstorageinterface.h"
+#include "sourcelocationentry.h"
+#include "symbolentry.h"
+#include "symbolstorageinterface.h"
+
+#include <filepathid.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Sqlite {
+class TransactionInterface;
+}
+
+namespace ClangBackEnd {
+
+// The indexer workers hand their results to one writer thread, which stores everything
+// that arrives within a commit interval in a single transaction. The workers do not wait
+// for the database lock and the commit cost is shared by many translation units. The
+// queue is bounded, so workers are slowed down if the writer cannot keep up. A batch that
+// cannot be stored is dropped without its indexing time stamps, so its sources are indexed
+// again on the next update.
+class SymbolStorageWriter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Batch
+    {
+    public:
+        SymbolEntries symbols;
+        SourceLocationEntries sourceLocations;
+        FilePathIds dependentSources;
+        long long indexingTimeStamp = 0;
+    };
+
+    SymbolStorageWriter(SymbolStorageInterface &symbolStorage,
+                        BuildDependenciesStorageInterface &buildDependenciesStorage,
+                        Sqlite::TransactionInterface &transactionInterface,
+                        std::size_t maximumQueuedBatches = 64,
+                        std::chrono::milliseconds commitInterval = std::chrono::milliseconds{500});
+    ~SymbolStorageWriter();
+
+    SymbolStorageWriter(const SymbolStorageWriter &) = delete;
+    SymbolStorageWriter &operator=(const SymbolStorageWriter &) = delete;
+
+    // Blocks while the queue is full.
+    void push(Batch &&batch);
+
+    // Stores the queued batches without waiting for the commit interval and blocks until
+    // they are committed. Returns false if a batch was dropped since the last flush.
+    bool flush();
+
+private:
+    void run();
+    std::vector<Batch> takeBatches(Clock::time_point deadline);
+    void store(const std::vector<Batch> &batches);
+    bool tryStore(std::vector<Batch>::const_iterator begin,
+                  std::vector<Batch>::const_iterator end);
+
+private:
+    SymbolStorageInterface &m_symbolStorage;
+    BuildDependenciesStorageInterface &m_buildDependenciesStorage;
+    Sqlite::TransactionInterface &m_transactionInterface;
+    const std::size_t m_maximumQueuedBatches;
+    const std::chrono::milliseconds m_commitInterval;
+
+    std::mutex m_mutex;
+    std::condition_variable m_batchPushed;
+    std::condition_variable m_batchTaken;
+    std::condition_variable m_batchesStored;
+    std::deque<Batch> m_queue;
+    std::size_t m_storingBatchCount = 0;
+    std::size_t m_droppedBatchCount = 0;
+    std::size_t m_flushRequestCount = 0;
+    bool m_isStopping = false;
+
+    std::thread m_thread;
+};
+
+} // namespace ClangBackEnd
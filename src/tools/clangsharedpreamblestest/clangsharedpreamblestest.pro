@@ -0,0 +1,21 @@
+QTC_LIB_DEPENDS += \
+    sqlite \
+    clangsupport
+
+include(../../qtcreatortool.pri)
+include(../../shared/clang/clang_installation.pri)
+include(../clangbackend/source/clangbackendclangipc-source.pri)
+
+requires(!isEmpty(LLVM_VERSION))
+
+QT += core network testlib
+QT -= gui
+
+LIBS += $$LIBCLANG_LIBS
+INCLUDEPATH += $$LLVM_INCLUDEPATH
+
+TARGET    = clangsharedpreamblestest
+
+CONFIG    += warn_on
+
+SOURCES   += main.cpp
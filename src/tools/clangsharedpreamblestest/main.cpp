@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+#include <clangsharedpreambles.h>
+#include <unsavedfiles.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace ClangBackEnd;
+
+class SharedPreamblesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void argumentsWithPreamble_data();
+    void argumentsWithPreamble();
+
+    void fewIncludesAreNotShared();
+    void guardedIncludesAreShared();
+    void unguardedIncludeIsNotShared();
+    void unsavedChangeOutdatesPreamble();
+
+private:
+    Utf8String writeFile(const QString &fileName, const QByteArray &content);
+    Utf8String writeHeaders(bool guarded);
+    Utf8StringVector compilationArguments() const;
+    Utf8String requestPreamble(const Utf8String &filePath, bool *buildNeeded);
+
+    QTemporaryDir m_directory;
+};
+
+Utf8String SharedPreamblesTest::writeFile(const QString &fileName, const QByteArray &content)
+{
+    const QString filePath = m_directory.filePath(fileName);
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content) != content.size())
+        return Utf8String();
+    return Utf8String::fromString(filePath);
+}
+
+// Writes a.h, b.h and c.h, where c.h might lack an include guard, and returns a source
+// file including them.
+Utf8String SharedPreamblesTest::writeHeaders(bool guarded)
+{
+    const QString directory = guarded ? QString("guarded") : QString("unguarded");
+    QDir(m_directory.path()).mkpath(directory);
+    writeFile(directory + "/a.h", "#pragma once\nstruct A {};\n");
+    writeFile(directory + "/b.h", "#ifndef B_H\n#define B_H\nstruct B {};\n#endif\n");
+    writeFile(directory + "/c.h", guarded ? "#pragma once\nstruct C {};\n" : "struct C;\n");
+    return writeFile(directory + "/source.cpp",
+                     "#include \"a.h\"\n#include \"b.h\"\n#include \"c.h\"\n"
+                     "int main() { A a; B b; return 0; }\n");
+}
+
+Utf8StringVector SharedPreamblesTest::compilationArguments() const
+{
+    return Utf8StringVector({Utf8StringLiteral("-x"), Utf8StringLiteral("c++"),
+                             Utf8StringLiteral("-std=c++11")});
+}
+
+// The first document with a prefix only registers it, the second one requests the build.
+Utf8String SharedPreamblesTest::requestPreamble(const Utf8String &filePath, bool *buildNeeded)
+{
+    SharedPreambles &sharedPreambles = SharedPreambles::instance();
+    sharedPreambles.preambleFor(filePath, compilationArguments(), UnsavedFiles(), *buildNeeded);
+    return sharedPreambles.preambleFor(filePath, compilationArguments(), UnsavedFiles(),
+                                       *buildNeeded);
+}
+
+void SharedPreamblesTest::argumentsWithPreamble_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("no includes")
+            << QStringList({"-x", "c++", "-DFOO"})
+            << QStringList({"-x", "c++", "-DFOO", "-include-pch", "/tmp/shared.pch"});
+    QTest::newRow("separate include argument")
+            << QStringList({"-x", "c++", "-include", "prefix.h", "-DFOO"})
+            << QStringList({"-x", "c++", "-DFOO", "-include-pch", "/tmp/shared.pch"});
+    QTest::newRow("joined include argument")
+            << QStringList({"-includeprefix.h", "-x", "c++"})
+            << QStringList({"-x", "c++", "-include-pch", "/tmp/shared.pch"});
+    QTest::newRow("other include options")
+            << QStringList({"-include-dir", "-iquote", "dir"})
+            << QStringList({"-include-dir", "-iquote", "dir", "-include-pch", "/tmp/shared.pch"});
+}
+
+void SharedPreamblesTest::argumentsWithPreamble()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(QStringList, expected);
+
+    const Utf8StringVector result = SharedPreambles::argumentsWithPreamble(
+                Utf8StringVector(arguments), Utf8StringLiteral("/tmp/shared.pch"));
+
+    QCOMPARE(result, Utf8StringVector(expected));
+}
+
+void SharedPreamblesTest::fewIncludesAreNotShared()
+{
+    const Utf8String filePath = writeFile("few.cpp",
+                                          "#include <vector>\n#include <string>\nint x;\n");
+    bool buildNeeded = false;
+
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(requestPreamble(filePath, &buildNeeded).isEmpty());
+        QVERIFY(!buildNeeded);
+    }
+}
+
+void SharedPreamblesTest::guardedIncludesAreShared()
+{
+    const Utf8String filePath = writeHeaders(true);
+    SharedPreambles &sharedPreambles = SharedPreambles::instance();
+    bool buildNeeded = false;
+
+    QVERIFY(requestPreamble(filePath, &buildNeeded).isEmpty());
+    QVERIFY(buildNeeded);
+    QVERIFY(sharedPreambles.build(filePath, compilationArguments(), UnsavedFiles()));
+
+    const Utf8String preamblePath = sharedPreambles.preambleFor(filePath,
+                                                                compilationArguments(),
+                                                                UnsavedFiles(),
+                                                                buildNeeded);
+    QVERIFY(!preamblePath.isEmpty());
+    QVERIFY(!buildNeeded);
+    QVERIFY(QFile::exists(preamblePath.toString()));
+    QVERIFY(sharedPreambles.dependencies(preamblePath).size() >= 3);
+}
+
+// The document includes the headers of the prefix again, so an unguarded one would be
+// defined twice.
+void SharedPreamblesTest::unguardedIncludeIsNotShared()
+{
+    const Utf8String filePath = writeHeaders(false);
+    SharedPreambles &sharedPreambles = SharedPreambles::instance();
+    bool buildNeeded = false;
+
+    QVERIFY(requestPreamble(filePath, &buildNeeded).isEmpty());
+    QVERIFY(buildNeeded);
+    QVERIFY(!sharedPreambles.build(filePath, compilationArguments(), UnsavedFiles()));
+
+    QVERIFY(sharedPreambles.preambleFor(filePath, compilationArguments(), UnsavedFiles(),
+                                        buildNeeded).isEmpty());
+    QVERIFY(!buildNeeded);
+
+    // Adding the guard lets it be tried again.
+    const Utf8String headerPath = writeFile("unguarded/c.h", "#pragma once\nstruct C;\n");
+    sharedPreambles.invalidate(headerPath);
+    QVERIFY(sharedPreambles.preambleFor(filePath, compilationArguments(), UnsavedFiles(),
+                                        buildNeeded).isEmpty());
+    QVERIFY(buildNeeded);
+    QVERIFY(sharedPreambles.build(filePath, compilationArguments(), UnsavedFiles()));
+}
+
+void SharedPreamblesTest::unsavedChangeOutdatesPreamble()
+{
+    const Utf8String filePath = writeHeaders(true);
+    SharedPreambles &sharedPreambles = SharedPreambles::instance();
+    bool buildNeeded = false;
+
+    Utf8String preamblePath = sharedPreambles.preambleFor(filePath, compilationArguments(),
+                                                          UnsavedFiles(), buildNeeded);
+    if (preamblePath.isEmpty()) {
+        QVERIFY(requestPreamble(filePath, &buildNeeded).isEmpty());
+        QVERIFY(sharedPreambles.build(filePath, compilationArguments(), UnsavedFiles()));
+        preamblePath = sharedPreambles.preambleFor(filePath, compilationArguments(),
+                                                   UnsavedFiles(), buildNeeded);
+    }
+    QVERIFY(!preamblePath.isEmpty());
+
+    const Utf8String headerPath = Utf8String::fromString(m_directory.filePath("guarded/a.h"));
+    UnsavedFiles sameContent;
+    sameContent.createOrUpdate({FileContainer(headerPath,
+                                              Utf8StringLiteral("#pragma once\nstruct A {};\n"),
+                                              true)});
+    QVERIFY(sharedPreambles.isUpToDate(preamblePath, sameContent));
+
+    UnsavedFiles changedContent;
+    changedContent.createOrUpdate({FileContainer(headerPath,
+                                                 Utf8StringLiteral("#pragma once\nstruct A2 {};\n"),
+                                                 true)});
+    QVERIFY(!sharedPreambles.isUpToDate(preamblePath, changedContent));
+}
+
+QTEST_GUILESS_MAIN(SharedPreamblesTest)
+
+#include "main.moc"
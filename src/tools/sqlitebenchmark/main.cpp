@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <sqlitebatchwritestatement.h>
+#include <sqlitedatabase.h>
+#include <sqlitetransaction.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <tuple>
+#include <vector>
+
+// Compares writing symbol rows one by one with Sqlite::WriteStatement against writing them
+// in batches with Sqlite::BatchWriteStatement, like SymbolStorage fills its temporary tables.
+
+namespace {
+
+struct SymbolRow
+{
+    long long symbolId;
+    Utils::SmallString usr;
+    Utils::SmallString name;
+    int kind;
+};
+
+std::vector<SymbolRow> createRows(int count)
+{
+    std::vector<SymbolRow> rows;
+    rows.reserve(std::size_t(count));
+    for (int i = 0; i < count; ++i) {
+        const Utils::SmallString number = Utils::SmallString::number(i);
+        rows.push_back({i, "c:@N@Namespace@S@Class" + number + "@F@function#", "function" + number,
+                        i % 8});
+    }
+    return rows;
+}
+
+void createTable(Sqlite::Database &database)
+{
+    database.execute("DROP TABLE IF EXISTS symbols");
+    database.execute("CREATE TABLE symbols(symbolId INTEGER, usr TEXT, name TEXT, kind INTEGER)");
+}
+
+const char insertStatement[] = "INSERT INTO symbols(symbolId, usr, name, kind) VALUES(?,?,?,?)";
+
+qint64 writeRowByRow(Sqlite::Database &database, const std::vector<SymbolRow> &rows)
+{
+    createTable(database);
+    Sqlite::WriteStatement statement(insertStatement, database);
+
+    QElapsedTimer timer;
+    timer.start();
+    Sqlite::ImmediateTransaction transaction{database};
+    for (const SymbolRow &row : rows)
+        statement.write(row.symbolId, row.usr, row.name, row.kind);
+    transaction.commit();
+    return timer.elapsed();
+}
+
+qint64 writeInBatches(Sqlite::Database &database, const std::vector<SymbolRow> &rows)
+{
+    createTable(database);
+    Sqlite::BatchWriteStatement statement(insertStatement, database);
+
+    QElapsedTimer timer;
+    timer.start();
+    Sqlite::ImmediateTransaction transaction{database};
+    statement.write(rows, [](const SymbolRow &row) {
+        return std::make_tuple(row.symbolId, Utils::SmallStringView(row.usr),
+                               Utils::SmallStringView(row.name), row.kind);
+    });
+    transaction.commit();
+    return timer.elapsed();
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const QStringList arguments = app.arguments();
+    const int rowCount = arguments.size() > 1 ? arguments.at(1).toInt() : 1000000;
+    if (rowCount <= 0) {
+        out << "Usage: " << arguments.first() << " [row count]" << endl;
+        return 1;
+    }
+
+    const std::vector<SymbolRow> rows = createRows(rowCount);
+    Sqlite::Database database{":memory:", Sqlite::JournalMode::Memory};
+
+    const auto report = [&](const char *name, qint64 elapsed) {
+        out << name << ": " << elapsed << " ms, "
+            << (elapsed > 0 ? qint64(rowCount) * 1000 / elapsed : 0) << " rows/s" << endl;
+    };
+    report("WriteStatement", writeRowByRow(database, rows));
+    report("BatchWriteStatement", writeInBatches(database, rows));
+
+    return 0;
+}
@@ -0,0 +1,11 @@
+QT        -= gui
+
+QTC_LIB_DEPENDS += sqlite
+
+include(../../qtcreatortool.pri)
+
+TARGET    = sqlitebenchmark
+
+CONFIG    += warn_on
+
+SOURCES   += main.cpp
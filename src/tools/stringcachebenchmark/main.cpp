@@ -0,0 +1,198 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <stringcache.h>
+#include <stringcachelookup.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Measures StringCache hits from 1, 8 and 32 threads while another thread keeps adding new
+// strings, like FilePathCache::filePathId during indexing. Every hit is checked against the
+// expected id and string, and the lookup must free retired entries once readers are gone.
+
+namespace {
+
+using namespace ClangBackEnd;
+
+using Cache = StringCache<Utils::PathString,
+                          Utils::SmallStringView,
+                          int,
+                          SharedMutex,
+                          decltype(&Utils::reverseCompare),
+                          Utils::reverseCompare>;
+using Lookup = StringCacheLookup<Utils::PathString,
+                                 Utils::SmallStringView,
+                                 decltype(&Utils::reverseCompare),
+                                 Utils::reverseCompare>;
+
+std::vector<Utils::PathString> createPaths(int count, Utils::SmallStringView prefix)
+{
+    std::vector<Utils::PathString> paths;
+    paths.reserve(std::size_t(count));
+
+    for (int index = 0; index < count; ++index) {
+        Utils::PathString path{prefix};
+        path += "/include/module";
+        path += Utils::SmallString::number(index % 97);
+        path += "/header";
+        path += Utils::SmallString::number(index);
+        path += ".h";
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+class Result
+{
+public:
+    qint64 elapsed = 0;
+    long long failures = 0;
+};
+
+Result run(int threadCount, int lookupsPerThread, const std::vector<Utils::PathString> &paths)
+{
+    Cache cache;
+    std::atomic<int> nextId{0};
+    auto storageFunction = [&](Utils::SmallStringView) { return nextId++; };
+
+    const std::vector<int> ids = cache.stringIds(paths, storageFunction);
+
+    std::atomic<bool> isReading{true};
+    std::atomic<long long> failures{0};
+
+    std::thread writer([&] {
+        const std::vector<Utils::PathString> newPaths = createPaths(int(paths.size()), "/opt");
+        for (const Utils::PathString &path : newPaths) {
+            if (!isReading)
+                return;
+            cache.stringId(path, storageFunction);
+        }
+    });
+
+    auto read = [&](unsigned seed) {
+        std::minstd_rand random{seed};
+        std::uniform_int_distribution<std::size_t> distribution{0, paths.size() - 1};
+        long long localFailures = 0;
+
+        for (int count = 0; count < lookupsPerThread; ++count) {
+            const std::size_t index = distribution(random);
+            const int id = cache.stringId(paths[index]);
+            if (id != ids[index] || cache.string(id) != paths[index])
+                ++localFailures;
+        }
+
+        failures += localFailures;
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> readers;
+    readers.reserve(std::size_t(threadCount));
+    for (int index = 0; index < threadCount; ++index)
+        readers.emplace_back(read, unsigned(index + 1));
+    for (std::thread &reader : readers)
+        reader.join();
+
+    Result result;
+    result.elapsed = timer.elapsed();
+
+    isReading = false;
+    writer.join();
+
+    result.failures = failures;
+
+    return result;
+}
+
+bool retiredEntriesAreFreed(const std::vector<Utils::PathString> &paths)
+{
+    Lookup lookup;
+
+    for (int round = 0; round < 4; ++round) {
+        int id = 0;
+        for (const Utils::PathString &path : paths)
+            lookup.insert(path, id++);
+
+        id = 0;
+        for (const Utils::PathString &path : paths) {
+            if (lookup.findId(path) != id || lookup.findString<Utils::PathString>(id) != path)
+                return false;
+            ++id;
+        }
+
+        lookup.clear();
+        if (lookup.retiredCount() != 0)
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const QStringList arguments = app.arguments();
+    const int lookupCount = arguments.size() > 1 ? arguments.at(1).toInt() : 1000000;
+    if (lookupCount <= 0) {
+        out << "Usage: " << arguments.first() << " [lookups per thread]" << endl;
+        return 1;
+    }
+
+    const std::vector<Utils::PathString> paths = createPaths(20000, "/usr");
+    bool passed = true;
+
+    for (int threadCount : {1, 8, 32}) {
+        const Result result = run(threadCount, lookupCount, paths);
+        const qint64 lookups = qint64(threadCount) * lookupCount;
+
+        out << threadCount << " threads: " << result.elapsed << " ms, "
+            << (result.elapsed > 0 ? lookups * 1000 / result.elapsed : 0) << " lookups/s";
+        if (result.failures > 0) {
+            out << ", " << result.failures << " wrong results";
+            passed = false;
+        }
+        out << endl;
+    }
+
+    if (!retiredEntriesAreFreed(paths)) {
+        out << "retired lookup entries were not freed" << endl;
+        passed = false;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+QT        -= gui
+
+QTC_LIB_DEPENDS += \
+    sqlite \
+    clangsupport
+
+include(../../qtcreatortool.pri)
+
+TARGET    = stringcachebenchmark
+
+CONFIG    += warn_on
+
+SOURCES   += main.cpp
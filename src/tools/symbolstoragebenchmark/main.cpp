@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qt Creator.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+****************************************************************************/
+
+#include <builddependenciesstorage.h>
+#include <progresscounter.h>
+#include <refactoringdatabaseinitializer.h>
+#include <symbolstorage.h>
+#include <symbolstoragewriter.h>
+
+#include <sqlitedatabase.h>
+#include <sqlitereadstatement.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Measures how many translation units per second the symbol indexer can store when the
+// collected symbols are handed to the SymbolStorageWriter by one to all cores. Parsing is
+// simulated by keeping the worker busy for a fixed time per translation unit.
+
+namespace {
+
+using namespace ClangBackEnd;
+
+class Settings
+{
+public:
+    int translationUnitCount = 2000;
+    int symbolsPerTranslationUnit = 200;
+    std::chrono::microseconds parseTime{2000};
+};
+
+void simulateParsing(std::chrono::microseconds parseTime)
+{
+    const auto end = std::chrono::steady_clock::now() + parseTime;
+    volatile unsigned value = 0;
+    while (std::chrono::steady_clock::now() < end)
+        value = value * 31 + 7;
+}
+
+SymbolStorageWriter::Batch createBatch(int translationUnit, int symbolCount)
+{
+    SymbolStorageWriter::Batch batch;
+    const int sourceId = translationUnit + 1;
+    Utils::PathString prefix{"c:@N@Unit"};
+    prefix += Utils::SmallString::number(translationUnit);
+    prefix += "@F@function";
+
+    for (int index = 0; index < symbolCount; ++index) {
+        const SymbolIndex symbolId = SymbolIndex(translationUnit) * symbolCount + index + 1;
+        const Utils::SmallString number = Utils::SmallString::number(index);
+        Utils::PathString usr = prefix;
+        usr += number;
+        usr += "#";
+        batch.symbols.emplace(symbolId,
+                              SymbolEntry{std::move(usr), "function" + number, SymbolKind::Function});
+        batch.sourceLocations.emplace_back(symbolId,
+                                           FilePathId{sourceId},
+                                           Utils::LineColumn{index + 1, 1},
+                                           SourceLocationKind::Definition);
+    }
+
+    batch.dependentSources.emplace_back(sourceId);
+    batch.indexingTimeStamp = 1;
+
+    return batch;
+}
+
+class Result
+{
+public:
+    qint64 elapsed = 0;
+    long long symbolCount = 0;
+    long long locationCount = 0;
+};
+
+Result run(const QString &databaseFilePath, const Settings &settings, int threadCount,
+           QTextStream &out)
+{
+    Sqlite::Database database{Utils::PathString{databaseFilePath}, Sqlite::JournalMode::Wal};
+    RefactoringDatabaseInitializer<Sqlite::Database> initializer{database};
+    SymbolStorage<Sqlite::Database> symbolStorage{database};
+    BuildDependenciesStorage<Sqlite::Database> buildDependenciesStorage{database};
+    SymbolStorageWriter writer{symbolStorage, buildDependenciesStorage, database};
+
+    int reportedPercent = 0;
+    ProgressCounter progressCounter{[&](int progress, int total) {
+        const int percent = total > 0 ? progress * 100 / total : 100;
+        if (percent >= reportedPercent + 25 || progress == total) {
+            reportedPercent = percent;
+            out << "  progress " << progress << "/" << total << endl;
+        }
+    }};
+    progressCounter.addTotal(settings.translationUnitCount);
+
+    std::atomic<int> nextTranslationUnit{0};
+    auto work = [&] {
+        while (true) {
+            const int translationUnit = nextTranslationUnit++;
+            if (translationUnit >= settings.translationUnitCount)
+                return;
+
+            simulateParsing(settings.parseTime);
+            writer.push(createBatch(translationUnit, settings.symbolsPerTranslationUnit));
+            progressCounter.addProgress(1);
+        }
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+    threads.reserve(std::size_t(threadCount));
+    for (int index = 0; index < threadCount; ++index)
+        threads.emplace_back(work);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    const bool nothingDropped = writer.flush();
+
+    Result result;
+    result.elapsed = timer.elapsed();
+    result.symbolCount = Sqlite::ReadStatement<1>::toValue<long long>("SELECT count(*) FROM symbols",
+                                                                      database);
+    result.locationCount = Sqlite::ReadStatement<1>::toValue<long long>(
+        "SELECT count(*) FROM locations", database);
+
+    if (!nothingDropped)
+        out << "  some batches were dropped" << endl;
+
+    return result;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    Settings settings;
+    const QStringList arguments = app.arguments();
+    if (arguments.size() > 1)
+        settings.translationUnitCount = arguments.at(1).toInt();
+    if (arguments.size() > 2)
+        settings.parseTime = std::chrono::microseconds{arguments.at(2).toInt()};
+    if (settings.translationUnitCount <= 0 || settings.parseTime.count() < 0) {
+        out << "Usage: " << arguments.first()
+            << " [translation unit count] [parse time per translation unit in us]" << endl;
+        return 1;
+    }
+
+    QTemporaryDir temporaryDirectory;
+    const qint64 expectedSymbolCount = qint64(settings.translationUnitCount)
+                                          * settings.symbolsPerTranslationUnit;
+    const int coreCount = int(std::max(1u, std::thread::hardware_concurrency()));
+    bool allStored = true;
+
+    for (int threadCount = 1;; threadCount = std::min(threadCount * 2, coreCount)) {
+        const QString databaseFilePath = temporaryDirectory.filePath(
+            QString("symbols%1.db").arg(threadCount));
+        out << threadCount << " threads:" << endl;
+
+        const Result result = run(databaseFilePath, settings, threadCount, out);
+
+        out << "  " << result.elapsed << " ms, "
+            << (result.elapsed > 0 ? qint64(settings.translationUnitCount) * 1000 / result.elapsed
+                                   : 0)
+            << " TUs/s" << endl;
+
+        if (result.symbolCount != expectedSymbolCount
+            || result.locationCount != expectedSymbolCount) {
+            out << "  expected " << expectedSymbolCount << " symbols and locations but stored "
+                << result.symbolCount << " symbols and " << result.locationCount << " locations"
+                << endl;
+            allStored = false;
+        }
+
+        if (threadCount == coreCount)
+            break;
+    }
+
+    return allStored ? 0 : 1;
+}
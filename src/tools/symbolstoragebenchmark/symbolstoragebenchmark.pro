@@ -0,0 +1,19 @@
+QT        -= gui
+
+QTC_LIB_DEPENDS += \
+    sqlite \
+    clangsupport
+
+include(../../qtcreatortool.pri)
+
+TARGET    = symbolstoragebenchmark
+
+CONFIG    += warn_on
+
+INCLUDEPATH += \
+    ../clangrefactoringbackend/source \
+    ../clangpchmanagerbackend/source
+
+SOURCES   += \
+    main.cpp \
+    ../clangrefactoringbackend/source/symbolstoragewriter.cpp
@@ -41,6 +41,21 @@ isEmpty(BUILD_CPLUSPLUS_TOOLS):BUILD_CPLUSPLUS_TOOLS=$$(BUILD_CPLUSPLUS_TOOLS)
         cplusplus-update-frontend
 }
 
+isEmpty(BUILD_CLANG_IPC_BENCHMARK):BUILD_CLANG_IPC_BENCHMARK=$$(BUILD_CLANG_IPC_BENCHMARK)
+!isEmpty(BUILD_CLANG_IPC_BENCHMARK): SUBDIRS += clangipcbenchmark
+
+isEmpty(BUILD_CLANG_SHARED_PREAMBLES_TEST):BUILD_CLANG_SHARED_PREAMBLES_TEST=$$(BUILD_CLANG_SHARED_PREAMBLES_TEST)
+!isEmpty(BUILD_CLANG_SHARED_PREAMBLES_TEST): SUBDIRS += clangsharedpreamblestest
+
+isEmpty(BUILD_SQLITE_BENCHMARK):BUILD_SQLITE_BENCHMARK=$$(BUILD_SQLITE_BENCHMARK)
+!isEmpty(BUILD_SQLITE_BENCHMARK): SUBDIRS += sqlitebenchmark
+
+isEmpty(BUILD_STRING_CACHE_BENCHMARK):BUILD_STRING_CACHE_BENCHMARK=$$(BUILD_STRING_CACHE_BENCHMARK)
+!isEmpty(BUILD_STRING_CACHE_BENCHMARK): SUBDIRS += stringcachebenchmark
+
+isEmpty(BUILD_SYMBOL_STORAGE_BENCHMARK):BUILD_SYMBOL_STORAGE_BENCHMARK=$$(BUILD_SYMBOL_STORAGE_BENCHMARK)
+!isEmpty(BUILD_SYMBOL_STORAGE_BENCHMARK): SUBDIRS += symbolstoragebenchmark
+
 !isEmpty(BREAKPAD_SOURCE_DIR) {
     SUBDIRS += qtcrashhandler
 } else {